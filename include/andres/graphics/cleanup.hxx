@@ -0,0 +1,817 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_CLEANUP_HXX
+#define ANDRES_GRAPHICS_CLEANUP_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "graphics.hxx"
+#include "parallel.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Options for cleanup().
+///
+/// \param weldPoints Weld points with the same property that are closer
+///     than or as close as weldDistance.
+/// \param weldDistance Euclidean distance. 0 welds only points with equal
+///     coordinates.
+/// \param removeDegenerate Remove lines and triangles that have fewer
+///     distinct points than corners (after welding).
+/// \param removeDuplicates Remove all but the first of lines and triangles
+///     with the same property and the same set of points (after welding),
+///     irrespective of their order.
+/// \param removeIsolatedPoints Remove visible points that are used by no
+///     line or triangle. Invisible points that are used by no line or
+///     triangle are always removed.
+/// \param removeUnusedProperties Remove properties used by no primitive,
+///     except the default properties with index 0.
+/// \param reorderPoints Renumber points in the order in which they are
+///     first used by the triangles and then the lines, such that points
+///     used by consecutive primitives are close in memory. Otherwise, the
+///     order of points is kept.
+///
+struct CleanupOptions {
+    CleanupOptions(
+        const bool weldPoints = true,
+        const double weldDistance = 0,
+        const bool removeDegenerate = true,
+        const bool removeDuplicates = true,
+        const bool removeIsolatedPoints = false,
+        const bool removeUnusedProperties = true,
+        const bool reorderPoints = false
+    )
+    :   weldPoints_(weldPoints),
+        weldDistance_(weldDistance),
+        removeDegenerate_(removeDegenerate),
+        removeDuplicates_(removeDuplicates),
+        removeIsolatedPoints_(removeIsolatedPoints),
+        removeUnusedProperties_(removeUnusedProperties),
+        reorderPoints_(reorderPoints)
+    {}
+
+    bool weldPoints_;
+    double weldDistance_;
+    bool removeDegenerate_;
+    bool removeDuplicates_;
+    bool removeIsolatedPoints_;
+    bool removeUnusedProperties_;
+    bool reorderPoints_;
+};
+
+/// Numbers of elements of one kind before and after cleanup() and the
+/// reasons for their removal.
+///
+struct CleanupCounts {
+    CleanupCounts()
+        : before_(0), after_(0), welded_(0), degenerate_(0), duplicate_(0), unused_(0)
+        {}
+    std::size_t removed() const
+        { return before_ - after_; }
+
+    std::size_t before_;
+    std::size_t after_;
+    std::size_t welded_; // points only
+    std::size_t degenerate_; // lines and triangles only
+    std::size_t duplicate_; // lines and triangles only
+    std::size_t unused_; // points and properties only
+};
+
+inline std::ostream&
+operator<<(
+    std::ostream& out,
+    const CleanupCounts& counts
+) {
+    out << counts.before_ << " -> " << counts.after_;
+    if(counts.welded_ != 0) {
+        out << ", " << counts.welded_ << " welded";
+    }
+    if(counts.degenerate_ != 0) {
+        out << ", " << counts.degenerate_ << " degenerate";
+    }
+    if(counts.duplicate_ != 0) {
+        out << ", " << counts.duplicate_ << " duplicate";
+    }
+    if(counts.unused_ != 0) {
+        out << ", " << counts.unused_ << " unused";
+    }
+    return out;
+}
+
+/// Result of cleanup(): the new index of each element, or removed() for
+/// removed elements, and the numbers of elements and bytes saved.
+///
+/// Welded points are mapped to the new index of the point they were
+/// welded to.
+///
+template<class S = std::size_t>
+struct CleanupResult {
+    typedef S size_type;
+
+    static size_type removed()
+        { return std::numeric_limits<size_type>::max(); }
+    std::size_t bytesSaved() const
+        { return bytesBefore_ - bytesAfter_; }
+
+    std::vector<size_type> pointMap_;
+    std::vector<size_type> lineMap_;
+    std::vector<size_type> triangleMap_;
+    std::vector<size_type> pointPropertyMap_;
+    std::vector<size_type> linePropertyMap_;
+    std::vector<size_type> trianglePropertyMap_;
+    CleanupCounts points_;
+    CleanupCounts lines_;
+    CleanupCounts triangles_;
+    CleanupCounts pointProperties_;
+    CleanupCounts lineProperties_;
+    CleanupCounts triangleProperties_;
+    std::size_t bytesBefore_;
+    std::size_t bytesAfter_;
+};
+
+namespace detail {
+
+inline std::uint64_t
+mix(
+    const std::uint64_t h,
+    const std::uint64_t value
+) {
+    const std::uint64_t m = (h ^ value) * 0x9e3779b97f4a7c15ull;
+    return m ^ (m >> 32);
+}
+
+inline std::uint64_t
+finalize(
+    std::uint64_t h
+) {
+    // finalizer of splitmix64
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+/// Bits of a coordinate, equal for -0 and +0.
+///
+template<class T>
+inline std::uint64_t
+bits(
+    const T value
+) {
+    const T v = value + T(0); // -0 + 0 is +0
+    std::uint64_t b = 0;
+    std::memcpy(&b, &v, std::min(sizeof(T), sizeof(b)));
+    return b;
+}
+
+/// Elements grouped by their hash values into a power of two of buckets,
+/// in increasing order within each bucket.
+///
+/// The buckets are stored contiguously, such that grouping needs no
+/// memory allocation per element.
+///
+class HashBuckets {
+public:
+    /// Group the elements j in [0, size) for which include(j) is true by
+    /// hashes[j].
+    template<class INCLUDE>
+    void build(const std::vector<std::uint64_t>& hashes, INCLUDE include)
+        {
+            std::size_t numberOfBuckets = 1;
+            while(numberOfBuckets < hashes.size()) {
+                numberOfBuckets *= 2;
+            }
+            mask_ = numberOfBuckets - 1;
+            offsets_.assign(numberOfBuckets + 1, 0);
+            for(std::size_t j = 0; j < hashes.size(); ++j) {
+                if(include(j)) {
+                    ++offsets_[(hashes[j] & mask_) + 1];
+                }
+            }
+            for(std::size_t k = 0; k < numberOfBuckets; ++k) {
+                offsets_[k + 1] += offsets_[k];
+            }
+            elements_.resize(offsets_[numberOfBuckets]);
+            std::vector<std::size_t> positions(offsets_.begin(), offsets_.end() - 1);
+            for(std::size_t j = 0; j < hashes.size(); ++j) {
+                if(include(j)) {
+                    elements_[positions[hashes[j] & mask_]++] = j;
+                }
+            }
+        }
+    const std::size_t* begin(const std::uint64_t hash) const
+        { return elements_.data() + offsets_[hash & mask_]; }
+    const std::size_t* end(const std::uint64_t hash) const
+        { return elements_.data() + offsets_[(hash & mask_) + 1]; }
+
+private:
+    std::vector<std::size_t> offsets_;
+    std::vector<std::size_t> elements_;
+    std::size_t mask_;
+};
+
+/// For each element j in [0, size), the smallest index k <= j such that
+/// equal(k, j), or j if there is no such k.
+///
+/// Equal elements need to have equal hashes. Hashes are computed and
+/// buckets are searched in parallel.
+///
+template<class S, class HASH, class EQUAL>
+inline void
+firstOccurrences(
+    const std::size_t size,
+    HASH hash,
+    EQUAL equal,
+    const ParallelOptions& parallelOptions,
+    std::vector<S>& first
+) {
+    std::vector<std::uint64_t> hashes(size);
+    parallelFor(size, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                hashes[j] = hash(j);
+            }
+        }
+    );
+    HashBuckets buckets;
+    buckets.build(hashes, [](const std::size_t) { return true; });
+    first.resize(size);
+    parallelFor(size, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                for(const std::size_t* k = buckets.begin(hashes[j]); ; ++k) {
+                    assert(k != buckets.end(hashes[j]));
+                    if(*k == j || equal(*k, j)) {
+                        first[j] = static_cast<S>(*k);
+                        break;
+                    }
+                }
+            }
+        }
+    );
+}
+
+/// New indices of the elements j with keep[j] != 0, in increasing order.
+/// Elements with keep[j] == 0 are mapped to removed.
+///
+/// \returns The number of kept elements.
+///
+template<class S>
+inline std::size_t
+compactionMap(
+    const std::vector<unsigned char>& keep,
+    const S removed,
+    const ParallelOptions& parallelOptions,
+    std::vector<S>& map
+) {
+    const std::size_t numberOfBlocks = graphics::numberOfBlocks(keep.size(), parallelOptions);
+    std::vector<std::size_t> offsets(numberOfBlocks + 1, 0);
+    parallelFor(keep.size(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            std::size_t n = 0;
+            for(std::size_t j = begin; j < end; ++j) {
+                n += keep[j] != 0;
+            }
+            offsets[block + 1] = n;
+        }
+    );
+    for(std::size_t block = 0; block < numberOfBlocks; ++block) {
+        offsets[block + 1] += offsets[block];
+    }
+    map.resize(keep.size());
+    parallelFor(keep.size(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            S n = static_cast<S>(offsets[block]);
+            for(std::size_t j = begin; j < end; ++j) {
+                map[j] = keep[j] != 0 ? n++ : removed;
+            }
+        }
+    );
+    return offsets[numberOfBlocks];
+}
+
+/// Representative of each point, i.e. the point of smallest index that
+/// it is welded to.
+///
+/// Points with the same property are welded if their distance is at most
+/// the given distance. Welding is transitive, i.e. a chain of points in
+/// which consecutive points are close enough is welded to one point.
+/// Points with non-finite coordinates are welded only to points with
+/// equal coordinates.
+///
+/// Points with equal coordinates are welded first, by hashing the
+/// coordinates. For a positive distance, the remaining points are then
+/// hashed by the cells of a grid with four times the distance as spacing.
+/// Each point is compared to the points in its cell and, only if it is
+/// close to the boundary of the cell, to those in up to 7 neighboring
+/// cells, i.e. to those in fewer than 3.4 cells on average. Points are
+/// compared in parallel, and close pairs are joined by union-find.
+///
+template<class T, class S>
+inline void
+weldPoints(
+    const std::vector<Point<T, S> >& points,
+    const double distance,
+    const ParallelOptions& parallelOptions,
+    std::vector<S>& representatives
+) {
+    typedef Point<T, S> PointType;
+
+    // equal coordinates
+    firstOccurrences(points.size(),
+        [&](const std::size_t j) {
+            const PointType& p = points[j];
+            std::uint64_t h = mix(0, static_cast<std::uint64_t>(p.propertyIndex()));
+            for(std::size_t k = 0; k < 3; ++k) {
+                h = mix(h, bits(p[k]));
+            }
+            return finalize(h);
+        },
+        [&](const std::size_t j, const std::size_t k) {
+            const PointType& p = points[j];
+            const PointType& q = points[k];
+            return p[0] == q[0] && p[1] == q[1] && p[2] == q[2] && p.propertyIndex() == q.propertyIndex();
+        },
+        parallelOptions,
+        representatives
+    );
+    if(!(distance > 0)) {
+        return;
+    }
+
+    // cells of the points that are not welded yet
+    const double cellSize = 4 * distance;
+    // the grid is shifted by an irrational fraction of a cell, such that
+    // points on a regular grid, e.g. in the plane z = 0, do not lie on the
+    // boundaries of cells
+    const double origin = -0.3183098861837907 * cellSize;
+    const double maximumCell = 4611686018427387904.0; // 2^62
+    std::vector<std::int64_t> cells(3 * points.size());
+    std::vector<unsigned char> candidates(points.size());
+    std::vector<std::uint64_t> hashes(points.size());
+    parallelFor(points.size(), parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                const PointType& p = points[j];
+                candidates[j] = representatives[j] == j
+                    && std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2]);
+                if(candidates[j]) {
+                    std::uint64_t h = mix(0, static_cast<std::uint64_t>(p.propertyIndex()));
+                    for(std::size_t k = 0; k < 3; ++k) {
+                        const double c = std::floor((static_cast<double>(p[k]) - origin) / cellSize);
+                        cells[3 * j + k] = static_cast<std::int64_t>(std::max(-maximumCell, std::min(maximumCell, c)));
+                        h = mix(h, static_cast<std::uint64_t>(cells[3 * j + k]));
+                    }
+                    hashes[j] = finalize(h);
+                }
+            }
+        }
+    );
+    HashBuckets buckets;
+    buckets.build(hashes, [&](const std::size_t j) { return candidates[j] != 0; });
+
+    // pairs of close points (k, j) with k < j
+    const double squaredDistance = distance * distance;
+    std::vector<std::vector<std::pair<std::size_t, std::size_t> > > pairs(
+        numberOfBlocks(points.size(), parallelOptions));
+    parallelFor(points.size(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                if(!candidates[j]) {
+                    continue;
+                }
+                const PointType& p = points[j];
+                const std::int64_t* cell = &cells[3 * j];
+                // neighboring cells along an axis are searched only if the
+                // point is close enough to the boundary between them
+                std::int64_t side[3] = {0, 0, 0};
+                for(std::size_t k = 0; k < 3; ++k) {
+                    const double offset = static_cast<double>(p[k]) - origin - cellSize * static_cast<double>(cell[k]);
+                    if(offset <= distance) {
+                        side[k] = -1;
+                    }
+                    else if(cellSize - offset <= distance) {
+                        side[k] = 1;
+                    }
+                }
+                for(std::size_t m = 0; m < 8; ++m) {
+                    if(((m & 1) && side[0] == 0) || ((m & 2) && side[1] == 0) || ((m & 4) && side[2] == 0)) {
+                        continue;
+                    }
+                    const std::int64_t neighbor[3] = {
+                        cell[0] + ((m & 1) ? side[0] : 0),
+                        cell[1] + ((m & 2) ? side[1] : 0),
+                        cell[2] + ((m & 4) ? side[2] : 0)
+                    };
+                    std::uint64_t h = mix(0, static_cast<std::uint64_t>(p.propertyIndex()));
+                    for(std::size_t k = 0; k < 3; ++k) {
+                        h = mix(h, static_cast<std::uint64_t>(neighbor[k]));
+                    }
+                    h = finalize(h);
+                    for(const std::size_t* k = buckets.begin(h); k != buckets.end(h) && *k < j; ++k) {
+                        const PointType& q = points[*k];
+                        if(cells[3 * *k] != neighbor[0] || cells[3 * *k + 1] != neighbor[1] || cells[3 * *k + 2] != neighbor[2]
+                        || q.propertyIndex() != p.propertyIndex()) {
+                            continue;
+                        }
+                        double d = 0;
+                        for(std::size_t i = 0; i < 3; ++i) {
+                            const double c = static_cast<double>(p[i]) - static_cast<double>(q[i]);
+                            d += c * c;
+                        }
+                        if(d <= squaredDistance) {
+                            pairs[block].push_back(std::make_pair(*k, j));
+                        }
+                    }
+                }
+            }
+        }
+    );
+
+    // union-find with the smallest index as root
+    std::vector<S> parents(representatives);
+    struct Find {
+        static S root(std::vector<S>& parents, S j)
+            {
+                while(parents[j] != j) {
+                    parents[j] = parents[parents[j]];
+                    j = parents[j];
+                }
+                return j;
+            }
+    };
+    for(std::size_t block = 0; block < pairs.size(); ++block) {
+        for(std::size_t m = 0; m < pairs[block].size(); ++m) {
+            const S r0 = Find::root(parents, static_cast<S>(pairs[block][m].first));
+            const S r1 = Find::root(parents, static_cast<S>(pairs[block][m].second));
+            if(r0 < r1) {
+                parents[r1] = r0;
+            }
+            else if(r1 < r0) {
+                parents[r0] = r1;
+            }
+        }
+    }
+    for(std::size_t j = 0; j < points.size(); ++j) {
+        representatives[j] = Find::root(parents, representatives[j]);
+    }
+}
+
+} // namespace detail
+
+/// Weld points, remove degenerate and duplicate lines and triangles, and
+/// remove unused points and properties.
+///
+/// Hashing, the comparison of points and primitives, the remapping of
+/// indices and the compaction of all vectors are parallel. The graphics
+/// is replaced by compacted vectors in which the order of the kept
+/// elements is preserved (unless points are reordered, see
+/// CleanupOptions).
+///
+/// \param graphics Graphics.
+/// \param options Options.
+/// \param parallelOptions Parallel options.
+/// \returns The new index of each point, line, triangle and property and
+///     the numbers of elements and bytes saved.
+///
+template<class T, class S>
+CleanupResult<S>
+cleanup(
+    Graphics<T, S>& graphics,
+    const CleanupOptions& options = CleanupOptions(),
+    const ParallelOptions& parallelOptions = ParallelOptions()
+) {
+    typedef Graphics<T, S> GraphicsType;
+    typedef S size_type;
+    typedef typename GraphicsType::PointType PointType;
+    typedef typename GraphicsType::LineType LineType;
+    typedef typename GraphicsType::TriangleType TriangleType;
+
+    CleanupResult<S> result;
+    const size_type removed = CleanupResult<S>::removed();
+    const std::size_t numberOfPoints = graphics.numberOfPoints();
+    const std::size_t numberOfLines = graphics.numberOfLines();
+    const std::size_t numberOfTriangles = graphics.numberOfTriangles();
+    result.points_.before_ = numberOfPoints;
+    result.lines_.before_ = numberOfLines;
+    result.triangles_.before_ = numberOfTriangles;
+    result.pointProperties_.before_ = graphics.numberOfPointProperties();
+    result.lineProperties_.before_ = graphics.numberOfLineProperties();
+    result.triangleProperties_.before_ = graphics.numberOfTriangleProperties();
+    result.bytesBefore_ = numberOfPoints * sizeof(PointType)
+        + numberOfLines * sizeof(LineType)
+        + numberOfTriangles * sizeof(TriangleType)
+        + graphics.numberOfPointProperties() * sizeof(typename GraphicsType::PointPropertyType)
+        + graphics.numberOfLineProperties() * sizeof(typename GraphicsType::LinePropertyType)
+        + graphics.numberOfTriangleProperties() * sizeof(typename GraphicsType::TrianglePropertyType);
+
+    // weld points
+    std::vector<size_type> representatives;
+    if(options.weldPoints_) {
+        detail::weldPoints(graphics.points(), options.weldDistance_, parallelOptions, representatives);
+    }
+    else {
+        representatives.resize(numberOfPoints);
+        for(std::size_t j = 0; j < numberOfPoints; ++j) {
+            representatives[j] = static_cast<size_type>(j);
+        }
+    }
+
+    // lines and triangles with welded points, with points in increasing
+    // order as keys for the detection of duplicates
+    typename GraphicsType::LinesVector lines(graphics.lines());
+    typename GraphicsType::TrianglesVector triangles(graphics.triangles());
+    std::vector<size_type> lineKeys(2 * numberOfLines);
+    std::vector<size_type> triangleKeys(3 * numberOfTriangles);
+    std::vector<unsigned char> keepLines(numberOfLines);
+    std::vector<unsigned char> keepTriangles(numberOfTriangles);
+    parallelFor(numberOfLines, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                size_type* key = &lineKeys[2 * j];
+                for(std::size_t k = 0; k < 2; ++k) {
+                    key[k] = lines[j].pointIndex(k) = representatives[lines[j].pointIndex(k)];
+                }
+                if(key[1] < key[0]) {
+                    std::swap(key[0], key[1]);
+                }
+                keepLines[j] = !(options.removeDegenerate_ && key[0] == key[1]);
+            }
+        }
+    );
+    parallelFor(numberOfTriangles, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                size_type* key = &triangleKeys[3 * j];
+                for(std::size_t k = 0; k < 3; ++k) {
+                    key[k] = triangles[j].pointIndex(k) = representatives[triangles[j].pointIndex(k)];
+                }
+                std::sort(key, key + 3);
+                keepTriangles[j] = !(options.removeDegenerate_ && (key[0] == key[1] || key[1] == key[2]));
+            }
+        }
+    );
+    for(std::size_t j = 0; j < numberOfLines; ++j) {
+        result.lines_.degenerate_ += keepLines[j] == 0;
+    }
+    for(std::size_t j = 0; j < numberOfTriangles; ++j) {
+        result.triangles_.degenerate_ += keepTriangles[j] == 0;
+    }
+
+    // remove duplicates
+    if(options.removeDuplicates_) {
+        std::vector<size_type> first;
+        detail::firstOccurrences(numberOfLines,
+            [&](const std::size_t j) {
+                return detail::finalize(detail::mix(detail::mix(detail::mix(0,
+                    static_cast<std::uint64_t>(lines[j].propertyIndex())),
+                    static_cast<std::uint64_t>(lineKeys[2 * j])),
+                    static_cast<std::uint64_t>(lineKeys[2 * j + 1])));
+            },
+            [&](const std::size_t j, const std::size_t k) {
+                return lineKeys[2 * j] == lineKeys[2 * k] && lineKeys[2 * j + 1] == lineKeys[2 * k + 1]
+                    && lines[j].propertyIndex() == lines[k].propertyIndex();
+            },
+            parallelOptions, first
+        );
+        for(std::size_t j = 0; j < numberOfLines; ++j) {
+            if(keepLines[j] && first[j] != j) {
+                keepLines[j] = 0;
+                ++result.lines_.duplicate_;
+            }
+        }
+        detail::firstOccurrences(numberOfTriangles,
+            [&](const std::size_t j) {
+                return detail::finalize(detail::mix(detail::mix(detail::mix(detail::mix(0,
+                    static_cast<std::uint64_t>(triangles[j].propertyIndex())),
+                    static_cast<std::uint64_t>(triangleKeys[3 * j])),
+                    static_cast<std::uint64_t>(triangleKeys[3 * j + 1])),
+                    static_cast<std::uint64_t>(triangleKeys[3 * j + 2])));
+            },
+            [&](const std::size_t j, const std::size_t k) {
+                return triangleKeys[3 * j] == triangleKeys[3 * k]
+                    && triangleKeys[3 * j + 1] == triangleKeys[3 * k + 1]
+                    && triangleKeys[3 * j + 2] == triangleKeys[3 * k + 2]
+                    && triangles[j].propertyIndex() == triangles[k].propertyIndex();
+            },
+            parallelOptions, first
+        );
+        for(std::size_t j = 0; j < numberOfTriangles; ++j) {
+            if(keepTriangles[j] && first[j] != j) {
+                keepTriangles[j] = 0;
+                ++result.triangles_.duplicate_;
+            }
+        }
+    }
+    lineKeys = std::vector<size_type>();
+    triangleKeys = std::vector<size_type>();
+
+    // points used by the kept lines and triangles
+    std::vector<unsigned char> keepPoints(numberOfPoints, 0);
+    for(std::size_t j = 0; j < numberOfLines; ++j) {
+        if(keepLines[j]) {
+            keepPoints[lines[j].pointIndex(0)] = 1;
+            keepPoints[lines[j].pointIndex(1)] = 1;
+        }
+    }
+    for(std::size_t j = 0; j < numberOfTriangles; ++j) {
+        if(keepTriangles[j]) {
+            keepPoints[triangles[j].pointIndex(0)] = 1;
+            keepPoints[triangles[j].pointIndex(1)] = 1;
+            keepPoints[triangles[j].pointIndex(2)] = 1;
+        }
+    }
+    for(std::size_t j = 0; j < numberOfPoints; ++j) {
+        if(representatives[j] != j) {
+            keepPoints[j] = 0;
+            ++result.points_.welded_;
+        }
+        else if(!keepPoints[j]) {
+            if(options.removeIsolatedPoints_ || !graphics.pointProperty(graphics.point(j).propertyIndex()).visibility()) {
+                ++result.points_.unused_;
+            }
+            else {
+                keepPoints[j] = 1;
+            }
+        }
+    }
+
+    // new indices of points
+    std::vector<size_type> pointMap;
+    std::size_t numberOfKeptPoints = 0;
+    if(options.reorderPoints_) {
+        pointMap.assign(numberOfPoints, removed);
+        for(std::size_t j = 0; j < numberOfTriangles; ++j) {
+            if(keepTriangles[j]) {
+                for(std::size_t k = 0; k < 3; ++k) {
+                    size_type& m = pointMap[triangles[j].pointIndex(k)];
+                    if(m == removed) {
+                        m = static_cast<size_type>(numberOfKeptPoints++);
+                    }
+                }
+            }
+        }
+        for(std::size_t j = 0; j < numberOfLines; ++j) {
+            if(keepLines[j]) {
+                for(std::size_t k = 0; k < 2; ++k) {
+                    size_type& m = pointMap[lines[j].pointIndex(k)];
+                    if(m == removed) {
+                        m = static_cast<size_type>(numberOfKeptPoints++);
+                    }
+                }
+            }
+        }
+        for(std::size_t j = 0; j < numberOfPoints; ++j) {
+            if(keepPoints[j] && pointMap[j] == removed) {
+                pointMap[j] = static_cast<size_type>(numberOfKeptPoints++);
+            }
+        }
+    }
+    else {
+        numberOfKeptPoints = detail::compactionMap(keepPoints, removed, parallelOptions, pointMap);
+    }
+
+    // properties used by the kept primitives
+    std::vector<unsigned char> keepPointProperties(graphics.numberOfPointProperties(), !options.removeUnusedProperties_);
+    std::vector<unsigned char> keepLineProperties(graphics.numberOfLineProperties(), !options.removeUnusedProperties_);
+    std::vector<unsigned char> keepTriangleProperties(graphics.numberOfTriangleProperties(), !options.removeUnusedProperties_);
+    if(!keepPointProperties.empty()) {
+        keepPointProperties[0] = 1;
+    }
+    if(!keepLineProperties.empty()) {
+        keepLineProperties[0] = 1;
+    }
+    if(!keepTriangleProperties.empty()) {
+        keepTriangleProperties[0] = 1;
+    }
+    for(std::size_t j = 0; j < numberOfPoints; ++j) {
+        if(keepPoints[j]) {
+            keepPointProperties[graphics.point(j).propertyIndex()] = 1;
+        }
+    }
+    for(std::size_t j = 0; j < numberOfLines; ++j) {
+        if(keepLines[j]) {
+            keepLineProperties[lines[j].propertyIndex()] = 1;
+        }
+    }
+    for(std::size_t j = 0; j < numberOfTriangles; ++j) {
+        if(keepTriangles[j]) {
+            keepTriangleProperties[triangles[j].propertyIndex()] = 1;
+        }
+    }
+
+    // compaction maps
+    const std::size_t numberOfKeptLines = detail::compactionMap(keepLines, removed, parallelOptions, result.lineMap_);
+    const std::size_t numberOfKeptTriangles = detail::compactionMap(keepTriangles, removed, parallelOptions, result.triangleMap_);
+    const std::size_t numberOfKeptPointProperties
+        = detail::compactionMap(keepPointProperties, removed, parallelOptions, result.pointPropertyMap_);
+    const std::size_t numberOfKeptLineProperties
+        = detail::compactionMap(keepLineProperties, removed, parallelOptions, result.linePropertyMap_);
+    const std::size_t numberOfKeptTriangleProperties
+        = detail::compactionMap(keepTriangleProperties, removed, parallelOptions, result.trianglePropertyMap_);
+    result.pointProperties_.unused_ = graphics.numberOfPointProperties() - numberOfKeptPointProperties;
+    result.lineProperties_.unused_ = graphics.numberOfLineProperties() - numberOfKeptLineProperties;
+    result.triangleProperties_.unused_ = graphics.numberOfTriangleProperties() - numberOfKeptTriangleProperties;
+
+    // compacted vectors
+    typename GraphicsType::PointsVector points(numberOfKeptPoints);
+    parallelFor(numberOfPoints, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                if(keepPoints[j]) {
+                    const PointType& p = graphics.point(j);
+                    points[pointMap[j]] = PointType(p[0], p[1], p[2], result.pointPropertyMap_[p.propertyIndex()]);
+                }
+            }
+        }
+    );
+    typename GraphicsType::LinesVector keptLines(numberOfKeptLines);
+    parallelFor(numberOfLines, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                if(keepLines[j]) {
+                    const LineType& l = lines[j];
+                    keptLines[result.lineMap_[j]] = LineType(pointMap[l.pointIndex(0)], pointMap[l.pointIndex(1)],
+                        result.linePropertyMap_[l.propertyIndex()]);
+                }
+            }
+        }
+    );
+    lines = typename GraphicsType::LinesVector();
+    typename GraphicsType::TrianglesVector keptTriangles(numberOfKeptTriangles);
+    parallelFor(numberOfTriangles, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                if(keepTriangles[j]) {
+                    const TriangleType& t = triangles[j];
+                    keptTriangles[result.triangleMap_[j]] = TriangleType(pointMap[t.pointIndex(0)],
+                        pointMap[t.pointIndex(1)], pointMap[t.pointIndex(2)],
+                        result.trianglePropertyMap_[t.propertyIndex()]);
+                }
+            }
+        }
+    );
+    triangles = typename GraphicsType::TrianglesVector();
+    typename GraphicsType::PointPropertiesVector pointProperties;
+    pointProperties.reserve(numberOfKeptPointProperties);
+    for(std::size_t j = 0; j < keepPointProperties.size(); ++j) {
+        if(keepPointProperties[j]) {
+            pointProperties.push_back(graphics.pointProperty(j));
+        }
+    }
+    typename GraphicsType::LinePropertiesVector lineProperties;
+    lineProperties.reserve(numberOfKeptLineProperties);
+    for(std::size_t j = 0; j < keepLineProperties.size(); ++j) {
+        if(keepLineProperties[j]) {
+            lineProperties.push_back(graphics.lineProperty(j));
+        }
+    }
+    typename GraphicsType::TrianglePropertiesVector triangleProperties;
+    triangleProperties.reserve(numberOfKeptTriangleProperties);
+    for(std::size_t j = 0; j < keepTriangleProperties.size(); ++j) {
+        if(keepTriangleProperties[j]) {
+            triangleProperties.push_back(graphics.triangleProperty(j));
+        }
+    }
+
+    // map of welded points to the new indices of their representatives
+    result.pointMap_.resize(numberOfPoints);
+    parallelFor(numberOfPoints, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                result.pointMap_[j] = pointMap[representatives[j]];
+            }
+        }
+    );
+
+    graphics.assign(std::move(pointProperties), std::move(points),
+        std::move(lineProperties), std::move(keptLines),
+        std::move(triangleProperties), std::move(keptTriangles));
+
+    result.points_.after_ = graphics.numberOfPoints();
+    result.lines_.after_ = graphics.numberOfLines();
+    result.triangles_.after_ = graphics.numberOfTriangles();
+    result.pointProperties_.after_ = graphics.numberOfPointProperties();
+    result.lineProperties_.after_ = graphics.numberOfLineProperties();
+    result.triangleProperties_.after_ = graphics.numberOfTriangleProperties();
+    result.bytesAfter_ = graphics.numberOfPoints() * sizeof(PointType)
+        + graphics.numberOfLines() * sizeof(LineType)
+        + graphics.numberOfTriangles() * sizeof(TriangleType)
+        + graphics.numberOfPointProperties() * sizeof(typename GraphicsType::PointPropertyType)
+        + graphics.numberOfLineProperties() * sizeof(typename GraphicsType::LinePropertyType)
+        + graphics.numberOfTriangleProperties() * sizeof(typename GraphicsType::TrianglePropertyType);
+    return result;
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_CLEANUP_HXX
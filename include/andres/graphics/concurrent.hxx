@@ -0,0 +1,775 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_CONCURRENT_HXX
+#define ANDRES_GRAPHICS_CONCURRENT_HXX
+
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "graphics.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Sorted set of disjoint, non-adjacent ranges [begin, end) of indices.
+///
+/// Insertions that extend the last range are merged immediately. Others
+/// are buffered and merged in batches, by sorting, when the buffer is full
+/// or when the ranges are accessed. The number of ranges is bounded. When
+/// a merge exceeds the bound, neighboring ranges with the smallest gaps
+/// are joined, so that the set may cover more indices than were inserted,
+/// but never fewer.
+///
+/// Const member functions merge the buffer and are therefore not safe to
+/// call concurrently unless normalize() has been called after the last
+/// insertion.
+///
+template<class S = std::size_t>
+class IndexRanges {
+public:
+    typedef S size_type;
+
+    struct Range {
+        bool operator<(const Range& other) const
+            { return begin_ < other.begin_; }
+        bool operator==(const Range& other) const
+            { return begin_ == other.begin_ && end_ == other.end_; }
+
+        size_type begin_;
+        size_type end_;
+    };
+    typedef std::vector<Range> RangesVector;
+
+    IndexRanges(const std::size_t maximumNumberOfRanges = 1 << 12)
+        :   ranges_(),
+            buffer_(),
+            maximumNumberOfRanges_(std::max<std::size_t>(maximumNumberOfRanges, 1))
+        {}
+    void insert(const size_type j)
+        { insert(j, j + 1); }
+    void insert(const size_type, const size_type);
+    void insert(const IndexRanges&);
+    void clear()
+        { ranges_.clear(); buffer_.clear(); }
+    void normalize() const;
+    bool empty() const
+        { return ranges_.empty() && buffer_.empty(); }
+    bool contains(const size_type) const;
+    std::size_t size() const
+        { normalize(); return ranges_.size(); }
+    const Range& operator[](const std::size_t j) const
+        { normalize(); return ranges_[j]; }
+    const RangesVector& ranges() const
+        { normalize(); return ranges_; }
+    size_type numberOfIndices() const;
+
+private:
+    mutable RangesVector ranges_;
+    mutable RangesVector buffer_; // unsorted insertions
+    std::size_t maximumNumberOfRanges_;
+};
+
+/// Insert the indices in [begin, end).
+///
+template<class S>
+inline void
+IndexRanges<S>::insert(
+    const size_type begin,
+    const size_type end
+) {
+    if(begin >= end) {
+        return;
+    }
+    // appending to or modifying within the last range is the common case
+    if(buffer_.empty() && !ranges_.empty()
+    && ranges_.back().begin_ <= begin && begin <= ranges_.back().end_) {
+        ranges_.back().end_ = std::max(ranges_.back().end_, end);
+        return;
+    }
+    Range range = {begin, end};
+    buffer_.push_back(range);
+    if(buffer_.size() >= maximumNumberOfRanges_) {
+        normalize();
+    }
+}
+
+/// Insert all ranges of another set.
+///
+template<class S>
+inline void
+IndexRanges<S>::insert(
+    const IndexRanges& other
+) {
+    other.normalize();
+    buffer_.insert(buffer_.end(), other.ranges_.begin(), other.ranges_.end());
+    if(buffer_.size() >= maximumNumberOfRanges_) {
+        normalize();
+    }
+}
+
+/// Merge the buffered insertions into the sorted ranges.
+///
+template<class S>
+inline void
+IndexRanges<S>::normalize() const {
+    if(buffer_.empty()) {
+        return;
+    }
+    std::sort(buffer_.begin(), buffer_.end());
+    const std::size_t middle = ranges_.size();
+    ranges_.insert(ranges_.end(), buffer_.begin(), buffer_.end());
+    buffer_.clear();
+    std::inplace_merge(ranges_.begin(), ranges_.begin() + middle, ranges_.end());
+
+    // coalesce overlapping and adjacent ranges
+    std::size_t n = 0;
+    for(std::size_t j = 1; j < ranges_.size(); ++j) {
+        if(ranges_[j].begin_ <= ranges_[n].end_) {
+            ranges_[n].end_ = std::max(ranges_[n].end_, ranges_[j].end_);
+        }
+        else {
+            ranges_[++n] = ranges_[j];
+        }
+    }
+    ranges_.resize(n + 1);
+
+    // join ranges across the smallest gaps
+    if(ranges_.size() > maximumNumberOfRanges_) {
+        std::vector<size_type> gaps(ranges_.size() - 1);
+        for(std::size_t j = 0; j < gaps.size(); ++j) {
+            gaps[j] = ranges_[j + 1].begin_ - ranges_[j].end_;
+        }
+        std::vector<size_type> sorted(gaps);
+        const std::size_t numberOfJoins = ranges_.size() - maximumNumberOfRanges_;
+        std::nth_element(sorted.begin(), sorted.begin() + (numberOfJoins - 1), sorted.end());
+        const size_type threshold = sorted[numberOfJoins - 1];
+        // join all gaps below the threshold and as many gaps equal to it
+        // as needed
+        std::size_t numberOfEqualJoins = numberOfJoins;
+        for(std::size_t j = 0; j < gaps.size(); ++j) {
+            if(gaps[j] < threshold) {
+                --numberOfEqualJoins;
+            }
+        }
+        n = 0;
+        for(std::size_t j = 1; j < ranges_.size(); ++j) {
+            const size_type gap = gaps[j - 1];
+            if(gap < threshold || (gap == threshold && numberOfEqualJoins > 0)) {
+                if(gap == threshold) {
+                    --numberOfEqualJoins;
+                }
+                ranges_[n].end_ = ranges_[j].end_;
+            }
+            else {
+                ranges_[++n] = ranges_[j];
+            }
+        }
+        ranges_.resize(n + 1);
+    }
+}
+
+template<class S>
+inline bool
+IndexRanges<S>::contains(
+    const size_type j
+) const {
+    normalize();
+    typename RangesVector::const_iterator it = std::upper_bound(ranges_.begin(), ranges_.end(), j,
+        [](const size_type index, const Range& range) { return index < range.begin_; });
+    return it != ranges_.begin() && j < (it - 1)->end_;
+}
+
+/// Number of indices covered by the ranges.
+///
+template<class S>
+inline typename IndexRanges<S>::size_type
+IndexRanges<S>::numberOfIndices() const {
+    normalize();
+    size_type n = 0;
+    for(std::size_t j = 0; j < ranges_.size(); ++j) {
+        n += ranges_[j].end_ - ranges_[j].begin_;
+    }
+    return n;
+}
+
+/// Indices of the primitives and properties that were defined or
+/// redefined, one IndexRanges per kind.
+///
+template<class S = std::size_t>
+struct Changes {
+    typedef S size_type;
+
+    bool empty() const
+        {
+            return points_.empty() && lines_.empty() && triangles_.empty()
+                && pointProperties_.empty() && lineProperties_.empty() && triangleProperties_.empty();
+        }
+    void clear()
+        {
+            points_.clear();
+            lines_.clear();
+            triangles_.clear();
+            pointProperties_.clear();
+            lineProperties_.clear();
+            triangleProperties_.clear();
+        }
+    void normalize() const
+        {
+            points_.normalize();
+            lines_.normalize();
+            triangles_.normalize();
+            pointProperties_.normalize();
+            lineProperties_.normalize();
+            triangleProperties_.normalize();
+        }
+    void insert(const Changes& other)
+        {
+            points_.insert(other.points_);
+            lines_.insert(other.lines_);
+            triangles_.insert(other.triangles_);
+            pointProperties_.insert(other.pointProperties_);
+            lineProperties_.insert(other.lineProperties_);
+            triangleProperties_.insert(other.triangleProperties_);
+        }
+
+    IndexRanges<size_type> points_;
+    IndexRanges<size_type> lines_;
+    IndexRanges<size_type> triangles_;
+    IndexRanges<size_type> pointProperties_;
+    IndexRanges<size_type> lineProperties_;
+    IndexRanges<size_type> triangleProperties_;
+};
+
+/// Graphics that one writer thread modifies while any number of reader
+/// threads take consistent snapshots.
+///
+/// The writer defines and redefines primitives and properties in a back
+/// buffer with the same functions as those of Graphics. publish() makes
+/// the back buffer the current version that snapshot() returns. Readers
+/// hold snapshots for as long as they like. A snapshot never changes and
+/// is freed when the last reader releases it.
+///
+/// Each published version records the ranges of indices that changed
+/// since the previous version. Snapshot::changes() merges these ranges
+/// for the most recent versions, so that readers can reprocess only what
+/// changed since the version they processed last.
+///
+/// After publishing, the writer needs a new back buffer. It reuses a
+/// previously published version that no reader holds any longer, if
+/// there is one, and brings it up to date by copying only the changed
+/// ranges. Otherwise, it copies the published version entirely. Up to
+/// numberOfRetiredVersions released versions are kept for reuse, at the
+/// cost of the memory for as many copies of the graphics.
+///
+/// publish() and snapshot() do not wait for each other except for the
+/// exchange of a shared pointer. Functions that modify the graphics must
+/// be called only from the writer thread. snapshot() can be called from
+/// any thread.
+///
+template<class T = float, class S = std::size_t>
+class ConcurrentGraphics {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef Graphics<value_type, size_type> GraphicsType;
+    typedef andres::graphics::Changes<size_type> ChangesType;
+
+    static const std::size_t historySize = 16;
+
+    /// Published version of the graphics.
+    ///
+    class Version {
+    public:
+        const GraphicsType& graphics() const
+            { return graphics_; }
+        std::size_t version() const
+            { return version_; }
+        bool changes(const std::size_t, ChangesType&) const;
+
+    private:
+        GraphicsType graphics_;
+        std::size_t version_;
+        std::vector<std::shared_ptr<const ChangesType> > history_; // most recent last
+
+    friend class ConcurrentGraphics<T, S>;
+    };
+    typedef std::shared_ptr<const Version> Snapshot;
+
+    ConcurrentGraphics(const std::size_t = 1);
+    ConcurrentGraphics(const GraphicsType&, const std::size_t = 1);
+
+    // reader threads
+    Snapshot snapshot() const;
+
+    // writer thread
+    std::size_t publish();
+    const GraphicsType& graphics() const
+        { return back_->graphics_; }
+    const ChangesType& pendingChanges() const
+        { return pending_; }
+    std::size_t numberOfCopies() const
+        { return numberOfCopies_; }
+    void reserve(const size_type, const size_type = 0, const size_type = 0);
+    size_type definePointProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    size_type defineLineProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    size_type defineTriangleProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    size_type definePoint(const value_type x, const value_type y, const value_type z, const size_type = 0);
+    size_type defineLine(const size_type, const size_type, const size_type = 0);
+    size_type defineTriangle(const size_type, const size_type, const size_type, const size_type = 0);
+    size_type definePoints(const value_type*, const size_type, const size_type = 0);
+    template<class INDEX>
+        size_type defineLines(const INDEX*, const size_type, const size_type = 0);
+    template<class INDEX>
+        size_type defineTriangles(const INDEX*, const size_type, const size_type = 0);
+    void setPointProperty(const size_type, const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    void setLineProperty(const size_type, const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    void setTriangleProperty(const size_type, const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    void setPoint(const size_type, const value_type x, const value_type y, const value_type z, const size_type = 0);
+    void setLine(const size_type, const size_type, const size_type, const size_type = 0);
+    void setTriangle(const size_type, const size_type, const size_type, const size_type, const size_type = 0);
+
+private:
+    static void update(GraphicsType&, const GraphicsType&, const ChangesType&);
+
+    std::shared_ptr<const Version> front_; // accessed atomically
+    std::shared_ptr<Version> back_;
+    std::vector<std::shared_ptr<const Version> > retired_;
+    std::size_t numberOfRetiredVersions_;
+    ChangesType pending_;
+    std::size_t numberOfCopies_;
+};
+
+/// Merge the changes of all versions after the given version up to and
+/// including this version.
+///
+/// \param version Version processed last by the reader.
+/// \param changes Merged changes (output).
+/// \returns false if the given version is newer than this version or so
+///     old that its changes are no longer recorded. In this case, readers
+///     need to reprocess the graphics entirely.
+///
+template<class T, class S>
+inline bool
+ConcurrentGraphics<T, S>::Version::changes(
+    const std::size_t version,
+    ChangesType& changes
+) const {
+    changes.clear();
+    if(version > version_ || version_ - version > history_.size()) {
+        return false;
+    }
+    for(std::size_t j = history_.size() - (version_ - version); j < history_.size(); ++j) {
+        changes.insert(*history_[j]);
+    }
+    return true;
+}
+
+/// Construct empty graphics, published as version 0.
+///
+/// \param numberOfRetiredVersions Number of released versions kept for
+///     reuse as back buffers.
+///
+template<class T, class S>
+inline
+ConcurrentGraphics<T, S>::ConcurrentGraphics(
+    const std::size_t numberOfRetiredVersions
+)
+:   front_(),
+    back_(new Version()),
+    retired_(),
+    numberOfRetiredVersions_(numberOfRetiredVersions),
+    pending_(),
+    numberOfCopies_(0)
+{
+    back_->version_ = 0;
+    front_ = std::make_shared<const Version>(*back_);
+}
+
+/// Construct from graphics, published as version 0.
+///
+/// \param numberOfRetiredVersions Number of released versions kept for
+///     reuse as back buffers.
+///
+template<class T, class S>
+inline
+ConcurrentGraphics<T, S>::ConcurrentGraphics(
+    const GraphicsType& graphics,
+    const std::size_t numberOfRetiredVersions
+)
+:   front_(),
+    back_(new Version()),
+    retired_(),
+    numberOfRetiredVersions_(numberOfRetiredVersions),
+    pending_(),
+    numberOfCopies_(0)
+{
+    back_->graphics_ = graphics;
+    back_->version_ = 0;
+    front_ = std::make_shared<const Version>(*back_);
+}
+
+/// Current version of the graphics.
+///
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::Snapshot
+ConcurrentGraphics<T, S>::snapshot() const {
+    return std::atomic_load(&front_);
+}
+
+/// Publish all modifications since the last call as a new version.
+///
+/// \returns The number of the new version.
+///
+template<class T, class S>
+inline std::size_t
+ConcurrentGraphics<T, S>::publish() {
+    // only the writer replaces front_, so it can be read non-atomically here
+    std::shared_ptr<Version> next = back_;
+    next->version_ = front_->version_ + 1;
+    next->history_ = front_->history_;
+    if(next->history_.size() == historySize) {
+        next->history_.erase(next->history_.begin());
+    }
+    pending_.normalize(); // before sharing with readers
+    next->history_.push_back(std::make_shared<const ChangesType>(pending_));
+    pending_.clear();
+
+    std::shared_ptr<const Version> previous = front_;
+    std::atomic_store(&front_, std::shared_ptr<const Version>(next));
+    retired_.push_back(previous);
+    previous.reset();
+
+    // reuse the newest retired version that no reader holds and whose
+    // changes since are recorded
+    ChangesType changes;
+    back_.reset();
+    for(std::size_t j = retired_.size(); j > 0; --j) {
+        if(retired_[j - 1].use_count() == 1 && next->changes(retired_[j - 1]->version_, changes)) {
+            // the last reader released the version, so its reads happen
+            // before the following modifications
+            std::atomic_thread_fence(std::memory_order_acquire);
+            back_ = std::const_pointer_cast<Version>(retired_[j - 1]);
+            retired_.erase(retired_.begin() + (j - 1));
+            update(back_->graphics_, next->graphics_, changes);
+            break;
+        }
+    }
+    if(!back_) {
+        back_ = std::make_shared<Version>(*next);
+        ++numberOfCopies_;
+    }
+    while(retired_.size() > numberOfRetiredVersions_) {
+        retired_.erase(retired_.begin());
+    }
+    return next->version_;
+}
+
+/// Copy the changed ranges from source to target, properties before
+/// points and points before lines and triangles, so that all indices are
+/// valid when copied.
+///
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::update(
+    GraphicsType& target,
+    const GraphicsType& source,
+    const ChangesType& changes
+) {
+    typedef typename IndexRanges<size_type>::Range Range;
+
+    for(const Range& range : changes.pointProperties_.ranges()) {
+        for(size_type j = range.begin_; j < range.end_ && j < source.numberOfPointProperties(); ++j) {
+            const typename GraphicsType::PointPropertyType& p = source.pointProperty(j);
+            if(j < target.numberOfPointProperties()) {
+                target.setPointProperty(j, p.visibility(), p.color(0), p.color(1), p.color(2), p.alpha());
+            }
+            else {
+                assert(j == target.numberOfPointProperties());
+                target.definePointProperty(p.visibility(), p.color(0), p.color(1), p.color(2), p.alpha());
+            }
+        }
+    }
+    for(const Range& range : changes.lineProperties_.ranges()) {
+        for(size_type j = range.begin_; j < range.end_ && j < source.numberOfLineProperties(); ++j) {
+            const typename GraphicsType::LinePropertyType& p = source.lineProperty(j);
+            if(j < target.numberOfLineProperties()) {
+                target.setLineProperty(j, p.visibility(), p.color(0), p.color(1), p.color(2), p.alpha());
+            }
+            else {
+                assert(j == target.numberOfLineProperties());
+                target.defineLineProperty(p.visibility(), p.color(0), p.color(1), p.color(2), p.alpha());
+            }
+        }
+    }
+    for(const Range& range : changes.triangleProperties_.ranges()) {
+        for(size_type j = range.begin_; j < range.end_ && j < source.numberOfTriangleProperties(); ++j) {
+            const typename GraphicsType::TrianglePropertyType& p = source.triangleProperty(j);
+            if(j < target.numberOfTriangleProperties()) {
+                target.setTriangleProperty(j, p.visibility(), p.color(0), p.color(1), p.color(2), p.alpha());
+            }
+            else {
+                assert(j == target.numberOfTriangleProperties());
+                target.defineTriangleProperty(p.visibility(), p.color(0), p.color(1), p.color(2), p.alpha());
+            }
+        }
+    }
+    for(const Range& range : changes.points_.ranges()) {
+        for(size_type j = range.begin_; j < range.end_ && j < source.numberOfPoints(); ++j) {
+            const typename GraphicsType::PointType& p = source.point(j);
+            if(j < target.numberOfPoints()) {
+                target.setPoint(j, p[0], p[1], p[2], p.propertyIndex());
+            }
+            else {
+                assert(j == target.numberOfPoints());
+                target.definePoint(p[0], p[1], p[2], p.propertyIndex());
+            }
+        }
+    }
+    for(const Range& range : changes.lines_.ranges()) {
+        for(size_type j = range.begin_; j < range.end_ && j < source.numberOfLines(); ++j) {
+            const typename GraphicsType::LineType& l = source.line(j);
+            if(j < target.numberOfLines()) {
+                target.setLine(j, l.pointIndex(0), l.pointIndex(1), l.propertyIndex());
+            }
+            else {
+                assert(j == target.numberOfLines());
+                target.defineLine(l.pointIndex(0), l.pointIndex(1), l.propertyIndex());
+            }
+        }
+    }
+    for(const Range& range : changes.triangles_.ranges()) {
+        for(size_type j = range.begin_; j < range.end_ && j < source.numberOfTriangles(); ++j) {
+            const typename GraphicsType::TriangleType& t = source.triangle(j);
+            if(j < target.numberOfTriangles()) {
+                target.setTriangle(j, t.pointIndex(0), t.pointIndex(1), t.pointIndex(2), t.propertyIndex());
+            }
+            else {
+                assert(j == target.numberOfTriangles());
+                target.defineTriangle(t.pointIndex(0), t.pointIndex(1), t.pointIndex(2), t.propertyIndex());
+            }
+        }
+    }
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::reserve(
+    const size_type numberOfPoints,
+    const size_type numberOfLines,
+    const size_type numberOfTriangles
+) {
+    back_->graphics_.reserve(numberOfPoints, numberOfLines, numberOfTriangles);
+}
+
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::definePointProperty(
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    const size_type index = back_->graphics_.definePointProperty(visibility, r, g, b, alpha);
+    pending_.pointProperties_.insert(index);
+    return index;
+}
+
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::defineLineProperty(
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    const size_type index = back_->graphics_.defineLineProperty(visibility, r, g, b, alpha);
+    pending_.lineProperties_.insert(index);
+    return index;
+}
+
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::defineTriangleProperty(
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    const size_type index = back_->graphics_.defineTriangleProperty(visibility, r, g, b, alpha);
+    pending_.triangleProperties_.insert(index);
+    return index;
+}
+
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::definePoint(
+    const value_type x,
+    const value_type y,
+    const value_type z,
+    const size_type propertyIndex
+) {
+    const size_type index = back_->graphics_.definePoint(x, y, z, propertyIndex);
+    pending_.points_.insert(index);
+    return index;
+}
+
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::defineLine(
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type propertyIndex
+) {
+    const size_type index = back_->graphics_.defineLine(pointIndex0, pointIndex1, propertyIndex);
+    pending_.lines_.insert(index);
+    return index;
+}
+
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::defineTriangle(
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type pointIndex2,
+    const size_type propertyIndex
+) {
+    const size_type index = back_->graphics_.defineTriangle(pointIndex0, pointIndex1, pointIndex2, propertyIndex);
+    pending_.triangles_.insert(index);
+    return index;
+}
+
+/// Define points from an array of coordinates, see Graphics::definePoints().
+///
+template<class T, class S>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::definePoints(
+    const value_type* coordinates,
+    const size_type numberOfPoints,
+    const size_type propertyIndex
+) {
+    const size_type index = back_->graphics_.definePoints(coordinates, numberOfPoints, propertyIndex);
+    pending_.points_.insert(index, index + numberOfPoints);
+    return index;
+}
+
+/// Define lines from an array of point indices, see Graphics::defineLines().
+///
+template<class T, class S>
+template<class INDEX>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::defineLines(
+    const INDEX* pointIndices,
+    const size_type numberOfLines,
+    const size_type propertyIndex
+) {
+    const size_type index = back_->graphics_.defineLines(pointIndices, numberOfLines, propertyIndex);
+    pending_.lines_.insert(index, index + numberOfLines);
+    return index;
+}
+
+/// Define triangles from an array of point indices, see
+/// Graphics::defineTriangles().
+///
+template<class T, class S>
+template<class INDEX>
+inline typename ConcurrentGraphics<T, S>::size_type
+ConcurrentGraphics<T, S>::defineTriangles(
+    const INDEX* pointIndices,
+    const size_type numberOfTriangles,
+    const size_type propertyIndex
+) {
+    const size_type index = back_->graphics_.defineTriangles(pointIndices, numberOfTriangles, propertyIndex);
+    pending_.triangles_.insert(index, index + numberOfTriangles);
+    return index;
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::setPointProperty(
+    const size_type index,
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    back_->graphics_.setPointProperty(index, visibility, r, g, b, alpha);
+    pending_.pointProperties_.insert(index);
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::setLineProperty(
+    const size_type index,
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    back_->graphics_.setLineProperty(index, visibility, r, g, b, alpha);
+    pending_.lineProperties_.insert(index);
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::setTriangleProperty(
+    const size_type index,
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    back_->graphics_.setTriangleProperty(index, visibility, r, g, b, alpha);
+    pending_.triangleProperties_.insert(index);
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::setPoint(
+    const size_type index,
+    const value_type x,
+    const value_type y,
+    const value_type z,
+    const size_type propertyIndex
+) {
+    back_->graphics_.setPoint(index, x, y, z, propertyIndex);
+    pending_.points_.insert(index);
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::setLine(
+    const size_type index,
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type propertyIndex
+) {
+    back_->graphics_.setLine(index, pointIndex0, pointIndex1, propertyIndex);
+    pending_.lines_.insert(index);
+}
+
+template<class T, class S>
+inline void
+ConcurrentGraphics<T, S>::setTriangle(
+    const size_type index,
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type pointIndex2,
+    const size_type propertyIndex
+) {
+    back_->graphics_.setTriangle(index, pointIndex0, pointIndex1, pointIndex2, propertyIndex);
+    pending_.triangles_.insert(index);
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_CONCURRENT_HXX
@@ -0,0 +1,391 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_CULLING_HXX
+#define ANDRES_GRAPHICS_CULLING_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "graphics.hxx"
+#include "parallel.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Numbers of primitives of one kind kept and dropped by ScreenSpaceCulling.
+///
+/// Every primitive is counted exactly once, such that kept_ + dropped() is
+/// the number of primitives of that kind in the graphics.
+///
+struct CullingCounts {
+    CullingCounts()
+        : kept_(0), invisible_(0), offCanvas_(0), merged_(0)
+        {}
+    std::size_t dropped() const
+        { return invisible_ + offCanvas_ + merged_; }
+
+    std::size_t kept_;
+    std::size_t invisible_; // by property
+    std::size_t offCanvas_;
+    std::size_t merged_; // with a primitive in the same cell
+};
+
+inline std::ostream&
+operator<<(
+    std::ostream& out,
+    const CullingCounts& counts
+) {
+    return out << counts.kept_ << " kept, "
+        << counts.invisible_ << " invisible, "
+        << counts.offCanvas_ << " off canvas, "
+        << counts.merged_ << " merged";
+}
+
+namespace detail {
+
+/// Cell of the canvas and property index, identifying primitives that
+/// cover the same pixels.
+///
+struct CellKey {
+    bool operator==(const CellKey& other) const
+        { return x_ == other.x_ && y_ == other.y_ && propertyIndex_ == other.propertyIndex_; }
+
+    std::int64_t x_;
+    std::int64_t y_;
+    std::uint64_t propertyIndex_;
+};
+
+inline std::uint64_t
+hash(
+    const CellKey& key
+) {
+    std::uint64_t h = static_cast<std::uint64_t>(key.x_) * 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 32) ^ static_cast<std::uint64_t>(key.y_)) * 0x9e3779b97f4a7c15ull;
+    h ^= key.propertyIndex_;
+    // finalizer of splitmix64
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+/// Set of cell keys by open addressing with linear probing.
+///
+/// Each slot holds a fingerprint of the hash of its key, such that keys
+/// are compared only if their fingerprints match. The table grows with the
+/// number of distinct keys, which is bounded by the number of cells of the
+/// canvas times the number of properties.
+///
+class CellKeySet {
+public:
+    CellKeySet()
+        : keys_(), slots_(1024), mask_(1023)
+        {}
+    /// Insert a key and return true unless the key is in the set already.
+    bool insert(const CellKey& key)
+        {
+            const std::uint64_t h = hash(key);
+            const std::uint32_t fingerprint = static_cast<std::uint32_t>(h >> 32) | 1; // 0 marks empty slots
+            for(std::size_t j = static_cast<std::size_t>(h) & mask_; ; j = (j + 1) & mask_) {
+                Slot& slot = slots_[j];
+                if(slot.fingerprint == 0) {
+                    slot.fingerprint = fingerprint;
+                    slot.index = keys_.size();
+                    keys_.push_back(key);
+                    if(2 * keys_.size() > slots_.size()) {
+                        grow();
+                    }
+                    return true;
+                }
+                if(slot.fingerprint == fingerprint && keys_[slot.index] == key) {
+                    return false;
+                }
+            }
+        }
+
+private:
+    struct Slot {
+        Slot()
+            : fingerprint(0), index(0)
+            {}
+
+        std::uint32_t fingerprint;
+        std::size_t index; // into keys_
+    };
+
+    void grow()
+        {
+            std::vector<Slot> slots(2 * slots_.size());
+            mask_ = slots.size() - 1;
+            for(std::size_t j = 0; j < slots_.size(); ++j) {
+                if(slots_[j].fingerprint != 0) {
+                    std::size_t k = static_cast<std::size_t>(hash(keys_[slots_[j].index])) & mask_;
+                    while(slots[k].fingerprint != 0) {
+                        k = (k + 1) & mask_;
+                    }
+                    slots[k] = slots_[j];
+                }
+            }
+            slots_.swap(slots);
+        }
+
+    std::vector<CellKey> keys_;
+    std::vector<Slot> slots_;
+    std::size_t mask_;
+};
+
+} // namespace detail
+
+/// Screen-space culling of the primitives of a graphics.
+///
+/// The points of a graphics are projected once onto the canvas. Points,
+/// lines and triangles whose bounding box does not intersect the canvas
+/// [xMin, xMax] x [yMin, yMax] are dropped. Primitives whose bounding box
+/// is smaller than the tolerance (in units of the canvas, e.g. pixels) are
+/// then merged with all primitives of the same kind and property whose
+/// bounding box is centered in the same cell of a grid with the tolerance
+/// as spacing, e.g. all points within one pixel or all lines shorter than
+/// a pixel around the same pixel. Only the first primitive of each such
+/// group is kept, such that the error is less than the tolerance. A
+/// tolerance of 0 disables merging.
+///
+/// The indices of the kept primitives and the projected coordinates of
+/// all points can be passed to an emitter, e.g. saveSVG().
+///
+template<class T = float, class S = std::size_t>
+class ScreenSpaceCulling {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef Graphics<value_type, size_type> GraphicsType;
+
+    ScreenSpaceCulling(
+        const value_type xMin = -std::numeric_limits<value_type>::infinity(),
+        const value_type yMin = -std::numeric_limits<value_type>::infinity(),
+        const value_type xMax = std::numeric_limits<value_type>::infinity(),
+        const value_type yMax = std::numeric_limits<value_type>::infinity(),
+        const value_type tolerance = 1
+    )
+        {
+            canvas_[0] = xMin; canvas_[1] = yMin;
+            canvas_[2] = xMax; canvas_[3] = yMax;
+            tolerance_ = tolerance;
+        }
+
+    template<class PROJECTION>
+    void operator()(const GraphicsType&, const PROJECTION&, const ParallelOptions& = ParallelOptions());
+
+    value_type xMin() const
+        { return canvas_[0]; }
+    value_type yMin() const
+        { return canvas_[1]; }
+    value_type xMax() const
+        { return canvas_[2]; }
+    value_type yMax() const
+        { return canvas_[3]; }
+    value_type tolerance() const
+        { return tolerance_; }
+
+    const std::vector<size_type>& pointIndices() const
+        { return pointIndices_; }
+    const std::vector<size_type>& lineIndices() const
+        { return lineIndices_; }
+    const std::vector<size_type>& triangleIndices() const
+        { return triangleIndices_; }
+    void project(const size_type pointIndex, value_type& x, value_type& y) const
+        { x = coordinates_[2 * pointIndex]; y = coordinates_[2 * pointIndex + 1]; }
+
+    const CullingCounts& points() const
+        { return points_; }
+    const CullingCounts& lines() const
+        { return lines_; }
+    const CullingCounts& triangles() const
+        { return triangles_; }
+
+private:
+    bool intersectsCanvas(const size_type*, const std::size_t) const;
+    std::int64_t cell(const value_type) const;
+    bool cellKey(const size_type*, const std::size_t, const size_type, detail::CellKey&) const;
+
+    value_type canvas_[4];
+    value_type tolerance_;
+    std::vector<value_type> coordinates_; // x and y of each point
+    std::vector<size_type> pointIndices_;
+    std::vector<size_type> lineIndices_;
+    std::vector<size_type> triangleIndices_;
+    CullingCounts points_;
+    CullingCounts lines_;
+    CullingCounts triangles_;
+};
+
+/// Project the points of a graphics and select the primitives to be kept.
+///
+/// \param graphics Graphics.
+/// \param projection Projection of 3D coordinates onto the canvas, called
+///     as projection(x, y, z, r, s).
+/// \param parallelOptions Options for the parallel projection of points.
+///
+template<class T, class S>
+template<class PROJECTION>
+void
+ScreenSpaceCulling<T, S>::operator()(
+    const GraphicsType& graphics,
+    const PROJECTION& projection,
+    const ParallelOptions& parallelOptions
+) {
+    coordinates_.resize(2 * graphics.numberOfPoints());
+    parallelFor(graphics.numberOfPoints(), parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                const typename GraphicsType::PointType& point = graphics.point(static_cast<size_type>(j));
+                projection(point[0], point[1], point[2], coordinates_[2 * j], coordinates_[2 * j + 1]);
+            }
+        }
+    );
+
+    points_ = CullingCounts();
+    pointIndices_.clear();
+    {
+        detail::CellKeySet cells;
+        detail::CellKey key;
+        for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+            const size_type propertyIndex = graphics.point(j).propertyIndex();
+            if(!graphics.pointProperty(propertyIndex).visibility()) {
+                ++points_.invisible_;
+            }
+            else if(!intersectsCanvas(&j, 1)) {
+                ++points_.offCanvas_;
+            }
+            else if(tolerance_ > 0 && cellKey(&j, 1, propertyIndex, key) && !cells.insert(key)) {
+                ++points_.merged_;
+            }
+            else {
+                pointIndices_.push_back(j);
+            }
+        }
+        points_.kept_ = pointIndices_.size();
+    }
+
+    lines_ = CullingCounts();
+    lineIndices_.clear();
+    {
+        detail::CellKeySet cells;
+        detail::CellKey key;
+        for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
+            const typename GraphicsType::LineType& line = graphics.line(j);
+            const size_type pointIndices[] = {line.pointIndex(0), line.pointIndex(1)};
+            if(!graphics.lineProperty(line.propertyIndex()).visibility()) {
+                ++lines_.invisible_;
+            }
+            else if(!intersectsCanvas(pointIndices, 2)) {
+                ++lines_.offCanvas_;
+            }
+            else if(tolerance_ > 0 && cellKey(pointIndices, 2, line.propertyIndex(), key) && !cells.insert(key)) {
+                ++lines_.merged_;
+            }
+            else {
+                lineIndices_.push_back(j);
+            }
+        }
+        lines_.kept_ = lineIndices_.size();
+    }
+
+    triangles_ = CullingCounts();
+    triangleIndices_.clear();
+    {
+        detail::CellKeySet cells;
+        detail::CellKey key;
+        for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+            const typename GraphicsType::TriangleType& triangle = graphics.triangle(j);
+            const size_type pointIndices[] = {triangle.pointIndex(0), triangle.pointIndex(1), triangle.pointIndex(2)};
+            if(!graphics.triangleProperty(triangle.propertyIndex()).visibility()) {
+                ++triangles_.invisible_;
+            }
+            else if(!intersectsCanvas(pointIndices, 3)) {
+                ++triangles_.offCanvas_;
+            }
+            else if(tolerance_ > 0 && cellKey(pointIndices, 3, triangle.propertyIndex(), key) && !cells.insert(key)) {
+                ++triangles_.merged_;
+            }
+            else {
+                triangleIndices_.push_back(j);
+            }
+        }
+        triangles_.kept_ = triangleIndices_.size();
+    }
+}
+
+template<class T, class S>
+inline bool
+ScreenSpaceCulling<T, S>::intersectsCanvas(
+    const size_type* pointIndices,
+    const std::size_t size
+) const {
+    value_type box[4] = {
+        std::numeric_limits<value_type>::infinity(),
+        std::numeric_limits<value_type>::infinity(),
+        -std::numeric_limits<value_type>::infinity(),
+        -std::numeric_limits<value_type>::infinity()
+    };
+    for(std::size_t k = 0; k < size; ++k) {
+        const value_type x = coordinates_[2 * pointIndices[k]];
+        const value_type y = coordinates_[2 * pointIndices[k] + 1];
+        box[0] = std::min(box[0], x);
+        box[1] = std::min(box[1], y);
+        box[2] = std::max(box[2], x);
+        box[3] = std::max(box[3], y);
+    }
+    return box[2] >= canvas_[0] && box[0] <= canvas_[2]
+        && box[3] >= canvas_[1] && box[1] <= canvas_[3];
+}
+
+template<class T, class S>
+inline std::int64_t
+ScreenSpaceCulling<T, S>::cell(
+    const value_type x
+) const {
+    const double limit = 4e18; // within the range of std::int64_t
+    return static_cast<std::int64_t>(std::max(-limit, std::min(limit, std::floor(static_cast<double>(x) / tolerance_))));
+}
+
+/// Cell of the center of the bounding box and property index of a
+/// primitive whose bounding box is smaller than the tolerance. Returns
+/// false for larger primitives.
+///
+template<class T, class S>
+inline bool
+ScreenSpaceCulling<T, S>::cellKey(
+    const size_type* pointIndices,
+    const std::size_t size,
+    const size_type propertyIndex,
+    detail::CellKey& key
+) const {
+    value_type box[4] = {
+        coordinates_[2 * pointIndices[0]], coordinates_[2 * pointIndices[0] + 1],
+        coordinates_[2 * pointIndices[0]], coordinates_[2 * pointIndices[0] + 1]
+    };
+    for(std::size_t k = 1; k < size; ++k) {
+        const value_type x = coordinates_[2 * pointIndices[k]];
+        const value_type y = coordinates_[2 * pointIndices[k] + 1];
+        box[0] = std::min(box[0], x);
+        box[1] = std::min(box[1], y);
+        box[2] = std::max(box[2], x);
+        box[3] = std::max(box[3], y);
+    }
+    if(!(box[2] - box[0] < tolerance_ && box[3] - box[1] < tolerance_)) {
+        return false;
+    }
+    key.x_ = cell((box[0] + box[2]) / 2);
+    key.y_ = cell((box[1] + box[3]) / 2);
+    key.propertyIndex_ = static_cast<std::uint64_t>(propertyIndex);
+    return true;
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_CULLING_HXX
@@ -0,0 +1,970 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_GRAPHICS_BINARY_HXX
+#define ANDRES_GRAPHICS_GRAPHICS_BINARY_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graphics.hxx"
+#include "parallel.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Native binary file format of graphics that can be memory-mapped and
+/// used in place, see MappedGraphics.
+///
+/// A file consists of a header of 192 bytes and six sections that hold
+/// the point properties, points, line properties, lines, triangle
+/// properties and triangles, in this order. All numbers are little-endian.
+///
+/// Header (version 1):
+///
+///     offset  size  content
+///          0     8  magic number 89 'A' 'G' 'B' 0d 0a 1a 0a
+///          8     4  version
+///         12     4  size of the header
+///         16     1  size of a coordinate (4 or 8, IEEE 754)
+///         17     1  size of an index (1, 2, 4 or 8, unsigned)
+///         18     2  zero
+///         20     4  alignment of sections
+///         24   144  per section: offset, number of records and size of
+///                   a record in bytes, as 8-byte integers
+///        168    24  zero
+///
+/// Sections start at multiples of the alignment (64). Records are laid
+/// out as C structs of their members in the order of Point, Line, etc.,
+/// each member aligned to its size, e.g. a Point<float, std::size_t> as
+/// x, y, z (4 bytes each), 4 bytes of zeros and the property index
+/// (8 bytes). Properties take 5 bytes: visibility, r, g, b, alpha.
+///
+/// On little-endian machines, this is the memory layout of Graphics<T, S>
+/// with the same sizes of T and S. Files in this layout are mapped
+/// without copying by MappedGraphics. load() reads files of any layout.
+///
+namespace binary {
+
+namespace detail {
+
+enum Section {
+    PointPropertiesSection,
+    PointsSection,
+    LinePropertiesSection,
+    LinesSection,
+    TrianglePropertiesSection,
+    TrianglesSection,
+    NumberOfSections
+};
+
+const unsigned char magic[8] = {0x89, 'A', 'G', 'B', 0x0d, 0x0a, 0x1a, 0x0a};
+const std::uint32_t version = 1;
+const std::size_t headerSize = 192;
+const std::size_t sectionAlignment = 64;
+const std::size_t propertyRecordSize = 5;
+
+inline bool
+isLittleEndianMachine() {
+    const std::uint16_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+inline std::uint64_t
+roundUp(
+    const std::uint64_t n,
+    const std::uint64_t multiple
+) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+inline void
+storeUnsigned(
+    unsigned char* data,
+    std::uint64_t value,
+    const std::size_t size
+) {
+    for(std::size_t j = 0; j < size; ++j) {
+        data[j] = static_cast<unsigned char>(value >> (8 * j));
+    }
+}
+
+inline std::uint64_t
+loadUnsigned(
+    const unsigned char* data,
+    const std::size_t size
+) {
+    std::uint64_t value = 0;
+    for(std::size_t j = 0; j < size; ++j) {
+        value |= static_cast<std::uint64_t>(data[j]) << (8 * j);
+    }
+    return value;
+}
+
+template<class T>
+inline void
+storeFloat(
+    unsigned char* data,
+    const T value,
+    const std::size_t size
+) {
+    if(size == 4) {
+        const float x = static_cast<float>(value);
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, 4);
+        storeUnsigned(data, bits, 4);
+    }
+    else {
+        const double x = static_cast<double>(value);
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, 8);
+        storeUnsigned(data, bits, 8);
+    }
+}
+
+template<class T>
+inline T
+loadFloat(
+    const unsigned char* data,
+    const std::size_t size
+) {
+    if(size == 4) {
+        const std::uint32_t bits = static_cast<std::uint32_t>(loadUnsigned(data, 4));
+        float x;
+        std::memcpy(&x, &bits, 4);
+        return static_cast<T>(x);
+    }
+    else {
+        const std::uint64_t bits = loadUnsigned(data, 8);
+        double x;
+        std::memcpy(&x, &bits, 8);
+        return static_cast<T>(x);
+    }
+}
+
+/// Sizes and offsets of the members of records, given the size of
+/// coordinates and indices.
+///
+struct Layout {
+    Layout(const std::size_t valueSize, const std::size_t indexSize)
+        :   valueSize_(valueSize),
+            indexSize_(indexSize),
+            pointPropertyIndexOffset_(roundUp(3 * valueSize, indexSize))
+        {
+            recordSize_[PointPropertiesSection] = propertyRecordSize;
+            recordSize_[PointsSection] = roundUp(pointPropertyIndexOffset_ + indexSize, std::max(valueSize, indexSize));
+            recordSize_[LinePropertiesSection] = propertyRecordSize;
+            recordSize_[LinesSection] = 3 * indexSize;
+            recordSize_[TrianglePropertiesSection] = propertyRecordSize;
+            recordSize_[TrianglesSection] = 4 * indexSize;
+        }
+
+    std::size_t valueSize_;
+    std::size_t indexSize_;
+    std::size_t pointPropertyIndexOffset_;
+    std::size_t recordSize_[NumberOfSections];
+};
+
+/// Whether Graphics<T, S> has the layout of a file in memory.
+///
+template<class T, class S>
+inline bool
+isMemoryLayout(
+    const Layout& layout
+) {
+    typedef Graphics<T, S> GraphicsType;
+    typedef typename GraphicsType::PointType PointType;
+    typedef typename GraphicsType::LineType LineType;
+    typedef typename GraphicsType::TriangleType TriangleType;
+    typedef typename GraphicsType::PointPropertyType PointPropertyType;
+    typedef typename GraphicsType::LinePropertyType LinePropertyType;
+    typedef typename GraphicsType::TrianglePropertyType TrianglePropertyType;
+
+    if(!isLittleEndianMachine() || sizeof(T) != layout.valueSize_ || sizeof(S) != layout.indexSize_) {
+        return false;
+    }
+    PointType point;
+    PointPropertyType pointProperty;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(&point);
+    const unsigned char* q = reinterpret_cast<const unsigned char*>(&pointProperty);
+    return sizeof(PointType) == layout.recordSize_[PointsSection]
+        && reinterpret_cast<const unsigned char*>(&point[0]) == p
+        && reinterpret_cast<const unsigned char*>(&point.propertyIndex()) == p + layout.pointPropertyIndexOffset_
+        && sizeof(LineType) == layout.recordSize_[LinesSection]
+        && sizeof(TriangleType) == layout.recordSize_[TrianglesSection]
+        && sizeof(PointPropertyType) == propertyRecordSize
+        && sizeof(LinePropertyType) == propertyRecordSize
+        && sizeof(TrianglePropertyType) == propertyRecordSize
+        && reinterpret_cast<const unsigned char*>(&pointProperty.visibility()) == q
+        && reinterpret_cast<const unsigned char*>(&pointProperty.color(0)) == q + 1
+        && reinterpret_cast<const unsigned char*>(&pointProperty.alpha()) == q + 4;
+}
+
+template<class PROPERTY>
+inline void
+encodeProperty(
+    const PROPERTY& property,
+    unsigned char* data
+) {
+    data[0] = property.visibility();
+    data[1] = property.color(0);
+    data[2] = property.color(1);
+    data[3] = property.color(2);
+    data[4] = property.alpha();
+}
+
+template<class PROPERTY>
+inline void
+decodeProperty(
+    const unsigned char* data,
+    PROPERTY& property
+) {
+    property = PROPERTY(data[0], data[1], data[2], data[3], data[4]);
+}
+
+template<class T, class S>
+inline void
+encode(const PointProperty<T, S>& property, unsigned char* data, const Layout&)
+    { encodeProperty(property, data); }
+
+template<class T, class S>
+inline void
+encode(const LineProperty<T, S>& property, unsigned char* data, const Layout&)
+    { encodeProperty(property, data); }
+
+template<class T, class S>
+inline void
+encode(const TriangleProperty<T, S>& property, unsigned char* data, const Layout&)
+    { encodeProperty(property, data); }
+
+template<class T, class S>
+inline void
+encode(const Point<T, S>& point, unsigned char* data, const Layout& layout) {
+    for(std::size_t j = 0; j < 3; ++j) {
+        storeFloat(data + j * layout.valueSize_, point[j], layout.valueSize_);
+    }
+    storeUnsigned(data + layout.pointPropertyIndexOffset_, point.propertyIndex(), layout.indexSize_);
+}
+
+template<class T, class S>
+inline void
+encode(const Line<T, S>& line, unsigned char* data, const Layout& layout) {
+    storeUnsigned(data, line.pointIndex(0), layout.indexSize_);
+    storeUnsigned(data + layout.indexSize_, line.pointIndex(1), layout.indexSize_);
+    storeUnsigned(data + 2 * layout.indexSize_, line.propertyIndex(), layout.indexSize_);
+}
+
+template<class T, class S>
+inline void
+encode(const Triangle<T, S>& triangle, unsigned char* data, const Layout& layout) {
+    for(std::size_t j = 0; j < 3; ++j) {
+        storeUnsigned(data + j * layout.indexSize_, triangle.pointIndex(j), layout.indexSize_);
+    }
+    storeUnsigned(data + 3 * layout.indexSize_, triangle.propertyIndex(), layout.indexSize_);
+}
+
+template<class T, class S>
+inline void
+decode(const unsigned char* data, const Layout&, PointProperty<T, S>& property)
+    { decodeProperty(data, property); }
+
+template<class T, class S>
+inline void
+decode(const unsigned char* data, const Layout&, LineProperty<T, S>& property)
+    { decodeProperty(data, property); }
+
+template<class T, class S>
+inline void
+decode(const unsigned char* data, const Layout&, TriangleProperty<T, S>& property)
+    { decodeProperty(data, property); }
+
+template<class T, class S>
+inline void
+decode(const unsigned char* data, const Layout& layout, Point<T, S>& point) {
+    point = Point<T, S>(
+        loadFloat<T>(data, layout.valueSize_),
+        loadFloat<T>(data + layout.valueSize_, layout.valueSize_),
+        loadFloat<T>(data + 2 * layout.valueSize_, layout.valueSize_),
+        static_cast<S>(loadUnsigned(data + layout.pointPropertyIndexOffset_, layout.indexSize_))
+    );
+}
+
+template<class T, class S>
+inline void
+decode(const unsigned char* data, const Layout& layout, Line<T, S>& line) {
+    line = Line<T, S>(
+        static_cast<S>(loadUnsigned(data, layout.indexSize_)),
+        static_cast<S>(loadUnsigned(data + layout.indexSize_, layout.indexSize_)),
+        static_cast<S>(loadUnsigned(data + 2 * layout.indexSize_, layout.indexSize_))
+    );
+}
+
+template<class T, class S>
+inline void
+decode(const unsigned char* data, const Layout& layout, Triangle<T, S>& triangle) {
+    triangle = Triangle<T, S>(
+        static_cast<S>(loadUnsigned(data, layout.indexSize_)),
+        static_cast<S>(loadUnsigned(data + layout.indexSize_, layout.indexSize_)),
+        static_cast<S>(loadUnsigned(data + 2 * layout.indexSize_, layout.indexSize_)),
+        static_cast<S>(loadUnsigned(data + 3 * layout.indexSize_, layout.indexSize_))
+    );
+}
+
+/// Header of a file.
+///
+struct Header {
+    Header(const std::size_t valueSize = 4, const std::size_t indexSize = 8)
+        :   valueSize_(valueSize),
+            indexSize_(indexSize)
+        {
+            const Layout layout(valueSize, indexSize);
+            for(std::size_t j = 0; j < NumberOfSections; ++j) {
+                offset_[j] = headerSize;
+                numberOfRecords_[j] = 0;
+                recordSize_[j] = layout.recordSize_[j];
+            }
+        }
+    void write(unsigned char* data) const;
+    void read(const unsigned char* data, const std::size_t fileSize);
+
+    std::size_t valueSize_;
+    std::size_t indexSize_;
+    std::uint64_t offset_[NumberOfSections];
+    std::uint64_t numberOfRecords_[NumberOfSections];
+    std::uint64_t recordSize_[NumberOfSections];
+};
+
+inline void
+Header::write(
+    unsigned char* data
+) const {
+    std::fill(data, data + headerSize, 0);
+    std::copy(magic, magic + 8, data);
+    storeUnsigned(data + 8, version, 4);
+    storeUnsigned(data + 12, headerSize, 4);
+    data[16] = static_cast<unsigned char>(valueSize_);
+    data[17] = static_cast<unsigned char>(indexSize_);
+    storeUnsigned(data + 20, sectionAlignment, 4);
+    for(std::size_t j = 0; j < NumberOfSections; ++j) {
+        storeUnsigned(data + 24 + 24 * j, offset_[j], 8);
+        storeUnsigned(data + 32 + 24 * j, numberOfRecords_[j], 8);
+        storeUnsigned(data + 40 + 24 * j, recordSize_[j], 8);
+    }
+}
+
+/// Read and validate a header.
+///
+/// \param data Beginning of the file.
+/// \param fileSize Size of the file in bytes.
+///
+inline void
+Header::read(
+    const unsigned char* data,
+    const std::size_t fileSize
+) {
+    if(fileSize < 16 || !std::equal(magic, magic + 8, data)) {
+        throw std::runtime_error("not a binary graphics file.");
+    }
+    if(loadUnsigned(data + 8, 4) != version) {
+        throw std::runtime_error("binary graphics file of unsupported version.");
+    }
+    const std::uint64_t size = loadUnsigned(data + 12, 4);
+    if(size < headerSize || size > fileSize) {
+        throw std::runtime_error("binary graphics file with a truncated header.");
+    }
+    valueSize_ = data[16];
+    indexSize_ = data[17];
+    if((valueSize_ != 4 && valueSize_ != 8)
+    || (indexSize_ != 1 && indexSize_ != 2 && indexSize_ != 4 && indexSize_ != 8)) {
+        throw std::runtime_error("binary graphics file with unsupported types.");
+    }
+    const Layout layout(valueSize_, indexSize_);
+    for(std::size_t j = 0; j < NumberOfSections; ++j) {
+        offset_[j] = loadUnsigned(data + 24 + 24 * j, 8);
+        numberOfRecords_[j] = loadUnsigned(data + 32 + 24 * j, 8);
+        recordSize_[j] = loadUnsigned(data + 40 + 24 * j, 8);
+        if(recordSize_[j] != layout.recordSize_[j]) {
+            throw std::runtime_error("binary graphics file with an unsupported record layout.");
+        }
+        if(offset_[j] < size || offset_[j] > fileSize
+        || offset_[j] % std::max(layout.valueSize_, layout.indexSize_) != 0
+        || numberOfRecords_[j] > (fileSize - offset_[j]) / recordSize_[j]) {
+            throw std::runtime_error("binary graphics file is truncated or corrupt.");
+        }
+    }
+}
+
+/// Read-only memory mapping of a file (POSIX).
+///
+class MappedFile {
+public:
+    MappedFile()
+        : data_(0), size_(0)
+        {}
+    explicit MappedFile(const std::string& fileName)
+        : data_(0), size_(0)
+        { open(fileName); }
+    MappedFile(MappedFile&& other)
+        : data_(other.data_), size_(other.size_)
+        { other.data_ = 0; other.size_ = 0; }
+    MappedFile& operator=(MappedFile&& other)
+        {
+            if(this != &other) {
+                close();
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+            }
+            return *this;
+        }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile()
+        { close(); }
+    void open(const std::string&);
+    void close();
+    const unsigned char* data() const
+        { return static_cast<const unsigned char*>(data_); }
+    std::size_t size() const
+        { return size_; }
+
+private:
+    void* data_;
+    std::size_t size_;
+};
+
+inline void
+MappedFile::open(
+    const std::string& fileName
+) {
+    close();
+    const int descriptor = ::open(fileName.c_str(), O_RDONLY);
+    if(descriptor == -1) {
+        throw std::runtime_error("could not open " + fileName + ".");
+    }
+    struct stat status;
+    if(::fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        ::close(descriptor);
+        throw std::runtime_error("could not map " + fileName + " to memory.");
+    }
+    void* data = ::mmap(0, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor); // the mapping remains valid
+    if(data == MAP_FAILED) {
+        throw std::runtime_error("could not map " + fileName + " to memory.");
+    }
+    data_ = data;
+    size_ = static_cast<std::size_t>(status.st_size);
+}
+
+inline void
+MappedFile::close() {
+    if(data_ != 0) {
+        ::munmap(data_, size_);
+        data_ = 0;
+        size_ = 0;
+    }
+}
+
+} // namespace detail
+
+/// Read-only array of elements that are stored elsewhere.
+///
+template<class E>
+class ArrayView {
+public:
+    typedef E value_type;
+    typedef const E* const_iterator;
+
+    ArrayView()
+        : data_(0), size_(0)
+        {}
+    ArrayView(const E* data, const std::size_t size)
+        : data_(data), size_(size)
+        {}
+    std::size_t size() const
+        { return size_; }
+    bool empty() const
+        { return size_ == 0; }
+    const E& operator[](const std::size_t j) const
+        { assert(j < size_); return data_[j]; }
+    const E* data() const
+        { return data_; }
+    const_iterator begin() const
+        { return data_; }
+    const_iterator end() const
+        { return data_ + size_; }
+
+private:
+    const E* data_;
+    std::size_t size_;
+};
+
+/// Read-only graphics in a memory-mapped binary file.
+///
+/// Opening a file reads only its header. Points, lines, triangles and
+/// properties are accessed in place and paged in by the operating system
+/// when they are first touched, so opening takes constant time and memory
+/// regardless of the size of the file. The interface is the read-only
+/// part of that of Graphics, with ArrayView in place of vectors.
+///
+/// The file must have been written for the sizes of T and S, and the
+/// machine must be little-endian, see isMemoryLayout(); otherwise open()
+/// throws and the file can still be read by load(). Indices in the file
+/// are not validated, as that would read the whole file.
+///
+template<class T = float, class S = std::size_t>
+class MappedGraphics {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef Point<value_type, size_type> PointType;
+    typedef PointProperty<value_type, size_type> PointPropertyType;
+    typedef Line<value_type, size_type> LineType;
+    typedef LineProperty<value_type, size_type> LinePropertyType;
+    typedef Triangle<value_type, size_type> TriangleType;
+    typedef TriangleProperty<value_type, size_type> TrianglePropertyType;
+    typedef ArrayView<PointType> PointsVector;
+    typedef ArrayView<PointPropertyType> PointPropertiesVector;
+    typedef ArrayView<LineType> LinesVector;
+    typedef ArrayView<LinePropertyType> LinePropertiesVector;
+    typedef ArrayView<TriangleType> TrianglesVector;
+    typedef ArrayView<TrianglePropertyType> TrianglePropertiesVector;
+
+    MappedGraphics();
+    explicit MappedGraphics(const std::string&);
+    void open(const std::string&);
+    void close();
+
+    const size_type numberOfPoints() const
+        { return points_.size(); }
+    const size_type numberOfLines() const
+        { return lines_.size(); }
+    const size_type numberOfTriangles() const
+        { return triangles_.size(); }
+    const size_type numberOfPointProperties() const
+        { return pointProperties_.size(); }
+    const size_type numberOfLineProperties() const
+        { return lineProperties_.size(); }
+    const size_type numberOfTriangleProperties() const
+        { return triangleProperties_.size(); }
+    const PointType& point(const size_type j) const
+        { return points_[j]; }
+    const LineType& line(const size_type j) const
+        { return lines_[j]; }
+    const TriangleType& triangle(const size_type j) const
+        { return triangles_[j]; }
+    const PointPropertyType& pointProperty(const size_type j) const
+        { return pointProperties_[j]; }
+    const LinePropertyType& lineProperty(const size_type j) const
+        { return lineProperties_[j]; }
+    const TrianglePropertyType& triangleProperty(const size_type j) const
+        { return triangleProperties_[j]; }
+    const PointsVector& points() const
+        { return points_; }
+    const LinesVector& lines() const
+        { return lines_; }
+    const TrianglesVector& triangles() const
+        { return triangles_; }
+    const PointPropertiesVector& pointProperties() const
+        { return pointProperties_; }
+    const LinePropertiesVector& lineProperties() const
+        { return lineProperties_; }
+    const TrianglePropertiesVector& triangleProperties() const
+        { return triangleProperties_; }
+
+private:
+    template<class E>
+    ArrayView<E> section(const detail::Header&, const detail::Section) const;
+
+    detail::MappedFile file_;
+    PointsVector points_;
+    LinesVector lines_;
+    TrianglesVector triangles_;
+    PointPropertiesVector pointProperties_;
+    LinePropertiesVector lineProperties_;
+    TrianglePropertiesVector triangleProperties_;
+};
+
+template<class T, class S>
+inline
+MappedGraphics<T, S>::MappedGraphics()
+:   file_(),
+    points_(),
+    lines_(),
+    triangles_(),
+    pointProperties_(),
+    lineProperties_(),
+    triangleProperties_()
+{}
+
+template<class T, class S>
+inline
+MappedGraphics<T, S>::MappedGraphics(
+    const std::string& fileName
+)
+:   MappedGraphics()
+{
+    open(fileName);
+}
+
+/// Map a binary graphics file to memory.
+///
+/// \param fileName Name of the file.
+///
+template<class T, class S>
+inline void
+MappedGraphics<T, S>::open(
+    const std::string& fileName
+) {
+    close();
+    detail::MappedFile file(fileName);
+    detail::Header header;
+    header.read(file.data(), file.size());
+    if(!detail::isMemoryLayout<T, S>(detail::Layout(header.valueSize_, header.indexSize_))) {
+        throw std::runtime_error("the layout of " + fileName
+            + " is not the memory layout of this graphics type. use binary::load() instead.");
+    }
+    file_ = std::move(file);
+    pointProperties_ = section<PointPropertyType>(header, detail::PointPropertiesSection);
+    points_ = section<PointType>(header, detail::PointsSection);
+    lineProperties_ = section<LinePropertyType>(header, detail::LinePropertiesSection);
+    lines_ = section<LineType>(header, detail::LinesSection);
+    triangleProperties_ = section<TrianglePropertyType>(header, detail::TrianglePropertiesSection);
+    triangles_ = section<TriangleType>(header, detail::TrianglesSection);
+}
+
+/// Unmap the file. All references to its elements become invalid.
+///
+template<class T, class S>
+inline void
+MappedGraphics<T, S>::close() {
+    points_ = PointsVector();
+    lines_ = LinesVector();
+    triangles_ = TrianglesVector();
+    pointProperties_ = PointPropertiesVector();
+    lineProperties_ = LinePropertiesVector();
+    triangleProperties_ = TrianglePropertiesVector();
+    file_.close();
+}
+
+template<class T, class S>
+template<class E>
+inline ArrayView<E>
+MappedGraphics<T, S>::section(
+    const detail::Header& header,
+    const detail::Section section
+) const {
+    return ArrayView<E>(
+        reinterpret_cast<const E*>(file_.data() + header.offset_[section]),
+        static_cast<std::size_t>(header.numberOfRecords_[section])
+    );
+}
+
+/// Writer of binary graphics files, section by section.
+///
+/// The sections are written by calls of pointProperties(), points(),
+/// lineProperties(), lines(), triangleProperties() and triangles() in this
+/// order, each of which may be omitted, and points, lines and triangles
+/// may be written in consecutive batches. This is the interface of the
+/// visitors of hdf5::visit(), so that HDF5 files can be converted with
+/// memory bounded by the batch size. close() completes the file.
+///
+template<class T = float, class S = std::size_t>
+class Writer {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef Graphics<value_type, size_type> GraphicsType;
+    typedef typename GraphicsType::PointsVector PointsVector;
+    typedef typename GraphicsType::PointPropertiesVector PointPropertiesVector;
+    typedef typename GraphicsType::LinesVector LinesVector;
+    typedef typename GraphicsType::LinePropertiesVector LinePropertiesVector;
+    typedef typename GraphicsType::TrianglesVector TrianglesVector;
+    typedef typename GraphicsType::TrianglePropertiesVector TrianglePropertiesVector;
+
+    explicit Writer(const std::string&);
+    ~Writer();
+    void pointProperties(const PointPropertiesVector& properties)
+        { write(detail::PointPropertiesSection, properties, 0); }
+    void points(const PointsVector& batch, const std::size_t offset = 0)
+        { write(detail::PointsSection, batch, offset); }
+    void lineProperties(const LinePropertiesVector& properties)
+        { write(detail::LinePropertiesSection, properties, 0); }
+    void lines(const LinesVector& batch, const std::size_t offset = 0)
+        { write(detail::LinesSection, batch, offset); }
+    void triangleProperties(const TrianglePropertiesVector& properties)
+        { write(detail::TrianglePropertiesSection, properties, 0); }
+    void triangles(const TrianglesVector& batch, const std::size_t offset = 0)
+        { write(detail::TrianglesSection, batch, offset); }
+    std::size_t close();
+
+private:
+    template<class VECTOR>
+    void write(const detail::Section, const VECTOR&, const std::size_t);
+    void beginSection(const std::size_t);
+
+    std::string fileName_;
+    std::ofstream file_;
+    detail::Header header_;
+    detail::Layout layout_;
+    bool isMemoryLayout_;
+    std::size_t section_; // section being written, all before are complete
+    std::uint64_t position_;
+    std::vector<unsigned char> buffer_;
+};
+
+/// Create a binary graphics file.
+///
+/// \param fileName Name of the file.
+///
+template<class T, class S>
+inline
+Writer<T, S>::Writer(
+    const std::string& fileName
+)
+:   fileName_(fileName),
+    file_(fileName.c_str(), std::ios::binary),
+    header_(sizeof(T), sizeof(S)),
+    layout_(sizeof(T), sizeof(S)),
+    isMemoryLayout_(detail::isMemoryLayout<T, S>(layout_)),
+    section_(0),
+    position_(detail::headerSize),
+    buffer_(detail::headerSize)
+{
+    static_assert(std::is_floating_point<T>::value && std::is_unsigned<S>::value,
+        "binary graphics files store floating point coordinates and unsigned indices.");
+    if(!file_) {
+        throw std::runtime_error("could not open " + fileName + " for writing.");
+    }
+    file_.write(reinterpret_cast<const char*>(&buffer_[0]), detail::headerSize); // written in close()
+}
+
+/// Complete the file if close() has not been called.
+///
+template<class T, class S>
+inline
+Writer<T, S>::~Writer() {
+    try {
+        close();
+    }
+    catch(...) {
+    }
+}
+
+template<class T, class S>
+inline void
+Writer<T, S>::beginSection(
+    const std::size_t section
+) {
+    for(; section_ < section; ++section_) {
+        const std::uint64_t next = detail::roundUp(position_, detail::sectionAlignment);
+        std::fill(buffer_.begin(), buffer_.end(), 0);
+        file_.write(reinterpret_cast<const char*>(&buffer_[0]), next - position_);
+        position_ = next;
+        header_.offset_[section_ + 1] = position_;
+    }
+}
+
+template<class T, class S>
+template<class VECTOR>
+inline void
+Writer<T, S>::write(
+    const detail::Section section,
+    const VECTOR& elements,
+    const std::size_t offset
+) {
+    const std::size_t batchSize = 1 << 16;
+
+    if(!file_.is_open()) {
+        throw std::runtime_error("binary graphics file " + fileName_ + " is closed.");
+    }
+    if(static_cast<std::size_t>(section) < section_) {
+        throw std::runtime_error("sections of binary graphics files must be written in order.");
+    }
+    beginSection(section);
+    if(offset != header_.numberOfRecords_[section]) {
+        throw std::runtime_error("batches of binary graphics files must be written consecutively.");
+    }
+    const std::size_t recordSize = layout_.recordSize_[section];
+    buffer_.resize(batchSize * recordSize);
+    for(std::size_t begin = 0; begin < elements.size(); begin += batchSize) {
+        const std::size_t end = std::min(begin + batchSize, elements.size());
+        if(isMemoryLayout_) {
+            // copy records and clear the padding of points
+            std::memcpy(&buffer_[0], static_cast<const void*>(&elements[begin]), (end - begin) * recordSize);
+            if(section == detail::PointsSection) {
+                const std::size_t paddingBegin = 3 * layout_.valueSize_;
+                const std::size_t paddingEnd = layout_.pointPropertyIndexOffset_ + layout_.indexSize_;
+                for(std::size_t j = 0; j < end - begin; ++j) {
+                    unsigned char* record = &buffer_[j * recordSize];
+                    std::fill(record + paddingBegin, record + layout_.pointPropertyIndexOffset_, 0);
+                    std::fill(record + paddingEnd, record + recordSize, 0);
+                }
+            }
+        }
+        else {
+            std::fill(buffer_.begin(), buffer_.begin() + (end - begin) * recordSize, 0);
+            for(std::size_t j = begin; j < end; ++j) {
+                detail::encode(elements[j], &buffer_[(j - begin) * recordSize], layout_);
+            }
+        }
+        file_.write(reinterpret_cast<const char*>(&buffer_[0]), (end - begin) * recordSize);
+    }
+    header_.numberOfRecords_[section] += elements.size();
+    position_ += elements.size() * recordSize;
+}
+
+/// Complete the file by writing its header, and close it.
+///
+/// \returns Size of the file in bytes.
+///
+template<class T, class S>
+inline std::size_t
+Writer<T, S>::close() {
+    if(!file_.is_open()) {
+        return 0;
+    }
+    beginSection(detail::NumberOfSections - 1);
+    header_.write(&buffer_[0]);
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&buffer_[0]), detail::headerSize);
+    file_.close();
+    if(!file_) {
+        throw std::runtime_error("could not write " + fileName_ + ".");
+    }
+    return static_cast<std::size_t>(position_);
+}
+
+/// Save a graphics as a binary file.
+///
+/// \param fileName Name of the file.
+/// \param graphics Graphics.
+/// \returns Size of the file in bytes.
+///
+template<class T, class S>
+inline std::size_t
+save(
+    const std::string& fileName,
+    const Graphics<T, S>& graphics
+) {
+    Writer<T, S> writer(fileName);
+    writer.pointProperties(graphics.pointProperties());
+    writer.points(graphics.points());
+    writer.lineProperties(graphics.lineProperties());
+    writer.lines(graphics.lines());
+    writer.triangleProperties(graphics.triangleProperties());
+    writer.triangles(graphics.triangles());
+    return writer.close();
+}
+
+namespace detail {
+
+/// Read the records of a section into a vector, converting them if the
+/// file layout is not the memory layout.
+///
+template<class VECTOR>
+inline void
+readSection(
+    const MappedFile& file,
+    const Header& header,
+    const Section section,
+    const bool isMemoryLayout,
+    VECTOR& elements,
+    const ParallelOptions& parallelOptions
+) {
+    const Layout layout(header.valueSize_, header.indexSize_);
+    const std::size_t recordSize = layout.recordSize_[section];
+    const unsigned char* data = file.data() + header.offset_[section];
+    const std::size_t size = static_cast<std::size_t>(header.numberOfRecords_[section]);
+    if(isMemoryLayout && numberOfBlocks(size, parallelOptions) == 1) {
+        typedef typename VECTOR::value_type value_type;
+        elements.assign(reinterpret_cast<const value_type*>(data), reinterpret_cast<const value_type*>(data) + size);
+        return;
+    }
+    elements.resize(size);
+    parallelFor(elements.size(), parallelOptions, [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+        if(begin == end) {
+            return;
+        }
+        if(isMemoryLayout) {
+            std::memcpy(static_cast<void*>(elements.data() + begin), data + begin * recordSize, (end - begin) * recordSize);
+        }
+        else {
+            for(std::size_t j = begin; j < end; ++j) {
+                decode(data + j * recordSize, layout, elements[j]);
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+/// Load a graphics from a binary file.
+///
+/// Files in the memory layout of Graphics<T, S> are copied in parallel,
+/// all other files are converted.
+///
+/// \param fileName Name of the file.
+/// \param graphics Graphics.
+/// \param parallelOptions Options of the parallel copy or conversion.
+///
+template<class T, class S>
+inline void
+load(
+    const std::string& fileName,
+    Graphics<T, S>& graphics,
+    const ParallelOptions& parallelOptions = ParallelOptions()
+) {
+    typedef Graphics<T, S> GraphicsType;
+
+    const detail::MappedFile file(fileName);
+    detail::Header header;
+    header.read(file.data(), file.size());
+    const bool isMemoryLayout = detail::isMemoryLayout<T, S>(detail::Layout(header.valueSize_, header.indexSize_));
+
+    typename GraphicsType::PointPropertiesVector pointProperties;
+    typename GraphicsType::PointsVector points;
+    typename GraphicsType::LinePropertiesVector lineProperties;
+    typename GraphicsType::LinesVector lines;
+    typename GraphicsType::TrianglePropertiesVector triangleProperties;
+    typename GraphicsType::TrianglesVector triangles;
+    detail::readSection(file, header, detail::PointPropertiesSection, isMemoryLayout, pointProperties, parallelOptions);
+    detail::readSection(file, header, detail::PointsSection, isMemoryLayout, points, parallelOptions);
+    detail::readSection(file, header, detail::LinePropertiesSection, isMemoryLayout, lineProperties, parallelOptions);
+    detail::readSection(file, header, detail::LinesSection, isMemoryLayout, lines, parallelOptions);
+    detail::readSection(file, header, detail::TrianglePropertiesSection, isMemoryLayout, triangleProperties, parallelOptions);
+    detail::readSection(file, header, detail::TrianglesSection, isMemoryLayout, triangles, parallelOptions);
+    graphics.assign(std::move(pointProperties), std::move(points),
+        std::move(lineProperties), std::move(lines),
+        std::move(triangleProperties), std::move(triangles));
+}
+
+/// Whether a file begins with the magic number of binary graphics files.
+///
+inline bool
+isBinaryFile(
+    const std::string& fileName
+) {
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    unsigned char data[8];
+    return file.read(reinterpret_cast<char*>(data), 8)
+        && std::equal(detail::magic, detail::magic + 8, data);
+}
+
+} // namespace binary
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_GRAPHICS_BINARY_HXX
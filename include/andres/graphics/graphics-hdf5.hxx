@@ -2,9 +2,25 @@
 #ifndef ANDRES_GRAPHICS_HDF5_GRAPHICS_HDF5_HXX
 #define ANDRES_GRAPHICS_HDF5_GRAPHICS_HDF5_HXX
 
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "hdf5.h"
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+#include "zlib.h"
+#endif
 
 #include "andres/graphics/graphics.hxx"
+#include "andres/graphics/graphics-soa.hxx"
+#include "andres/graphics/instrumentation.hxx"
+#include "andres/graphics/parallel.hxx"
+#include "andres/graphics/quantization.hxx"
 
 namespace andres {
 namespace graphics {
@@ -157,42 +173,585 @@ closeGroup(
     H5Gclose(handle);
 }
 
-/// Save a vector to an HDF5 dataset.
+/// Layout and compression of the datasets written by save().
+///
+/// The default is the contiguous, uncompressed layout of earlier versions.
+/// A chunk size other than zero selects the chunked layout, which is
+/// required for compression. Files written with any options are readable
+/// by load().
+///
+struct SaveOptions {
+    /// \param chunkSize Number of elements per chunk (0 for a contiguous layout).
+    /// \param compressionLevel Deflate (zlib) compression level from 0 (no compression) to 9.
+    /// \param shuffle Apply the shuffle filter before compression.
+    /// \param compactTypes Store point and property indices of points, lines
+    ///     and triangles as the narrowest unsigned integers that can hold
+    ///     them, in packed compound types.
+    /// \param quantize Store point coordinates as 16-bit integers relative
+    ///     to the bounding box of the graphics (implies compactTypes).
+    ///
+    SaveOptions(
+        const hsize_t chunkSize = 0,
+        const unsigned int compressionLevel = 0,
+        const bool shuffle = true,
+        const bool compactTypes = false,
+        const bool quantize = false
+    )
+        :   chunkSize_(chunkSize),
+            compressionLevel_(compressionLevel),
+            shuffle_(shuffle),
+            compactTypes_(compactTypes || quantize),
+            quantize_(quantize)
+        {}
+
+    /// Chunked layout with shuffle and deflate compression.
+    static SaveOptions compressed(
+        const hsize_t chunkSize = 1 << 16,
+        const unsigned int compressionLevel = 4
+    )
+        { return SaveOptions(chunkSize, compressionLevel, true); }
+
+    hsize_t chunkSize_;
+    unsigned int compressionLevel_;
+    bool shuffle_;
+    bool compactTypes_;
+    bool quantize_;
+};
+
+namespace detail {
+
+/// Create a one-dimensional dataset of the given file type and write data
+/// of the given memory type to it.
 ///
-template<class T>
 inline void
 save(
     const hid_t parentHandle,
-    const std::string datasetName,
-    const std::vector<T>& data
+    const std::string& datasetName,
+    const void* data,
+    const hsize_t size,
+    const hid_t typeMemory,
+    const hid_t typeFile,
+    const SaveOptions& saveOptions
 ) {
-    hsize_t shape[] = {data.size()};
+    hsize_t shape[] = {size};
     hid_t dataspace = H5Screate_simple(1, shape, NULL);
     if(dataspace < 0) {
         throw std::runtime_error("could not create HDF5 dataspace.");
     }
-    HDF5Type<T> typeMemory;
-    hid_t dataset = H5Dcreate(parentHandle, datasetName.c_str(), typeMemory.type(), dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    // chunked layout and filters
+    hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+    if(saveOptions.chunkSize_ != 0 && size != 0) {
+        hsize_t chunkShape[] = {std::min<hsize_t>(saveOptions.chunkSize_, size)};
+        herr_t status = H5Pset_chunk(properties, 1, chunkShape);
+        if(status >= 0 && saveOptions.shuffle_ && saveOptions.compressionLevel_ != 0) {
+            status = H5Pset_shuffle(properties);
+        }
+        if(status >= 0 && saveOptions.compressionLevel_ != 0) {
+            if(H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) {
+                H5Pclose(properties);
+                H5Sclose(dataspace);
+                throw std::runtime_error("HDF5 deflate filter not available.");
+            }
+            status = H5Pset_deflate(properties, saveOptions.compressionLevel_);
+        }
+        if(status < 0) {
+            H5Pclose(properties);
+            H5Sclose(dataspace);
+            throw std::runtime_error("could not set HDF5 dataset layout.");
+        }
+    }
+
+    hid_t dataset = H5Dcreate(parentHandle, datasetName.c_str(), typeFile, dataspace, H5P_DEFAULT, properties, H5P_DEFAULT);
+    H5Pclose(properties);
     if(dataset < 0) {
         H5Sclose(dataspace);
         throw std::runtime_error("could not create HDF5 dataset.");
     }
-    hid_t status = H5Dwrite(dataset, typeMemory.type(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+    hid_t status = H5Dwrite(dataset, typeMemory, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    H5Dclose(dataset);
+    H5Sclose(dataspace);
     if(status < 0) {
-        H5Dclose(dataset);
-        H5Sclose(dataspace);
         throw std::runtime_error("could not write to HDF5 dataset.");
     }
 }
 
+} // namespace detail
+
+/// Save a vector to an HDF5 dataset.
+///
+template<class T>
+inline void
+save(
+    const hid_t parentHandle,
+    const std::string datasetName,
+    const std::vector<T>& data,
+    const SaveOptions& saveOptions = SaveOptions()
+) {
+    HDF5Type<T> typeMemory;
+    detail::save(parentHandle, datasetName, data.data(), data.size(), typeMemory.type(), typeMemory.type(), saveOptions);
+}
+
+namespace detail {
+
+/// Read the elements [offset, offset + size) of a one-dimensional dataset.
+///
+inline herr_t
+readHyperslab(
+    const hid_t dataset,
+    const hid_t filespace,
+    const hsize_t offset,
+    const hsize_t size,
+    const hid_t typeMemory,
+    void* data
+) {
+    hsize_t shape[] = {size};
+    hsize_t start[] = {offset};
+    hid_t memspace = H5Screate_simple(1, shape, NULL);
+    herr_t status = H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, shape, NULL);
+    if(status >= 0) {
+        status = H5Dread(dataset, typeMemory, memspace, filespace, H5P_DEFAULT, data);
+    }
+    H5Sclose(memspace);
+    return status;
+}
+
+/// Complete descriptions of the compound types of points, lines and
+/// triangles.
+///
+/// For compatibility with existing files, HDF5Type describes only the first
+/// element of the array members of points, lines and triangles; all other
+/// elements are transferred only if file and memory type are identical.
+/// Reading datasets of other types (e.g. written with another index type)
+/// requires the complete types defined by the specializations of this
+/// class template.
+///
+template<class T>
+struct ElementType {
+    static hid_t createCompleteMemoryType()
+        { return -1; }
+    static hid_t createCompleteFileType(const hid_t)
+        { return -1; }
+};
+
+/// Copy of a compound type in which the member with the given name is
+/// replaced by an array of size elements of the member's type.
+///
+inline hid_t
+createArrayMemberType(
+    const hid_t type,
+    const std::string& name,
+    const hsize_t size
+) {
+    hid_t result = H5Tcreate(H5T_COMPOUND, H5Tget_size(type));
+    const int numberOfMembers = H5Tget_nmembers(type);
+    for(int j = 0; j < numberOfMembers; ++j) {
+        char* memberName = H5Tget_member_name(type, j);
+        hid_t memberType = H5Tget_member_type(type, j);
+        if(name == memberName && H5Tget_class(memberType) != H5T_ARRAY) {
+            hsize_t shape[] = {size};
+            hid_t arrayType = H5Tarray_create(memberType, 1, shape);
+            H5Tinsert(result, memberName, H5Tget_member_offset(type, j), arrayType);
+            H5Tclose(arrayType);
+        }
+        else {
+            H5Tinsert(result, memberName, H5Tget_member_offset(type, j), memberType);
+        }
+        H5Tclose(memberType);
+        H5free_memory(memberName);
+    }
+    return result;
+}
+
+/// Conversion between compound types whose members are little-endian
+/// unsigned integers, floating point numbers or arrays thereof, as written
+/// by save(), that widens integers member by member.
+///
+/// HDF5's generic conversion of compound types with array members is
+/// slow; this class is used instead wherever it applies.
+///
+class CompoundConversion {
+public:
+    CompoundConversion(const hid_t, const hid_t);
+    bool valid() const
+        { return valid_; }
+    std::size_t sourceSize() const
+        { return sourceSize_; }
+    void operator()(const unsigned char*, unsigned char*, const std::size_t) const;
+
+private:
+    struct Member {
+        std::size_t sourceOffset;
+        std::size_t targetOffset;
+        std::size_t sourceSize;
+        std::size_t targetSize;
+        std::size_t count;
+        bool copy;
+    };
+
+    static bool describe(const hid_t, std::size_t&, std::size_t&, bool&);
+
+    std::vector<Member> members_;
+    std::size_t sourceSize_;
+    std::size_t targetSize_;
+    bool valid_;
+};
+
+/// Size, number of elements and class (integer or not) of a member type.
+///
+inline bool
+CompoundConversion::describe(
+    const hid_t type,
+    std::size_t& size,
+    std::size_t& count,
+    bool& integer
+) {
+    hid_t baseType = type;
+    count = 1;
+    if(H5Tget_class(type) == H5T_ARRAY) {
+        if(H5Tget_array_ndims(type) != 1) {
+            return false;
+        }
+        hsize_t shape[1];
+        H5Tget_array_dims2(type, shape);
+        count = static_cast<std::size_t>(shape[0]);
+        baseType = H5Tget_super(type);
+    }
+    const H5T_class_t typeClass = H5Tget_class(baseType);
+    size = H5Tget_size(baseType);
+    integer = typeClass == H5T_INTEGER;
+    bool result = H5Tget_order(baseType) == H5T_ORDER_LE
+        && (typeClass == H5T_FLOAT
+            || (integer && H5Tget_sign(baseType) == H5T_SGN_NONE && size <= 8));
+    if(baseType != type) {
+        H5Tclose(baseType);
+    }
+    return result;
+}
+
+inline
+CompoundConversion::CompoundConversion(
+    const hid_t typeSource,
+    const hid_t typeTarget
+)
+:   members_(),
+    sourceSize_(H5Tget_size(typeSource)),
+    targetSize_(H5Tget_size(typeTarget)),
+    valid_(false)
+{
+    union { std::uint16_t value; unsigned char bytes[2]; } endianness = {1};
+    if(endianness.bytes[0] != 1
+    || H5Tget_class(typeSource) != H5T_COMPOUND
+    || H5Tget_class(typeTarget) != H5T_COMPOUND) {
+        return;
+    }
+    const int numberOfMembers = H5Tget_nmembers(typeTarget);
+    valid_ = true;
+    for(int j = 0; valid_ && j < numberOfMembers; ++j) {
+        char* name = H5Tget_member_name(typeTarget, j);
+        const int sourceIndex = H5Tget_member_index(typeSource, name);
+        H5free_memory(name);
+        if(sourceIndex < 0) {
+            valid_ = false;
+            break;
+        }
+        hid_t memberTarget = H5Tget_member_type(typeTarget, j);
+        hid_t memberSource = H5Tget_member_type(typeSource, static_cast<unsigned>(sourceIndex));
+        Member member;
+        member.sourceOffset = H5Tget_member_offset(typeSource, static_cast<unsigned>(sourceIndex));
+        member.targetOffset = H5Tget_member_offset(typeTarget, j);
+        member.sourceSize = 0;
+        member.targetSize = 0;
+        std::size_t countSource = 0;
+        bool integerSource = false;
+        bool integerTarget = false;
+        valid_ = describe(memberSource, member.sourceSize, countSource, integerSource)
+            && describe(memberTarget, member.targetSize, member.count, integerTarget)
+            && countSource == member.count
+            && (integerSource && integerTarget
+                ? member.sourceSize <= member.targetSize
+                : H5Tequal(memberSource, memberTarget) > 0);
+        member.copy = member.sourceSize == member.targetSize;
+        members_.push_back(member);
+        H5Tclose(memberSource);
+        H5Tclose(memberTarget);
+    }
+}
+
+/// Convert size elements from source to target.
+///
+inline void
+CompoundConversion::operator()(
+    const unsigned char* source,
+    unsigned char* target,
+    const std::size_t size
+) const {
+    assert(valid_);
+    for(std::size_t j = 0; j < size; ++j) {
+        const unsigned char* s = source + j * sourceSize_;
+        unsigned char* t = target + j * targetSize_;
+        for(std::size_t m = 0; m < members_.size(); ++m) {
+            const Member& member = members_[m];
+            if(member.copy) {
+                std::copy(s + member.sourceOffset, s + member.sourceOffset + member.count * member.sourceSize, t + member.targetOffset);
+            }
+            else {
+                // little-endian unsigned integers are widened by zero-padding
+                for(std::size_t k = 0; k < member.count; ++k) {
+                    const unsigned char* from = s + member.sourceOffset + k * member.sourceSize;
+                    unsigned char* to = t + member.targetOffset + k * member.targetSize;
+                    std::copy(from, from + member.sourceSize, to);
+                    std::fill(to + member.sourceSize, to + member.targetSize, static_cast<unsigned char>(0));
+                }
+            }
+        }
+    }
+}
+
+/// Read the elements [offset, offset + size) of a one-dimensional dataset
+/// of the given file type, converting them if necessary.
+///
+template<class T>
+inline herr_t
+readElements(
+    const hid_t dataset,
+    const hid_t filespace,
+    const hid_t typeFile,
+    const hsize_t offset,
+    const hsize_t size,
+    T* data
+) {
+    HDF5Type<T> typeMemory;
+    if(H5Tequal(typeFile, typeMemory.type()) > 0) {
+        return readHyperslab(dataset, filespace, offset, size, typeMemory.type(), data);
+    }
+    hid_t typeFileComplete = ElementType<T>::createCompleteFileType(typeFile);
+    if(typeFileComplete < 0) {
+        return readHyperslab(dataset, filespace, offset, size, typeMemory.type(), data);
+    }
+    hid_t typeMemoryComplete = ElementType<T>::createCompleteMemoryType();
+    const CompoundConversion conversion(typeFileComplete, typeMemoryComplete);
+    herr_t status = 0;
+    if(!conversion.valid() && H5Tequal(typeFileComplete, typeFile) > 0) {
+        // the file type is complete, HDF5 converts
+        status = readHyperslab(dataset, filespace, offset, size, typeMemoryComplete, data);
+    }
+    else {
+        // read raw elements and convert them by the complete types
+        const std::size_t blockSize = 1 << 16;
+        const std::size_t bytesPerElement = std::max(H5Tget_size(typeFile), sizeof(T));
+        std::vector<unsigned char> buffer(std::min<hsize_t>(size, blockSize) * bytesPerElement);
+        std::vector<unsigned char> background(std::min<hsize_t>(size, blockSize) * sizeof(T)); // compound conversions need one
+        hid_t typeRaw = H5Tcopy(typeFile);
+        for(hsize_t j = 0; status >= 0 && j < size; j += blockSize) {
+            const hsize_t n = std::min<hsize_t>(blockSize, size - j);
+            status = readHyperslab(dataset, filespace, offset + j, n, typeRaw, buffer.data());
+            if(status < 0) {
+                break;
+            }
+            if(conversion.valid()) {
+                conversion(buffer.data(), reinterpret_cast<unsigned char*>(data + j), n);
+            }
+            else {
+                status = H5Tconvert(typeFileComplete, typeMemoryComplete, n, buffer.data(), background.data(), H5P_DEFAULT);
+                if(status >= 0) {
+                    std::copy(buffer.data(), buffer.data() + n * sizeof(T), reinterpret_cast<unsigned char*>(data + j));
+                }
+            }
+        }
+        H5Tclose(typeRaw);
+    }
+    H5Tclose(typeMemoryComplete);
+    H5Tclose(typeFileComplete);
+    return status;
+}
+
+#if defined(ANDRES_GRAPHICS_WITH_ZLIB) && H5_VERSION_GE(1, 10, 3)
+
+/// Filter pipeline of a chunked dataset that readChunksParallel() can decode.
+///
+struct ChunkFilters {
+    ChunkFilters()
+        : shuffle(false), deflate(false), shuffleIndex(0), deflateIndex(0)
+        {}
+
+    bool shuffle;
+    bool deflate;
+    unsigned int shuffleIndex;
+    unsigned int deflateIndex;
+};
+
+/// Decode one raw chunk as read by H5Dread_chunk into data.
+///
+inline bool
+decodeChunk(
+    const std::vector<unsigned char>& raw,
+    const std::uint32_t filterMask,
+    const ChunkFilters& filters,
+    const std::size_t elementSize,
+    const std::size_t chunkSize, // number of elements in a full chunk
+    const std::size_t size, // number of elements to copy
+    std::vector<unsigned char>& buffer,
+    unsigned char* data
+) {
+    const std::size_t bytes = elementSize * chunkSize;
+    const unsigned char* p = raw.data();
+    if(filters.deflate && (filterMask & (1u << filters.deflateIndex)) == 0) {
+        buffer.resize(bytes);
+        uLongf length = static_cast<uLongf>(bytes);
+        if(uncompress(buffer.data(), &length, raw.data(), static_cast<uLong>(raw.size())) != Z_OK
+        || length != bytes) {
+            return false;
+        }
+        p = buffer.data();
+    }
+    else if(raw.size() != bytes) {
+        return false;
+    }
+    if(filters.shuffle && (filterMask & (1u << filters.shuffleIndex)) == 0
+    && elementSize > 1 && chunkSize > 1) {
+        for(std::size_t b = 0; b < elementSize; ++b) {
+            const unsigned char* q = p + b * chunkSize;
+            for(std::size_t j = 0; j < size; ++j) {
+                data[j * elementSize + b] = q[j];
+            }
+        }
+    }
+    else {
+        std::copy(p, p + size * elementSize, data);
+    }
+    return true;
+}
+
+/// Read a chunked dataset by reading raw chunks with H5Dread_chunk in the
+/// calling thread while previously read chunks are decompressed in parallel.
+///
+/// HDF5 serializes all API calls, so decompressing inside H5Dread cannot
+/// use more than one core. Decoding raw chunks outside the library can.
+///
+/// \returns false if the dataset cannot be read this way (other filters,
+///     file type different from the memory type), true otherwise.
+///
+template<class T>
+inline bool
+readChunksParallel(
+    const hid_t dataset,
+    const hid_t filespace,
+    const hid_t typeFile,
+    const hsize_t size,
+    const hsize_t chunkSize,
+    const hid_t properties,
+    std::vector<T>& data,
+    const ParallelOptions& parallelOptions
+) {
+    // determine filter pipeline
+    ChunkFilters filters;
+    const int numberOfFilters = H5Pget_nfilters(properties);
+    for(int j = 0; j < numberOfFilters; ++j) {
+        unsigned int flags = 0;
+        size_t numberOfValues = 0;
+        unsigned int config = 0;
+        const H5Z_filter_t filter = H5Pget_filter2(properties, static_cast<unsigned int>(j), &flags, &numberOfValues, NULL, 0, NULL, &config);
+        if(filter == H5Z_FILTER_SHUFFLE && !filters.shuffle && !filters.deflate) {
+            filters.shuffle = true;
+            filters.shuffleIndex = j;
+        }
+        else if(filter == H5Z_FILTER_DEFLATE && !filters.deflate) {
+            filters.deflate = true;
+            filters.deflateIndex = j;
+        }
+        else {
+            return false;
+        }
+    }
+    HDF5Type<T> typeMemory;
+    if(H5Tequal(typeFile, typeMemory.type()) <= 0) {
+        return false;
+    }
+
+    // read batches of raw chunks and decode the previous batch concurrently
+    const std::size_t numberOfThreads = parallelOptions.numberOfThreads();
+    const hsize_t numberOfChunks = (size + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<unsigned char> > raw[2];
+    std::vector<std::uint32_t> masks[2];
+    std::vector<hsize_t> chunks[2];
+    std::vector<std::vector<unsigned char> > buffers(numberOfThreads);
+    std::atomic<bool> success(true);
+    std::thread decoder;
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(data.data());
+
+    for(hsize_t batchBegin = 0, b = 0; batchBegin < numberOfChunks; batchBegin += numberOfThreads, b = 1 - b) {
+        const hsize_t batchEnd = std::min<hsize_t>(batchBegin + numberOfThreads, numberOfChunks);
+        raw[b].resize(batchEnd - batchBegin);
+        masks[b].resize(batchEnd - batchBegin);
+        chunks[b].clear();
+        for(hsize_t c = batchBegin; c < batchEnd; ++c) {
+            hsize_t offset[] = {c * chunkSize};
+            hsize_t storageSize = 0;
+            if(H5Dget_chunk_storage_size(dataset, offset, &storageSize) < 0 || storageSize == 0) {
+                // chunk not allocated, let HDF5 supply the fill value
+                if(readHyperslab(dataset, filespace, offset[0],
+                    std::min<hsize_t>(chunkSize, size - offset[0]), typeMemory.type(), data.data() + offset[0]) < 0) {
+                    success = false;
+                }
+                continue;
+            }
+            std::vector<unsigned char>& r = raw[b][chunks[b].size()];
+            r.resize(storageSize);
+            if(H5Dread_chunk(dataset, H5P_DEFAULT, offset, &masks[b][chunks[b].size()], r.data()) < 0) {
+                success = false;
+                continue;
+            }
+            chunks[b].push_back(c);
+        }
+
+        if(decoder.joinable()) {
+            decoder.join();
+        }
+        decoder = std::thread([&, b]() {
+            std::vector<char> ok(chunks[b].size(), 1);
+            parallelFor(chunks[b].size(), ParallelOptions(numberOfThreads),
+                [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+                    for(std::size_t j = begin; j < end; ++j) {
+                        const hsize_t offset = chunks[b][j] * chunkSize;
+                        ok[j] = decodeChunk(raw[b][j], masks[b][j], filters, sizeof(T),
+                            chunkSize, std::min<hsize_t>(chunkSize, size - offset),
+                            buffers[block], bytes + offset * sizeof(T));
+                    }
+                },
+                1
+            );
+            if(std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+                success = false;
+            }
+        });
+    }
+    if(decoder.joinable()) {
+        decoder.join();
+    }
+    if(!success) {
+        throw std::runtime_error("could not read chunks of HDF5 dataset.");
+    }
+    return true;
+}
+
+#endif
+
+} // namespace detail
+
 /// Load a vector from an HDF5 dataset.
 ///
+/// Chunked datasets are read chunk by chunk. If compiled with
+/// ANDRES_GRAPHICS_WITH_ZLIB, chunks compressed by save() are decompressed
+/// in parallel while further chunks are read.
+///
 template<class T>
 inline void
 load(
     const hid_t parentHandle,
     const std::string datasetName,
-    std::vector<T>& data
+    std::vector<T>& data,
+    const ParallelOptions& parallelOptions = ParallelOptions()
 ) {
     // open dataset and get types
     hid_t dataset = H5Dopen(parentHandle, datasetName.c_str(), H5P_DEFAULT);
@@ -205,6 +764,9 @@ load(
     hid_t filespace = H5Dget_space(dataset);
     int dimension = H5Sget_simple_extent_ndims(filespace);
     if(dimension != 1) {
+        H5Dclose(dataset);
+        H5Tclose(typeFile);
+        H5Sclose(filespace);
         throw std::runtime_error("HDF5 dataset is not one-dimensional.");
     }
     hsize_t size = 0;
@@ -216,16 +778,41 @@ load(
         throw std::runtime_error("could not get shape of HDF5 dataset.");
     }
 
+    // get layout
+    hsize_t chunkSize = 0;
+    hid_t properties = H5Dget_create_plist(dataset);
+    if(H5Pget_layout(properties) == H5D_CHUNKED) {
+        H5Pget_chunk(properties, 1, &chunkSize);
+    }
+
     // read
     data.resize(size);
-    status = H5Dread(dataset, HDF5Type<T>().type(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+    if(chunkSize == 0 || size == 0) {
+        status = detail::readElements(dataset, filespace, typeFile, 0, size, data.data());
+    }
+    else {
+        bool done = false;
+#if defined(ANDRES_GRAPHICS_WITH_ZLIB) && H5_VERSION_GE(1, 10, 3)
+        try {
+            done = detail::readChunksParallel(dataset, filespace, typeFile, size, chunkSize, properties, data, parallelOptions);
+        }
+        catch(std::runtime_error&) {
+            status = -1;
+            done = true;
+        }
+#endif
+        for(hsize_t offset = 0; !done && status >= 0 && offset < size; offset += chunkSize) {
+            status = detail::readElements(dataset, filespace, typeFile, offset, std::min(chunkSize, size - offset), data.data() + offset);
+        }
+    }
 
     // close dataset and types
+    H5Pclose(properties);
     H5Dclose(dataset);
     H5Tclose(typeFile);
     H5Sclose(filespace);
     if(status < 0) {
-        throw std::runtime_error("could not read from HDF5 dataset 'points'.");
+        throw std::runtime_error("could not read from HDF5 dataset '" + datasetName + "'.");
     }
 }
 
@@ -263,6 +850,28 @@ public:
           H5Tinsert(type_, "property-index", HOFFSET(PointType, propertyIndex_), HDF5Type<size_type>().type()); }
     ~HDF5Type()
         { H5Tclose(type_); }
+    /// Compound type that describes all members, see detail::ElementType.
+    ///
+    /// \param typeValue HDF5 type of the coordinates.
+    /// \param typeIndex HDF5 type of the property index.
+    /// \param packed Pack the members without padding (file type) or
+    ///     place them at their offsets in Point (memory type).
+    ///
+    static hid_t createComplete(
+        const hid_t typeValue = HDF5Type<value_type>().type(),
+        const hid_t typeIndex = HDF5Type<size_type>().type(),
+        const bool packed = false
+    )
+        {
+            hsize_t shape[] = {3};
+            hid_t typeArray = H5Tarray_create(typeValue, 1, shape);
+            const std::size_t sizeArray = H5Tget_size(typeArray);
+            hid_t type = H5Tcreate(H5T_COMPOUND, packed ? sizeArray + H5Tget_size(typeIndex) : sizeof(PointType));
+            H5Tinsert(type, "vector", packed ? 0 : HOFFSET(PointType, r_), typeArray);
+            H5Tinsert(type, "property-index", packed ? sizeArray : HOFFSET(PointType, propertyIndex_), typeIndex);
+            H5Tclose(typeArray);
+            return type;
+        }
     hid_t type() const
         { return type_; }
 
@@ -304,6 +913,28 @@ public:
           H5Tinsert(type_, "property-index", HOFFSET(LineType, propertyIndex_), HDF5Type<size_type>().type()); }
     ~HDF5Type()
         { H5Tclose(type_); }
+    /// Compound type that describes all members, see detail::ElementType.
+    ///
+    /// \param typePointIndex HDF5 type of the point indices.
+    /// \param typePropertyIndex HDF5 type of the property index.
+    /// \param packed Pack the members without padding (file type) or
+    ///     place them at their offsets in Line (memory type).
+    ///
+    static hid_t createComplete(
+        const hid_t typePointIndex = HDF5Type<size_type>().type(),
+        const hid_t typePropertyIndex = HDF5Type<size_type>().type(),
+        const bool packed = false
+    )
+        {
+            hsize_t shape[] = {2};
+            hid_t typeArray = H5Tarray_create(typePointIndex, 1, shape);
+            const std::size_t sizeArray = H5Tget_size(typeArray);
+            hid_t type = H5Tcreate(H5T_COMPOUND, packed ? sizeArray + H5Tget_size(typePropertyIndex) : sizeof(LineType));
+            H5Tinsert(type, "point-indices", packed ? 0 : HOFFSET(LineType, pointIndices_), typeArray);
+            H5Tinsert(type, "property-index", packed ? sizeArray : HOFFSET(LineType, propertyIndex_), typePropertyIndex);
+            H5Tclose(typeArray);
+            return type;
+        }
     hid_t type() const
         { return type_; }
 
@@ -345,6 +976,28 @@ public:
           H5Tinsert(type_, "property-index", HOFFSET(TriangleType, propertyIndex_), HDF5Type<size_type>().type()); }
     ~HDF5Type()
         { H5Tclose(type_); }
+    /// Compound type that describes all members, see detail::ElementType.
+    ///
+    /// \param typePointIndex HDF5 type of the point indices.
+    /// \param typePropertyIndex HDF5 type of the property index.
+    /// \param packed Pack the members without padding (file type) or
+    ///     place them at their offsets in Triangle (memory type).
+    ///
+    static hid_t createComplete(
+        const hid_t typePointIndex = HDF5Type<size_type>().type(),
+        const hid_t typePropertyIndex = HDF5Type<size_type>().type(),
+        const bool packed = false
+    )
+        {
+            hsize_t shape[] = {3};
+            hid_t typeArray = H5Tarray_create(typePointIndex, 1, shape);
+            const std::size_t sizeArray = H5Tget_size(typeArray);
+            hid_t type = H5Tcreate(H5T_COMPOUND, packed ? sizeArray + H5Tget_size(typePropertyIndex) : sizeof(TriangleType));
+            H5Tinsert(type, "point-indices", packed ? 0 : HOFFSET(TriangleType, pointIndices_), typeArray);
+            H5Tinsert(type, "property-index", packed ? sizeArray : HOFFSET(TriangleType, propertyIndex_), typePropertyIndex);
+            H5Tclose(typeArray);
+            return type;
+        }
     hid_t type() const
         { return type_; }
 
@@ -352,28 +1005,197 @@ private:
     hid_t type_;
 };
 
+template<class P>
+class HDF5Type<andres::graphics::QuantizedPoint<P> > {
+private:
+    typedef andres::graphics::QuantizedPoint<P> QuantizedPointType;
+
+public:
+    HDF5Type()
+        : type_(createComplete())
+        {}
+    ~HDF5Type()
+        { H5Tclose(type_); }
+    hid_t type() const
+        { return type_; }
+
+    static hid_t createComplete(
+        const hid_t typeIndex = HDF5Type<P>().type(),
+        const bool packed = false
+    )
+        {
+            hsize_t shape[] = {3};
+            hid_t typeArray = H5Tarray_create(H5T_NATIVE_UINT16, 1, shape);
+            const std::size_t sizeArray = H5Tget_size(typeArray);
+            hid_t type = H5Tcreate(H5T_COMPOUND, packed ? sizeArray + H5Tget_size(typeIndex) : sizeof(QuantizedPointType));
+            H5Tinsert(type, "vector", packed ? 0 : HOFFSET(QuantizedPointType, r_), typeArray);
+            H5Tinsert(type, "property-index", packed ? sizeArray : HOFFSET(QuantizedPointType, propertyIndex_), typeIndex);
+            H5Tclose(typeArray);
+            return type;
+        }
+
+private:
+    hid_t type_;
+};
+
+namespace detail {
+
+template<class T, class S>
+struct ElementType<andres::graphics::Point<T, S> > {
+    static hid_t createCompleteMemoryType()
+        { return HDF5Type<andres::graphics::Point<T, S> >::createComplete(); }
+    static hid_t createCompleteFileType(const hid_t typeFile)
+        { return createArrayMemberType(typeFile, "vector", 3); }
+};
+
+template<class T, class S>
+struct ElementType<andres::graphics::Line<T, S> > {
+    static hid_t createCompleteMemoryType()
+        { return HDF5Type<andres::graphics::Line<T, S> >::createComplete(); }
+    static hid_t createCompleteFileType(const hid_t typeFile)
+        { return createArrayMemberType(typeFile, "point-indices", 2); }
+};
+
+template<class T, class S>
+struct ElementType<andres::graphics::Triangle<T, S> > {
+    static hid_t createCompleteMemoryType()
+        { return HDF5Type<andres::graphics::Triangle<T, S> >::createComplete(); }
+    static hid_t createCompleteFileType(const hid_t typeFile)
+        { return createArrayMemberType(typeFile, "point-indices", 3); }
+};
+
+template<class P>
+struct ElementType<andres::graphics::QuantizedPoint<P> > {
+    static hid_t createCompleteMemoryType()
+        { return HDF5Type<andres::graphics::QuantizedPoint<P> >::createComplete(); }
+    static hid_t createCompleteFileType(const hid_t typeFile)
+        { return H5Tcopy(typeFile); }
+};
+
+/// Narrowest unsigned integer type that can hold all values up to maximum.
+///
+inline hid_t
+narrowestUnsignedType(
+    const std::size_t maximum
+) {
+    if(maximum <= std::numeric_limits<std::uint8_t>::max()) {
+        return H5T_STD_U8LE;
+    }
+    if(maximum <= std::numeric_limits<std::uint16_t>::max()) {
+        return H5T_STD_U16LE;
+    }
+    if(maximum <= std::numeric_limits<std::uint32_t>::max()) {
+        return H5T_STD_U32LE;
+    }
+    return H5T_STD_U64LE;
+}
+
+/// Save a vector of points, lines or triangles with a packed file type in
+/// which point and property indices are the narrowest unsigned integers
+/// that can hold them.
+///
+template<class T>
+inline void
+saveCompact(
+    const hid_t parentHandle,
+    const std::string& datasetName,
+    const std::vector<T>& data,
+    const hid_t typeFile,
+    const SaveOptions& saveOptions
+) {
+    hid_t typeMemory = ElementType<T>::createCompleteMemoryType();
+    try {
+        save(parentHandle, datasetName, data.data(), data.size(), typeMemory, typeFile, saveOptions);
+    }
+    catch(std::runtime_error&) {
+        H5Tclose(typeMemory);
+        H5Tclose(typeFile);
+        throw;
+    }
+    H5Tclose(typeMemory);
+    H5Tclose(typeFile);
+}
+
+} // namespace detail
+
+/// Save a graphics to an HDF5 group or file.
+///
+/// With SaveOptions::compactTypes_, point and property indices are stored
+/// as the narrowest unsigned integers that can hold them, e.g. 32-bit
+/// point indices and 8-bit property indices. With SaveOptions::quantize_,
+/// coordinates are stored as 16-bit integers in the dataset
+/// 'quantized-points' together with the bounding box in the dataset
+/// 'quantization', instead of the dataset 'points'.
+///
 template<class T, class S>
 void
 save(
     const hid_t parentHandle,
-    const andres::graphics::Graphics<T, S>& graphics
+    const andres::graphics::Graphics<T, S>& graphics,
+    const SaveOptions& saveOptions = SaveOptions()
 ) {
+    typedef andres::graphics::Graphics<T, S> GraphicsType;
+
     std::vector<size_t> numbers(3);
     numbers[0] = graphics.numberOfPoints();
     numbers[1] = graphics.numberOfLines();
     numbers[2] = graphics.numberOfTriangles();
+    ANDRES_GRAPHICS_TIMER(timer, "hdf5::save");
+    timer.addItems(numbers[0] + numbers[1] + numbers[2]);
     save(parentHandle, "numbers", numbers);
     save(parentHandle, "point-properties", graphics.pointProperties());
     if(graphics.numberOfPoints() != 0) {
-        save(parentHandle, "points", graphics.points());
+        if(saveOptions.quantize_) {
+            const andres::graphics::Quantization<T> quantization(graphics);
+            std::vector<T> boundingBox(6);
+            for(std::size_t k = 0; k < 3; ++k) {
+                boundingBox[k] = quantization.minimum(k);
+                boundingBox[k + 3] = quantization.maximum(k);
+            }
+            save(parentHandle, "quantization", boundingBox);
+
+            std::vector<andres::graphics::QuantizedPoint<S> > quantizedPoints;
+            andres::graphics::quantize(graphics, quantization, quantizedPoints);
+            detail::saveCompact(parentHandle, "quantized-points", quantizedPoints,
+                HDF5Type<andres::graphics::QuantizedPoint<S> >::createComplete(
+                    detail::narrowestUnsignedType(graphics.numberOfPointProperties() - 1), true),
+                saveOptions);
+        }
+        else if(saveOptions.compactTypes_) {
+            detail::saveCompact(parentHandle, "points", graphics.points(),
+                HDF5Type<typename GraphicsType::PointType>::createComplete(HDF5Type<T>().type(),
+                    detail::narrowestUnsignedType(graphics.numberOfPointProperties() - 1), true),
+                saveOptions);
+        }
+        else {
+            save(parentHandle, "points", graphics.points(), saveOptions);
+        }
     }
     save(parentHandle, "line-properties", graphics.lineProperties());
     if(graphics.numberOfLines() != 0) {
-        save(parentHandle, "lines", graphics.lines());
+        if(saveOptions.compactTypes_) {
+            detail::saveCompact(parentHandle, "lines", graphics.lines(),
+                HDF5Type<typename GraphicsType::LineType>::createComplete(
+                    detail::narrowestUnsignedType(graphics.numberOfPoints() - 1),
+                    detail::narrowestUnsignedType(graphics.numberOfLineProperties() - 1), true),
+                saveOptions);
+        }
+        else {
+            save(parentHandle, "lines", graphics.lines(), saveOptions);
+        }
     }
     save(parentHandle, "triangle-properties", graphics.triangleProperties());
     if(graphics.numberOfTriangles() != 0) {
-        save(parentHandle, "triangles", graphics.triangles());
+        if(saveOptions.compactTypes_) {
+            detail::saveCompact(parentHandle, "triangles", graphics.triangles(),
+                HDF5Type<typename GraphicsType::TriangleType>::createComplete(
+                    detail::narrowestUnsignedType(graphics.numberOfPoints() - 1),
+                    detail::narrowestUnsignedType(graphics.numberOfTriangleProperties() - 1), true),
+                saveOptions);
+        }
+        else {
+            save(parentHandle, "triangles", graphics.triangles(), saveOptions);
+        }
     }
 }
 
@@ -381,7 +1203,8 @@ template<class T, class S>
 void
 load(
     const hid_t parentHandle,
-    andres::graphics::Graphics<T, S>& graphics
+    andres::graphics::Graphics<T, S>& graphics,
+    const ParallelOptions& parallelOptions = ParallelOptions()
 ) {
     typedef andres::graphics::Graphics<T, S> GraphicsType;
     typedef typename GraphicsType::PointType PointType;
@@ -401,24 +1224,276 @@ load(
     TrianglePropertiesVector triangleProperties;
     TrianglesVector triangles;
 
+    ANDRES_GRAPHICS_TIMER(timer, "hdf5::load");
     std::vector<size_t> numbers(3);
     load(parentHandle, "numbers", numbers);
+    timer.addItems(numbers[0] + numbers[1] + numbers[2]);
     load(parentHandle, "point-properties", pointProperties);
     if(numbers[0] != 0) {
-        load(parentHandle, "points", points);
+        if(H5Lexists(parentHandle, "points", H5P_DEFAULT) > 0) {
+            load(parentHandle, "points", points, parallelOptions);
+        }
+        else {
+            std::vector<T> boundingBox;
+            load(parentHandle, "quantization", boundingBox);
+            if(boundingBox.size() != 6) {
+                throw std::runtime_error("HDF5 dataset 'quantization' does not have 6 elements.");
+            }
+            std::vector<andres::graphics::QuantizedPoint<S> > quantizedPoints;
+            load(parentHandle, "quantized-points", quantizedPoints, parallelOptions);
+            andres::graphics::dequantize(andres::graphics::Quantization<T>(&boundingBox[0], &boundingBox[3]),
+                quantizedPoints, points);
+        }
     }
     load(parentHandle, "line-properties", lineProperties);
     if(numbers[1] != 0) {
-        load(parentHandle, "lines", lines);
+        load(parentHandle, "lines", lines, parallelOptions);
     }
     load(parentHandle, "triangle-properties", triangleProperties);
     if(numbers[2] != 0) {
-        load(parentHandle, "triangles", triangles);
+        load(parentHandle, "triangles", triangles, parallelOptions);
+    }
+
+    graphics.assign(std::move(pointProperties), std::move(points),
+        std::move(lineProperties), std::move(lines),
+        std::move(triangleProperties), std::move(triangles));
+}
+
+/// Save a GraphicsSoA to an HDF5 group or file, in the format of a Graphics.
+///
+/// The graphics is converted into a Graphics first, see
+/// GraphicsSoA::copyTo().
+///
+template<class T, class S, class P>
+void
+save(
+    const hid_t parentHandle,
+    const andres::graphics::GraphicsSoA<T, S, P>& graphics,
+    const SaveOptions& saveOptions = SaveOptions()
+) {
+    andres::graphics::Graphics<T, S> graphicsAoS;
+    graphics.copyTo(graphicsAoS);
+    save(parentHandle, graphicsAoS, saveOptions);
+}
+
+/// Load a GraphicsSoA from an HDF5 group or file written for a Graphics.
+///
+/// The graphics is loaded into a Graphics first and then converted, see
+/// GraphicsSoA::assign().
+///
+template<class T, class S, class P>
+void
+load(
+    const hid_t parentHandle,
+    andres::graphics::GraphicsSoA<T, S, P>& graphics,
+    const ParallelOptions& parallelOptions = ParallelOptions()
+) {
+    andres::graphics::Graphics<T, S> graphicsAoS;
+    load(parentHandle, graphicsAoS, parallelOptions);
+    graphics.assign(graphicsAoS);
+}
+
+/// Sequential reader of a one-dimensional HDF5 dataset in batches.
+///
+/// Each call of next() reads at most batchSize elements by a hyperslab
+/// selection, so memory use is bounded by the batch size and, for chunked
+/// datasets, one chunk in the HDF5 chunk cache, independent of the size of
+/// the dataset. For chunked datasets, batches larger than one chunk are
+/// rounded down to a multiple of the chunk size so that no chunk is
+/// decompressed twice.
+///
+template<class T>
+class DatasetReader {
+public:
+    DatasetReader(const hid_t, const std::string&, const hsize_t = 1 << 20);
+    ~DatasetReader();
+    hsize_t size() const
+        { return size_; }
+    hsize_t offset() const
+        { return offset_; }
+    hsize_t batchSize() const
+        { return batchSize_; }
+    bool next(std::vector<T>&);
+
+private:
+    DatasetReader(const DatasetReader&);
+    DatasetReader& operator=(const DatasetReader&);
+
+    hid_t dataset_;
+    hid_t filespace_;
+    hid_t typeFile_;
+    hsize_t size_;
+    hsize_t offset_;
+    hsize_t batchSize_;
+};
+
+template<class T>
+inline
+DatasetReader<T>::DatasetReader(
+    const hid_t parentHandle,
+    const std::string& datasetName,
+    const hsize_t batchSize
+)
+:   dataset_(-1),
+    filespace_(-1),
+    typeFile_(-1),
+    size_(0),
+    offset_(0),
+    batchSize_(batchSize == 0 ? 1 : batchSize)
+{
+    // open dataset with a chunk cache large enough for one chunk
+    hid_t access = H5Pcreate(H5P_DATASET_ACCESS);
+    hsize_t chunkSize = 0;
+    {
+        hid_t dataset = H5Dopen(parentHandle, datasetName.c_str(), H5P_DEFAULT);
+        if(dataset < 0) {
+            H5Pclose(access);
+            throw std::runtime_error("could not open HDF5 dataset '" + datasetName + "'.");
+        }
+        hid_t properties = H5Dget_create_plist(dataset);
+        if(H5Pget_layout(properties) == H5D_CHUNKED) {
+            H5Pget_chunk(properties, 1, &chunkSize);
+        }
+        H5Pclose(properties);
+        H5Dclose(dataset);
+    }
+    if(chunkSize != 0) {
+        H5Pset_chunk_cache(access, 521, std::max<std::size_t>(chunkSize * sizeof(T), 1 << 20), 1.0);
+        if(batchSize_ > chunkSize) {
+            batchSize_ -= batchSize_ % chunkSize;
+        }
+    }
+    dataset_ = H5Dopen(parentHandle, datasetName.c_str(), access);
+    H5Pclose(access);
+    if(dataset_ < 0) {
+        throw std::runtime_error("could not open HDF5 dataset '" + datasetName + "'.");
     }
 
-    graphics.assign(pointProperties, points,
-        lineProperties, lines,
-        triangleProperties, triangles);
+    // get dimension and shape
+    filespace_ = H5Dget_space(dataset_);
+    if(H5Sget_simple_extent_ndims(filespace_) != 1) {
+        H5Sclose(filespace_);
+        H5Dclose(dataset_);
+        throw std::runtime_error("HDF5 dataset is not one-dimensional.");
+    }
+    if(H5Sget_simple_extent_dims(filespace_, &size_, NULL) < 0) {
+        H5Sclose(filespace_);
+        H5Dclose(dataset_);
+        throw std::runtime_error("could not get shape of HDF5 dataset.");
+    }
+    typeFile_ = H5Dget_type(dataset_);
+}
+
+template<class T>
+inline
+DatasetReader<T>::~DatasetReader() {
+    H5Tclose(typeFile_);
+    H5Sclose(filespace_);
+    H5Dclose(dataset_);
+}
+
+/// Read the next batch.
+///
+/// \param batch Vector that is resized to the number of elements read.
+/// \returns false if all elements have been read before, true otherwise.
+///
+template<class T>
+inline bool
+DatasetReader<T>::next(
+    std::vector<T>& batch
+) {
+    if(offset_ >= size_) {
+        batch.clear();
+        return false;
+    }
+    batch.resize(std::min(batchSize_, size_ - offset_));
+    if(detail::readElements(dataset_, filespace_, typeFile_, offset_, batch.size(), batch.data()) < 0) {
+        throw std::runtime_error("could not read from HDF5 dataset.");
+    }
+    offset_ += batch.size();
+    return true;
+}
+
+/// Stream the graphics stored in an HDF5 group or file to a visitor, in
+/// batches of bounded size, without loading it into memory as a whole.
+///
+/// The visitor defines the types value_type and size_type of the graphics
+/// and the member functions
+///
+///     pointProperties(const PointPropertiesVector&)
+///     points(const PointsVector& batch, const std::size_t offset)
+///     lineProperties(const LinePropertiesVector&)
+///     lines(const LinesVector& batch, const std::size_t offset)
+///     triangleProperties(const TrianglePropertiesVector&)
+///     triangles(const TrianglesVector& batch, const std::size_t offset)
+///
+/// which are called in this order. offset is the index of the first
+/// element of the batch. Properties are passed as a whole. Quantized
+/// points are dequantized batch by batch.
+///
+template<class VISITOR>
+void
+visit(
+    const hid_t parentHandle,
+    VISITOR& visitor,
+    const hsize_t batchSize = 1 << 20
+) {
+    typedef andres::graphics::Graphics<typename VISITOR::value_type, typename VISITOR::size_type> GraphicsType;
+
+    std::vector<size_t> numbers(3);
+    load(parentHandle, "numbers", numbers);
+    {
+        typename GraphicsType::PointPropertiesVector pointProperties;
+        load(parentHandle, "point-properties", pointProperties);
+        visitor.pointProperties(pointProperties);
+    }
+    if(numbers[0] != 0 && H5Lexists(parentHandle, "points", H5P_DEFAULT) > 0) {
+        DatasetReader<typename GraphicsType::PointType> reader(parentHandle, "points", batchSize);
+        typename GraphicsType::PointsVector batch;
+        for(std::size_t offset = reader.offset(); reader.next(batch); offset = reader.offset()) {
+            visitor.points(batch, offset);
+        }
+    }
+    else if(numbers[0] != 0) {
+        typedef andres::graphics::QuantizedPoint<typename VISITOR::size_type> QuantizedPointType;
+        std::vector<typename VISITOR::value_type> boundingBox;
+        load(parentHandle, "quantization", boundingBox);
+        if(boundingBox.size() != 6) {
+            throw std::runtime_error("HDF5 dataset 'quantization' does not have 6 elements.");
+        }
+        const andres::graphics::Quantization<typename VISITOR::value_type> quantization(&boundingBox[0], &boundingBox[3]);
+        DatasetReader<QuantizedPointType> reader(parentHandle, "quantized-points", batchSize);
+        std::vector<QuantizedPointType> quantizedBatch;
+        typename GraphicsType::PointsVector batch;
+        for(std::size_t offset = reader.offset(); reader.next(quantizedBatch); offset = reader.offset()) {
+            andres::graphics::dequantize(quantization, quantizedBatch, batch);
+            visitor.points(batch, offset);
+        }
+    }
+    {
+        typename GraphicsType::LinePropertiesVector lineProperties;
+        load(parentHandle, "line-properties", lineProperties);
+        visitor.lineProperties(lineProperties);
+    }
+    if(numbers[1] != 0) {
+        DatasetReader<typename GraphicsType::LineType> reader(parentHandle, "lines", batchSize);
+        typename GraphicsType::LinesVector batch;
+        for(std::size_t offset = reader.offset(); reader.next(batch); offset = reader.offset()) {
+            visitor.lines(batch, offset);
+        }
+    }
+    {
+        typename GraphicsType::TrianglePropertiesVector triangleProperties;
+        load(parentHandle, "triangle-properties", triangleProperties);
+        visitor.triangleProperties(triangleProperties);
+    }
+    if(numbers[2] != 0) {
+        DatasetReader<typename GraphicsType::TriangleType> reader(parentHandle, "triangles", batchSize);
+        typename GraphicsType::TrianglesVector batch;
+        for(std::size_t offset = reader.offset(); reader.next(batch); offset = reader.offset()) {
+            visitor.triangles(batch, offset);
+        }
+    }
 }
 
 } // namespace hdf5
@@ -0,0 +1,521 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_GRAPHICS_SOA_HXX
+#define ANDRES_GRAPHICS_GRAPHICS_SOA_HXX
+
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "graphics.hxx"
+#include "simd.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Graphics with points stored as a structure of arrays.
+///
+/// The x, y and z coordinates of all points are stored in three separate
+/// arrays, and the point property indices in a fourth array of the compact
+/// type P. A point thus takes 3 * sizeof(T) + sizeof(P) bytes instead of
+/// sizeof(Point<T, S>), and center() and normalize() run vectorized
+/// reductions over contiguous arrays (see simd.hxx).
+///
+/// The read-only interface is that of Graphics, except that point()
+/// returns a Point by value and points() a copy of all points.
+/// coordinates() and pointPropertyIndices() access the arrays without
+/// copying. saveSVG() accepts a GraphicsSoA like a Graphics, and
+/// graphics-hdf5.hxx has overloads of hdf5::save() and hdf5::load() for it,
+/// which convert through a Graphics and thus need memory for a copy.
+///
+/// Not supported:
+/// - The ParallelOptions overloads of center() and normalize(),
+///   transform(), reserve(), the bulk definitions and the set functions of
+///   Graphics.
+/// - ScreenSpaceCulling, SpatialIndex, rasterize(), binary::save(),
+///   ConcurrentGraphics, cleanup() and the OpenGL viewer, which take a
+///   Graphics. copyTo() converts a GraphicsSoA into one.
+///
+template<class T = float, class S = std::size_t, class P = unsigned int>
+class GraphicsSoA {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef P property_index_type;
+    typedef Graphics<value_type, size_type> GraphicsType;
+    typedef typename GraphicsType::PointType PointType;
+    typedef typename GraphicsType::PointPropertyType PointPropertyType;
+    typedef typename GraphicsType::LineType LineType;
+    typedef typename GraphicsType::LinePropertyType LinePropertyType;
+    typedef typename GraphicsType::TriangleType TriangleType;
+    typedef typename GraphicsType::TrianglePropertyType TrianglePropertyType;
+    typedef std::vector<value_type> CoordinatesVector;
+    typedef std::vector<property_index_type> PropertyIndicesVector;
+    typedef typename GraphicsType::PointsVector PointsVector;
+    typedef typename GraphicsType::PointPropertiesVector PointPropertiesVector;
+    typedef typename GraphicsType::LinesVector LinesVector;
+    typedef typename GraphicsType::LinePropertiesVector LinePropertiesVector;
+    typedef typename GraphicsType::TrianglesVector TrianglesVector;
+    typedef typename GraphicsType::TrianglePropertiesVector TrianglePropertiesVector;
+
+    GraphicsSoA();
+    explicit GraphicsSoA(const GraphicsType&);
+    void clear();
+    void assign(const GraphicsType&);
+    void copyTo(GraphicsType&) const;
+    void center();
+    void center(const size_type);
+    void normalize();
+    void normalize(const size_type);
+    void normalize(const size_type, const size_type);
+    size_type definePointProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    size_type defineLineProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    size_type defineTriangleProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    size_type definePoint(const value_type x, const value_type y, const value_type z, const size_type = 0);
+    size_type defineLine(const size_type, const size_type, const size_type = 0);
+    size_type defineTriangle(const size_type, const size_type, const size_type, const size_type = 0);
+
+    const size_type numberOfPoints() const;
+    const size_type numberOfLines() const;
+    const size_type numberOfTriangles() const;
+    const size_type numberOfPointProperties() const;
+    const size_type numberOfLineProperties() const;
+    const size_type numberOfTriangleProperties() const;
+    PointType point(const size_type) const;
+    const LineType& line(const size_type) const;
+    const TriangleType& triangle(const size_type) const;
+    const PointPropertyType& pointProperty(const size_type) const;
+    const LinePropertyType& lineProperty(const size_type) const;
+    const TrianglePropertyType& triangleProperty(const size_type) const;
+    const CoordinatesVector& coordinates(const size_type) const;
+    const PropertyIndicesVector& pointPropertyIndices() const;
+    PointsVector points() const;
+    const LinesVector& lines() const;
+    const TrianglesVector& triangles() const;
+    const PointPropertiesVector& pointProperties() const;
+    const LinePropertiesVector& lineProperties() const;
+    const TrianglePropertiesVector& triangleProperties() const;
+
+private:
+    CoordinatesVector coordinates_[3];
+    PropertyIndicesVector pointPropertyIndices_;
+    LinesVector lines_;
+    TrianglesVector triangles_;
+    PointPropertiesVector pointProperties_;
+    LinePropertiesVector lineProperties_;
+    TrianglePropertiesVector triangleProperties_;
+};
+
+template<class T, class S, class P>
+inline
+GraphicsSoA<T, S, P>::GraphicsSoA()
+:   coordinates_(),
+    pointPropertyIndices_(),
+    lines_(),
+    triangles_(),
+    pointProperties_(1), // default point property
+    lineProperties_(1), // default line property
+    triangleProperties_(1) // default triangle property
+{}
+
+template<class T, class S, class P>
+inline
+GraphicsSoA<T, S, P>::GraphicsSoA(
+    const GraphicsType& graphics
+)
+:   GraphicsSoA()
+{
+    assign(graphics);
+}
+
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::clear() {
+    for(size_type k = 0; k < 3; ++k) {
+        coordinates_[k].clear();
+    }
+    pointPropertyIndices_.clear();
+    lines_.clear();
+    triangles_.clear();
+    pointProperties_.resize(1);
+    lineProperties_.resize(1);
+    triangleProperties_.resize(1);
+}
+
+/// Copy a Graphics into this structure of arrays.
+///
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::assign(
+    const GraphicsType& graphics
+) {
+    if(graphics.numberOfPointProperties() - 1 > std::numeric_limits<property_index_type>::max()) {
+        throw std::out_of_range("point property index exceeds range of property index type");
+    }
+
+    const size_type n = graphics.numberOfPoints();
+    for(size_type k = 0; k < 3; ++k) {
+        coordinates_[k].resize(n);
+    }
+    pointPropertyIndices_.resize(n);
+    for(size_type j = 0; j < n; ++j) {
+        const PointType& point = graphics.point(j);
+        coordinates_[0][j] = point[0];
+        coordinates_[1][j] = point[1];
+        coordinates_[2][j] = point[2];
+        pointPropertyIndices_[j] = static_cast<property_index_type>(point.propertyIndex());
+    }
+    lines_ = graphics.lines();
+    triangles_ = graphics.triangles();
+    pointProperties_ = graphics.pointProperties();
+    lineProperties_ = graphics.lineProperties();
+    triangleProperties_ = graphics.triangleProperties();
+}
+
+/// Copy this structure of arrays into a Graphics.
+///
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::copyTo(
+    GraphicsType& graphics
+) const {
+    graphics.assign(pointProperties_, points(),
+        lineProperties_, lines_,
+        triangleProperties_, triangles_);
+}
+
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::center() {
+    for(size_type k = 0; k < 3; ++k) {
+        center(k);
+    }
+}
+
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::center(
+    const size_type k
+) {
+    assert(k < 3);
+
+    // calculate center
+    value_type minimum = std::numeric_limits<float>::infinity();
+    value_type maximum = -std::numeric_limits<float>::infinity();
+    simd::minMax(coordinates_[k].data(), numberOfPoints(), minimum, maximum);
+    const value_type mean = (minimum + maximum) / 2.0f;
+
+    // center
+    simd::subtract(coordinates_[k].data(), numberOfPoints(), mean);
+}
+
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::normalize() {
+    // determine scale
+    value_type scale = simd::maxSquaredNorm<value_type>(coordinates_[0].data(),
+        coordinates_[1].data(), coordinates_[2].data(), numberOfPoints());
+
+    // scale
+    if(scale != 0.0f) {
+        scale = std::sqrt(scale);
+        for(size_type k = 0; k < 3; ++k) {
+            simd::divide(coordinates_[k].data(), numberOfPoints(), scale);
+        }
+    }
+}
+
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::normalize(
+    const size_type k
+) {
+    assert(k < 3);
+
+    // calculate scale
+    const value_type scale = simd::maxAbs<value_type>(coordinates_[k].data(), numberOfPoints());
+
+    // scale
+    if(scale != 0.0f) {
+        simd::divide(coordinates_[k].data(), numberOfPoints(), scale);
+    }
+}
+
+template<class T, class S, class P>
+inline void
+GraphicsSoA<T, S, P>::normalize(
+    const size_type k,
+    const size_type l
+) {
+    assert(k < 3);
+    assert(l < 3);
+    assert(k != l);
+
+    // determine scale
+    value_type scale = simd::maxSquaredNorm<value_type>(coordinates_[k].data(),
+        coordinates_[l].data(), 0, numberOfPoints());
+
+    // scale
+    if(scale != 0.0f) {
+        scale = std::sqrt(scale);
+        simd::divide(coordinates_[k].data(), numberOfPoints(), scale);
+        simd::divide(coordinates_[l].data(), numberOfPoints(), scale);
+    }
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::definePointProperty(
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    if(pointProperties_.size() > std::numeric_limits<property_index_type>::max()) {
+        throw std::out_of_range("point property index exceeds range of property index type");
+    }
+    pointProperties_.push_back(PointPropertyType(visibility, r, g, b, alpha));
+    return pointProperties_.size() - 1; // index of the point property just added
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::defineLineProperty(
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    lineProperties_.push_back(LinePropertyType(visibility, r, g, b, alpha));
+    return lineProperties_.size() - 1; // index of the line property just added
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::defineTriangleProperty(
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    triangleProperties_.push_back(TrianglePropertyType(visibility, r, g, b, alpha));
+    return triangleProperties_.size() - 1; // index of the triangle property just added
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::definePoint(
+    const value_type x,
+    const value_type y,
+    const value_type z,
+    const size_type propertyIndex
+) {
+    if(propertyIndex >= pointProperties_.size()) {
+        throw std::out_of_range("point property index out of range");
+    }
+    coordinates_[0].push_back(x);
+    coordinates_[1].push_back(y);
+    coordinates_[2].push_back(z);
+    pointPropertyIndices_.push_back(static_cast<property_index_type>(propertyIndex));
+    return pointPropertyIndices_.size() - 1; // index of the point just added
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::defineLine(
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type propertyIndex
+) {
+    if(pointIndex0 >= numberOfPoints()) {
+        throw std::out_of_range("point index 0 out of range");
+    }
+    if(pointIndex1 >= numberOfPoints()) {
+        throw std::out_of_range("point index 1 out of range");
+    }
+    if(propertyIndex >= lineProperties_.size()) {
+        throw std::out_of_range("line property index out of range");
+    }
+    lines_.push_back(LineType(pointIndex0, pointIndex1, propertyIndex));
+    return lines_.size() - 1; // index of the line just added
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::defineTriangle(
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type pointIndex2,
+    const size_type propertyIndex
+) {
+    if(pointIndex0 >= numberOfPoints()) {
+        throw std::out_of_range("point index 0 out of range");
+    }
+    if(pointIndex1 >= numberOfPoints()) {
+        throw std::out_of_range("point index 1 out of range");
+    }
+    if(pointIndex2 >= numberOfPoints()) {
+        throw std::out_of_range("point index 2 out of range");
+    }
+    if(propertyIndex >= triangleProperties_.size()) {
+        throw std::out_of_range("triangle property index out of range");
+    }
+    triangles_.push_back(TriangleType(pointIndex0, pointIndex1, pointIndex2, propertyIndex));
+    return triangles_.size() - 1; // index of the triangle just added
+}
+
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::PointType
+GraphicsSoA<T, S, P>::point(
+    const size_type index
+) const {
+    return PointType(coordinates_[0][index], coordinates_[1][index],
+        coordinates_[2][index], pointPropertyIndices_[index]);
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::LineType&
+GraphicsSoA<T, S, P>::line(
+    const size_type index
+) const {
+    return lines_[index];
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::TriangleType&
+GraphicsSoA<T, S, P>::triangle(
+    const size_type index
+) const {
+    return triangles_[index];
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::PointPropertyType&
+GraphicsSoA<T, S, P>::pointProperty(
+    const size_type index
+) const {
+    return pointProperties_[index];
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::LinePropertyType&
+GraphicsSoA<T, S, P>::lineProperty(
+    const size_type index
+) const {
+    return lineProperties_[index];
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::TrianglePropertyType&
+GraphicsSoA<T, S, P>::triangleProperty(
+    const size_type index
+) const {
+    return triangleProperties_[index];
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::numberOfPoints() const {
+    return pointPropertyIndices_.size();
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::numberOfLines() const {
+    return lines_.size();
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::numberOfTriangles() const {
+    return triangles_.size();
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::numberOfPointProperties() const {
+    return pointProperties_.size();
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::numberOfLineProperties() const {
+    return lineProperties_.size();
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::size_type
+GraphicsSoA<T, S, P>::numberOfTriangleProperties() const {
+    return triangleProperties_.size();
+}
+
+/// Coordinates of all points along one axis.
+///
+/// \param k Axis (0, 1 or 2).
+///
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::CoordinatesVector&
+GraphicsSoA<T, S, P>::coordinates(
+    const size_type k
+) const {
+    assert(k < 3);
+    return coordinates_[k];
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::PropertyIndicesVector&
+GraphicsSoA<T, S, P>::pointPropertyIndices() const {
+    return pointPropertyIndices_;
+}
+
+/// All points, copied into a vector of Point.
+///
+template<class T, class S, class P>
+inline typename GraphicsSoA<T, S, P>::PointsVector
+GraphicsSoA<T, S, P>::points() const {
+    PointsVector points(numberOfPoints());
+    for(size_type j = 0; j < numberOfPoints(); ++j) {
+        points[j] = point(j);
+    }
+    return points;
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::LinesVector&
+GraphicsSoA<T, S, P>::lines() const {
+    return lines_;
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::TrianglesVector&
+GraphicsSoA<T, S, P>::triangles() const {
+    return triangles_;
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::PointPropertiesVector&
+GraphicsSoA<T, S, P>::pointProperties() const {
+    return pointProperties_;
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::LinePropertiesVector&
+GraphicsSoA<T, S, P>::lineProperties() const {
+    return lineProperties_;
+}
+
+template<class T, class S, class P>
+inline const typename GraphicsSoA<T, S, P>::TrianglePropertiesVector&
+GraphicsSoA<T, S, P>::triangleProperties() const {
+    return triangleProperties_;
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_GRAPHICS_SOA_HXX
@@ -5,18 +5,60 @@
 #include <cstddef>
 #include <cassert>
 #include <cmath>
+#include <algorithm>
 #include <limits>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
+#include <utility>
 #include <iostream>
 
 #include "point.hxx"
 #include "line.hxx"
 #include "triangle.hxx"
+#include "parallel.hxx"
+#include "instrumentation.hxx"
 
 namespace andres {
 namespace graphics {
 
+namespace detail {
+
+/// Maximum of size indices, or 0 if size is 0, in one pass without
+/// branches that compilers vectorize.
+///
+template<class INDEX>
+inline INDEX
+maximum(
+    const INDEX* indices,
+    const std::size_t size
+) {
+    INDEX m = 0;
+    for(std::size_t j = 0; j < size; ++j) {
+        m = std::max(m, indices[j]);
+    }
+    return m;
+}
+
+/// Position of the first index not less than bound.
+///
+template<class INDEX, class BOUND>
+inline std::size_t
+firstOutOfRange(
+    const INDEX* indices,
+    const std::size_t size,
+    const BOUND bound
+) {
+    std::size_t j = 0;
+    while(j < size && indices[j] < bound) {
+        ++j;
+    }
+    return j;
+}
+
+} // namespace detail
+
 template<class T = float, class S = std::size_t>
 class Graphics {
 public:
@@ -40,17 +82,45 @@ public:
     void assign(const PointPropertiesVector&, const PointsVector&,
         const LinePropertiesVector&, const LinesVector&,
         const TrianglePropertiesVector&, const TrianglesVector&);
+    void assign(PointPropertiesVector&&, PointsVector&&,
+        LinePropertiesVector&&, LinesVector&&,
+        TrianglePropertiesVector&&, TrianglesVector&&);
     void center();
+    void center(const ParallelOptions&);
     void center(const size_type);
+    void center(const size_type, const ParallelOptions&);
     void normalize();
+    void normalize(const ParallelOptions&);
     void normalize(const size_type);
+    void normalize(const size_type, const ParallelOptions&);
     void normalize(const size_type, const size_type);
+    void normalize(const size_type, const size_type, const ParallelOptions&);
+    void transform(const value_type (&)[3][4]);
+    void transform(const value_type (&)[3][4], const ParallelOptions&);
     size_type definePointProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
     size_type defineLineProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
     size_type defineTriangleProperty(const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
     size_type definePoint(const value_type x, const value_type y, const value_type z, const size_type = 0);
     size_type defineLine(const size_type, const size_type, const size_type = 0);
     size_type defineTriangle(const size_type, const size_type, const size_type, const size_type = 0);
+    void reserve(const size_type, const size_type = 0, const size_type = 0);
+    size_type definePoints(const value_type*, const size_type, const size_type = 0);
+    size_type definePoints(const PointsVector&);
+    size_type definePoints(PointsVector&&);
+    template<class INDEX>
+        size_type defineLines(const INDEX*, const size_type, const size_type = 0);
+    size_type defineLines(const LinesVector&);
+    size_type defineLines(LinesVector&&);
+    template<class INDEX>
+        size_type defineTriangles(const INDEX*, const size_type, const size_type = 0);
+    size_type defineTriangles(const TrianglesVector&);
+    size_type defineTriangles(TrianglesVector&&);
+    void setPointProperty(const size_type, const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    void setLineProperty(const size_type, const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    void setTriangleProperty(const size_type, const bool, const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    void setPoint(const size_type, const value_type x, const value_type y, const value_type z, const size_type = 0);
+    void setLine(const size_type, const size_type, const size_type, const size_type = 0);
+    void setTriangle(const size_type, const size_type, const size_type, const size_type, const size_type = 0);
 
     const size_type numberOfPoints() const;
     const size_type numberOfLines() const;
@@ -72,6 +142,10 @@ public:
     const TrianglePropertiesVector& triangleProperties() const;
 
 private:
+    static void validate(const PointsVector&, const size_type);
+    static void validate(const LinesVector&, const size_type, const size_type);
+    static void validate(const TrianglesVector&, const size_type, const size_type);
+
     PointsVector points_;
     LinesVector lines_;
     TrianglesVector triangles_;
@@ -100,6 +174,9 @@ Graphics<T, S>::clear() {
     lineProperties_.resize(1);
 }
 
+/// Replace the graphics by copies of the given vectors, validated as by
+/// the overload that takes ownership of them.
+///
 template<class T, class S>
 inline void
 Graphics<T, S>::assign(
@@ -110,7 +187,9 @@ Graphics<T, S>::assign(
     const TrianglePropertiesVector& triangleProperties,
     const TrianglesVector& triangles
 ) {
-    // TODO: sanity check input
+    validate(points, pointProperties.size());
+    validate(lines, points.size(), lineProperties.size());
+    validate(triangles, points.size(), triangleProperties.size());
 
     pointProperties_ = pointProperties;
     points_ = points;
@@ -120,94 +199,200 @@ Graphics<T, S>::assign(
     triangles_ = triangles;
 }
 
+/// Take ownership of the given vectors without copying them.
+///
+/// All point and property indices are validated in one pass per vector
+/// before the graphics is changed. An index out of range throws
+/// std::out_of_range and leaves the graphics and the vectors unchanged.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::assign(
+    PointPropertiesVector&& pointProperties,
+    PointsVector&& points,
+    LinePropertiesVector&& lineProperties,
+    LinesVector&& lines,
+    TrianglePropertiesVector&& triangleProperties,
+    TrianglesVector&& triangles
+) {
+    validate(points, pointProperties.size());
+    validate(lines, points.size(), lineProperties.size());
+    validate(triangles, points.size(), triangleProperties.size());
+
+    pointProperties_ = std::move(pointProperties);
+    points_ = std::move(points);
+    lineProperties_ = std::move(lineProperties);
+    lines_ = std::move(lines);
+    triangleProperties_ = std::move(triangleProperties);
+    triangles_ = std::move(triangles);
+}
+
 template<class T, class S>
 inline void
 Graphics<T, S>::center() {
+    center(ParallelOptions(1));
+}
+
+template<class T, class S>
+inline void
+Graphics<T, S>::center(
+    const ParallelOptions& parallelOptions
+) {
+    ANDRES_GRAPHICS_TIMER(timer, "Graphics::center");
+    timer.addItems(numberOfPoints());
+
     // calculate center
-    value_type vectorMin[3] = {
-        std::numeric_limits<float>::infinity(),
-        std::numeric_limits<float>::infinity(),
-        std::numeric_limits<float>::infinity()
-    };
-    value_type vectorMax[3] = {
-        -std::numeric_limits<float>::infinity(),
-        -std::numeric_limits<float>::infinity(),
-        -std::numeric_limits<float>::infinity()
-    };
+    const std::size_t numberOfBlocks = graphics::numberOfBlocks(numberOfPoints(), parallelOptions);
+    std::vector<value_type> blockMin(3 * numberOfBlocks, std::numeric_limits<float>::infinity());
+    std::vector<value_type> blockMax(3 * numberOfBlocks, -std::numeric_limits<float>::infinity());
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            value_type* vectorMin = &blockMin[3 * block];
+            value_type* vectorMax = &blockMax[3 * block];
+            for(size_type j = begin; j < end; ++j) {
+                for(size_type k = 0; k < 3; ++k) {
+                    if(points_[j][k] < vectorMin[k]) {
+                        vectorMin[k] = points_[j][k];
+                    }
+                    if(points_[j][k] > vectorMax[k]) {
+                        vectorMax[k] = points_[j][k];
+                    }
+                }
+            }
+        }
+    );
     value_type vectorMean[3] = {0.0f, 0.0f, 0.0f};
-
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        for(size_type k = 0; k < 3; ++k) {
-            if(points_[j][k] < vectorMin[k]) {
-                vectorMin[k] = points_[j][k];
+    for(size_type k = 0; k < 3; ++k) {
+        value_type minimum = blockMin[k];
+        value_type maximum = blockMax[k];
+        for(std::size_t block = 1; block < numberOfBlocks; ++block) {
+            if(blockMin[3 * block + k] < minimum) {
+                minimum = blockMin[3 * block + k];
             }
-            if(points_[j][k] > vectorMax[k]) {
-                vectorMax[k] = points_[j][k];
+            if(blockMax[3 * block + k] > maximum) {
+                maximum = blockMax[3 * block + k];
             }
         }
-    }
-    for(size_type k = 0; k < 3; ++k) {
-        vectorMean[k] = (vectorMin[k] + vectorMax[k]) / 2.0f;
+        vectorMean[k] = (minimum + maximum) / 2.0f;
     }
 
     // center
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        for(size_type k = 0; k < 3; ++k) {
-            points_[j][k] -= vectorMean[k];
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(size_type j = begin; j < end; ++j) {
+                for(size_type k = 0; k < 3; ++k) {
+                    points_[j][k] -= vectorMean[k];
+                }
+            }
         }
-    }
+    );
 }
 
 template<class T, class S>
 inline void
 Graphics<T, S>::center(
     const size_type k
+) {
+    center(k, ParallelOptions(1));
+}
+
+template<class T, class S>
+inline void
+Graphics<T, S>::center(
+    const size_type k,
+    const ParallelOptions& parallelOptions
 ) {
     assert(k < 3);
+    ANDRES_GRAPHICS_TIMER(timer, "Graphics::center");
+    timer.addItems(numberOfPoints());
 
     // calculate center
-    value_type minimum = std::numeric_limits<float>::infinity();
-    value_type maximum = -std::numeric_limits<float>::infinity();
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        if(points_[j][k] < minimum) {
-            minimum = points_[j][k];
+    const std::size_t numberOfBlocks = graphics::numberOfBlocks(numberOfPoints(), parallelOptions);
+    std::vector<value_type> blockMin(numberOfBlocks, std::numeric_limits<float>::infinity());
+    std::vector<value_type> blockMax(numberOfBlocks, -std::numeric_limits<float>::infinity());
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            value_type minimum = blockMin[block];
+            value_type maximum = blockMax[block];
+            for(size_type j = begin; j < end; ++j) {
+                if(points_[j][k] < minimum) {
+                    minimum = points_[j][k];
+                }
+                if(points_[j][k] > maximum) {
+                    maximum = points_[j][k];
+                }
+            }
+            blockMin[block] = minimum;
+            blockMax[block] = maximum;
         }
-        if(points_[j][k] > maximum) {
-            maximum = points_[j][k];
+    );
+    value_type minimum = blockMin[0];
+    value_type maximum = blockMax[0];
+    for(std::size_t block = 1; block < numberOfBlocks; ++block) {
+        if(blockMin[block] < minimum) {
+            minimum = blockMin[block];
+        }
+        if(blockMax[block] > maximum) {
+            maximum = blockMax[block];
         }
     }
     const value_type mean = (minimum + maximum) / 2.0f;
 
     // center
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        points_[j][k] -= mean;
-    }
-
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(size_type j = begin; j < end; ++j) {
+                points_[j][k] -= mean;
+            }
+        }
+    );
 }
 
 template<class T, class S>
 inline void
 Graphics<T, S>::normalize() {
+    normalize(ParallelOptions(1));
+}
+
+template<class T, class S>
+inline void
+Graphics<T, S>::normalize(
+    const ParallelOptions& parallelOptions
+) {
+    ANDRES_GRAPHICS_TIMER(timer, "Graphics::normalize");
+    timer.addItems(numberOfPoints());
+
     // determine scale
-    value_type scale = 0.0f;
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        value_type scalePoint = 0.0f;
-        for(size_type k = 0; k < 3; ++k) {
-            scalePoint += points_[j][k] * points_[j][k];
-        }
-        if(scalePoint > scale) {
-            scale = scalePoint;
+    std::vector<value_type> blockScale(graphics::numberOfBlocks(numberOfPoints(), parallelOptions), 0.0f);
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            value_type scale = 0.0f;
+            for(size_type j = begin; j < end; ++j) {
+                value_type scalePoint = 0.0f;
+                for(size_type k = 0; k < 3; ++k) {
+                    scalePoint += points_[j][k] * points_[j][k];
+                }
+                if(scalePoint > scale) {
+                    scale = scalePoint;
+                }
+            }
+            blockScale[block] = scale;
         }
-    }
+    );
+    value_type scale = *std::max_element(blockScale.begin(), blockScale.end());
 
     // scale
     if(scale != 0.0f) {
         scale = std::sqrt(scale);
-        for(size_type j = 0; j < numberOfPoints(); ++j) {
-            for(size_type k = 0; k < 3; ++k) {
-                points_[j][k] /= scale;
+        parallelFor(numberOfPoints(), parallelOptions,
+            [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                for(size_type j = begin; j < end; ++j) {
+                    for(size_type k = 0; k < 3; ++k) {
+                        points_[j][k] /= scale;
+                    }
+                }
             }
-        }
+        );
     }
 }
 
@@ -215,23 +400,45 @@ template<class T, class S>
 inline void
 Graphics<T, S>::normalize(
     const size_type k
+) {
+    normalize(k, ParallelOptions(1));
+}
+
+template<class T, class S>
+inline void
+Graphics<T, S>::normalize(
+    const size_type k,
+    const ParallelOptions& parallelOptions
 ) {
     assert(k < 3);
+    ANDRES_GRAPHICS_TIMER(timer, "Graphics::normalize");
+    timer.addItems(numberOfPoints());
 
     // calculate scale
-    value_type scale = 0.0f;
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        value_type scalePoint = std::abs(points_[j][k]);
-        if(scalePoint > scale) {
-            scale = scalePoint;
+    std::vector<value_type> blockScale(graphics::numberOfBlocks(numberOfPoints(), parallelOptions), 0.0f);
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            value_type scale = 0.0f;
+            for(size_type j = begin; j < end; ++j) {
+                value_type scalePoint = std::abs(points_[j][k]);
+                if(scalePoint > scale) {
+                    scale = scalePoint;
+                }
+            }
+            blockScale[block] = scale;
         }
-    }
+    );
+    const value_type scale = *std::max_element(blockScale.begin(), blockScale.end());
 
     // scale
     if(scale != 0.0f) {
-        for(size_type j = 0; j < numberOfPoints(); ++j) {
-            points_[j][k] /= scale;
-        }
+        parallelFor(numberOfPoints(), parallelOptions,
+            [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                for(size_type j = begin; j < end; ++j) {
+                    points_[j][k] /= scale;
+                }
+            }
+        );
     }
 }
 
@@ -240,32 +447,89 @@ inline void
 Graphics<T, S>::normalize(
     const size_type k,
     const size_type l
+) {
+    normalize(k, l, ParallelOptions(1));
+}
+
+template<class T, class S>
+inline void
+Graphics<T, S>::normalize(
+    const size_type k,
+    const size_type l,
+    const ParallelOptions& parallelOptions
 ) {
     assert(k < 3);
     assert(l < 3);
     assert(k != l);
+    ANDRES_GRAPHICS_TIMER(timer, "Graphics::normalize");
+    timer.addItems(numberOfPoints());
 
     // determine scale
-    value_type scale = 0.0f;
-    for(size_type j = 0; j < numberOfPoints(); ++j) {
-        value_type scalePoint = 0.0f;
-        scalePoint += points_[j][k] * points_[j][k];
-        scalePoint += points_[j][l] * points_[j][l];
-        if(scalePoint > scale) {
-            scale = scalePoint;
+    std::vector<value_type> blockScale(graphics::numberOfBlocks(numberOfPoints(), parallelOptions), 0.0f);
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            value_type scale = 0.0f;
+            for(size_type j = begin; j < end; ++j) {
+                value_type scalePoint = 0.0f;
+                scalePoint += points_[j][k] * points_[j][k];
+                scalePoint += points_[j][l] * points_[j][l];
+                if(scalePoint > scale) {
+                    scale = scalePoint;
+                }
+            }
+            blockScale[block] = scale;
         }
-    }
+    );
+    value_type scale = *std::max_element(blockScale.begin(), blockScale.end());
 
     // scale
     if(scale != 0.0f) {
         scale = std::sqrt(scale);
-        for(size_type j = 0; j < numberOfPoints(); ++j) {
-            points_[j][k] /= scale;
-            points_[j][l] /= scale;
-        }
+        parallelFor(numberOfPoints(), parallelOptions,
+            [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                for(size_type j = begin; j < end; ++j) {
+                    points_[j][k] /= scale;
+                    points_[j][l] /= scale;
+                }
+            }
+        );
     }
 }
 
+/// Apply an affine transformation to all points.
+///
+/// Every point r is replaced by A r + b where the 3x4 matrix is [A b].
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::transform(
+    const value_type (&matrix)[3][4]
+) {
+    transform(matrix, ParallelOptions(1));
+}
+
+template<class T, class S>
+inline void
+Graphics<T, S>::transform(
+    const value_type (&matrix)[3][4],
+    const ParallelOptions& parallelOptions
+) {
+    ANDRES_GRAPHICS_TIMER(timer, "Graphics::transform");
+    timer.addItems(numberOfPoints());
+
+    parallelFor(numberOfPoints(), parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(size_type j = begin; j < end; ++j) {
+                const value_type r[3] = {points_[j][0], points_[j][1], points_[j][2]};
+                for(size_type k = 0; k < 3; ++k) {
+                    points_[j][k] = matrix[k][0] * r[0] + matrix[k][1] * r[1]
+                        + matrix[k][2] * r[2] + matrix[k][3];
+                }
+            }
+        }
+    );
+}
+
 template<class T, class S>
 inline typename Graphics<T, S>::size_type
 Graphics<T, S>::definePointProperty(
@@ -365,6 +629,439 @@ Graphics<T, S>::defineTriangle(
     return triangles_.size() - 1; // index of the triangle just added
 }
 
+/// Redefine the point property with the given index.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::setPointProperty(
+    const size_type index,
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    if(index >= pointProperties_.size()) {
+        throw std::out_of_range("point property index out of range");
+    }
+    pointProperties_[index] = PointPropertyType(visibility, r, g, b, alpha);
+}
+
+/// Redefine the line property with the given index.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::setLineProperty(
+    const size_type index,
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    if(index >= lineProperties_.size()) {
+        throw std::out_of_range("line property index out of range");
+    }
+    lineProperties_[index] = LinePropertyType(visibility, r, g, b, alpha);
+}
+
+/// Redefine the triangle property with the given index.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::setTriangleProperty(
+    const size_type index,
+    const bool visibility,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    if(index >= triangleProperties_.size()) {
+        throw std::out_of_range("triangle property index out of range");
+    }
+    triangleProperties_[index] = TrianglePropertyType(visibility, r, g, b, alpha);
+}
+
+/// Redefine the point with the given index.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::setPoint(
+    const size_type index,
+    const value_type x,
+    const value_type y,
+    const value_type z,
+    const size_type propertyIndex
+) {
+    if(index >= points_.size()) {
+        throw std::out_of_range("point index out of range");
+    }
+    if(propertyIndex >= pointProperties_.size()) {
+        throw std::out_of_range("point property index out of range");
+    }
+    points_[index] = PointType(x, y, z, propertyIndex);
+}
+
+/// Redefine the line with the given index.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::setLine(
+    const size_type index,
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type propertyIndex
+) {
+    if(index >= lines_.size()) {
+        throw std::out_of_range("line index out of range");
+    }
+    if(pointIndex0 >= points_.size()) {
+        throw std::out_of_range("point index 0 out of range");
+    }
+    if(pointIndex1 >= points_.size()) {
+        throw std::out_of_range("point index 1 out of range");
+    }
+    if(propertyIndex >= lineProperties_.size()) {
+        throw std::out_of_range("line property index out of range");
+    }
+    lines_[index] = LineType(pointIndex0, pointIndex1, propertyIndex);
+}
+
+/// Redefine the triangle with the given index.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::setTriangle(
+    const size_type index,
+    const size_type pointIndex0,
+    const size_type pointIndex1,
+    const size_type pointIndex2,
+    const size_type propertyIndex
+) {
+    if(index >= triangles_.size()) {
+        throw std::out_of_range("triangle index out of range");
+    }
+    if(pointIndex0 >= points_.size()) {
+        throw std::out_of_range("point index 0 out of range");
+    }
+    if(pointIndex1 >= points_.size()) {
+        throw std::out_of_range("point index 1 out of range");
+    }
+    if(pointIndex2 >= points_.size()) {
+        throw std::out_of_range("point index 2 out of range");
+    }
+    if(propertyIndex >= triangleProperties_.size()) {
+        throw std::out_of_range("triangle property index out of range");
+    }
+    triangles_[index] = TriangleType(pointIndex0, pointIndex1, pointIndex2, propertyIndex);
+}
+
+/// Reserve memory for points, lines and triangles.
+///
+/// \param numberOfPoints Total number of points.
+/// \param numberOfLines Total number of lines.
+/// \param numberOfTriangles Total number of triangles.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::reserve(
+    const size_type numberOfPoints,
+    const size_type numberOfLines,
+    const size_type numberOfTriangles
+) {
+    points_.reserve(numberOfPoints);
+    lines_.reserve(numberOfLines);
+    triangles_.reserve(numberOfTriangles);
+}
+
+/// Define points with the same property.
+///
+/// \param coordinates Array of 3 * numberOfPoints coordinates x0, y0, z0,
+///     x1, y1, z1, etc.
+/// \param numberOfPoints Number of points.
+/// \param propertyIndex Index of the point property.
+/// \returns Index of the first point defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::definePoints(
+    const value_type* coordinates,
+    const size_type numberOfPoints,
+    const size_type propertyIndex
+) {
+    if(propertyIndex >= pointProperties_.size()) {
+        throw std::out_of_range("point property index out of range");
+    }
+    const size_type first = points_.size();
+    points_.resize(first + numberOfPoints);
+    PointType* points = points_.data() + first;
+    for(size_type j = 0; j < numberOfPoints; ++j) {
+        points[j] = PointType(coordinates[3 * j], coordinates[3 * j + 1], coordinates[3 * j + 2], propertyIndex);
+    }
+    return first;
+}
+
+/// Define points, validating all property indices before any point is
+/// added.
+///
+/// \returns Index of the first point defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::definePoints(
+    const PointsVector& points
+) {
+    validate(points, pointProperties_.size());
+    const size_type first = points_.size();
+    points_.insert(points_.end(), points.begin(), points.end());
+    return first;
+}
+
+/// Define points, taking ownership of the vector without copying it if
+/// no points have been defined before. points is left empty.
+///
+/// \returns Index of the first point defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::definePoints(
+    PointsVector&& points
+) {
+    validate(points, pointProperties_.size());
+    const size_type first = points_.size();
+    if(points_.empty()) {
+        points_.swap(points);
+    }
+    else {
+        points_.insert(points_.end(), points.begin(), points.end());
+    }
+    PointsVector().swap(points);
+    return first;
+}
+
+/// Define lines with the same property.
+///
+/// All point indices are validated in one pass before any line is added.
+///
+/// \param pointIndices Array of 2 * numberOfLines point indices of an
+///     unsigned integer type, two per line.
+/// \param numberOfLines Number of lines.
+/// \param propertyIndex Index of the line property.
+/// \returns Index of the first line defined.
+///
+template<class T, class S>
+template<class INDEX>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::defineLines(
+    const INDEX* pointIndices,
+    const size_type numberOfLines,
+    const size_type propertyIndex
+) {
+    static_assert(std::is_unsigned<INDEX>::value, "point indices must be unsigned.");
+    if(numberOfLines != 0 && detail::maximum(pointIndices, 2 * numberOfLines) >= points_.size()) {
+        const std::size_t j = detail::firstOutOfRange(pointIndices, 2 * numberOfLines, points_.size());
+        throw std::out_of_range("point index " + std::to_string(j % 2) + " of line "
+            + std::to_string(j / 2) + " out of range");
+    }
+    if(propertyIndex >= lineProperties_.size()) {
+        throw std::out_of_range("line property index out of range");
+    }
+    const size_type first = lines_.size();
+    lines_.resize(first + numberOfLines);
+    LineType* lines = lines_.data() + first;
+    for(size_type j = 0; j < numberOfLines; ++j) {
+        lines[j] = LineType(static_cast<size_type>(pointIndices[2 * j]),
+            static_cast<size_type>(pointIndices[2 * j + 1]), propertyIndex);
+    }
+    return first;
+}
+
+/// Define lines, validating all indices before any line is added.
+///
+/// \returns Index of the first line defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::defineLines(
+    const LinesVector& lines
+) {
+    validate(lines, points_.size(), lineProperties_.size());
+    const size_type first = lines_.size();
+    lines_.insert(lines_.end(), lines.begin(), lines.end());
+    return first;
+}
+
+/// Define lines, taking ownership of the vector without copying it if no
+/// lines have been defined before. lines is left empty.
+///
+/// \returns Index of the first line defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::defineLines(
+    LinesVector&& lines
+) {
+    validate(lines, points_.size(), lineProperties_.size());
+    const size_type first = lines_.size();
+    if(lines_.empty()) {
+        lines_.swap(lines);
+    }
+    else {
+        lines_.insert(lines_.end(), lines.begin(), lines.end());
+    }
+    LinesVector().swap(lines);
+    return first;
+}
+
+/// Define triangles with the same property.
+///
+/// All point indices are validated in one pass before any triangle is
+/// added.
+///
+/// \param pointIndices Array of 3 * numberOfTriangles point indices of an
+///     unsigned integer type, three per triangle.
+/// \param numberOfTriangles Number of triangles.
+/// \param propertyIndex Index of the triangle property.
+/// \returns Index of the first triangle defined.
+///
+template<class T, class S>
+template<class INDEX>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::defineTriangles(
+    const INDEX* pointIndices,
+    const size_type numberOfTriangles,
+    const size_type propertyIndex
+) {
+    static_assert(std::is_unsigned<INDEX>::value, "point indices must be unsigned.");
+    if(numberOfTriangles != 0 && detail::maximum(pointIndices, 3 * numberOfTriangles) >= points_.size()) {
+        const std::size_t j = detail::firstOutOfRange(pointIndices, 3 * numberOfTriangles, points_.size());
+        throw std::out_of_range("point index " + std::to_string(j % 3) + " of triangle "
+            + std::to_string(j / 3) + " out of range");
+    }
+    if(propertyIndex >= triangleProperties_.size()) {
+        throw std::out_of_range("triangle property index out of range");
+    }
+    const size_type first = triangles_.size();
+    triangles_.resize(first + numberOfTriangles);
+    TriangleType* triangles = triangles_.data() + first;
+    for(size_type j = 0; j < numberOfTriangles; ++j) {
+        triangles[j] = TriangleType(static_cast<size_type>(pointIndices[3 * j]),
+            static_cast<size_type>(pointIndices[3 * j + 1]),
+            static_cast<size_type>(pointIndices[3 * j + 2]), propertyIndex);
+    }
+    return first;
+}
+
+/// Define triangles, validating all indices before any triangle is added.
+///
+/// \returns Index of the first triangle defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::defineTriangles(
+    const TrianglesVector& triangles
+) {
+    validate(triangles, points_.size(), triangleProperties_.size());
+    const size_type first = triangles_.size();
+    triangles_.insert(triangles_.end(), triangles.begin(), triangles.end());
+    return first;
+}
+
+/// Define triangles, taking ownership of the vector without copying it if
+/// no triangles have been defined before. triangles is left empty.
+///
+/// \returns Index of the first triangle defined.
+///
+template<class T, class S>
+inline typename Graphics<T, S>::size_type
+Graphics<T, S>::defineTriangles(
+    TrianglesVector&& triangles
+) {
+    validate(triangles, points_.size(), triangleProperties_.size());
+    const size_type first = triangles_.size();
+    if(triangles_.empty()) {
+        triangles_.swap(triangles);
+    }
+    else {
+        triangles_.insert(triangles_.end(), triangles.begin(), triangles.end());
+    }
+    TrianglesVector().swap(triangles);
+    return first;
+}
+
+/// Validate the property indices of points in one pass.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::validate(
+    const PointsVector& points,
+    const size_type numberOfPointProperties
+) {
+    size_type m = 0;
+    for(size_type j = 0; j < points.size(); ++j) {
+        m = std::max(m, points[j].propertyIndex());
+    }
+    if(!points.empty() && m >= numberOfPointProperties) {
+        size_type j = 0;
+        while(points[j].propertyIndex() < numberOfPointProperties) {
+            ++j;
+        }
+        throw std::out_of_range("point property index of point " + std::to_string(j) + " out of range");
+    }
+}
+
+/// Validate the point and property indices of lines in one pass.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::validate(
+    const LinesVector& lines,
+    const size_type numberOfPoints,
+    const size_type numberOfLineProperties
+) {
+    size_type m = 0;
+    size_type n = 0;
+    for(size_type j = 0; j < lines.size(); ++j) {
+        m = std::max(m, std::max(lines[j].pointIndex(0), lines[j].pointIndex(1)));
+        n = std::max(n, lines[j].propertyIndex());
+    }
+    if(!lines.empty() && (m >= numberOfPoints || n >= numberOfLineProperties)) {
+        size_type j = 0;
+        while(lines[j].pointIndex(0) < numberOfPoints && lines[j].pointIndex(1) < numberOfPoints
+        && lines[j].propertyIndex() < numberOfLineProperties) {
+            ++j;
+        }
+        throw std::out_of_range("point or property index of line " + std::to_string(j) + " out of range");
+    }
+}
+
+/// Validate the point and property indices of triangles in one pass.
+///
+template<class T, class S>
+inline void
+Graphics<T, S>::validate(
+    const TrianglesVector& triangles,
+    const size_type numberOfPoints,
+    const size_type numberOfTriangleProperties
+) {
+    size_type m = 0;
+    size_type n = 0;
+    for(size_type j = 0; j < triangles.size(); ++j) {
+        m = std::max(m, std::max(triangles[j].pointIndex(0),
+            std::max(triangles[j].pointIndex(1), triangles[j].pointIndex(2))));
+        n = std::max(n, triangles[j].propertyIndex());
+    }
+    if(!triangles.empty() && (m >= numberOfPoints || n >= numberOfTriangleProperties)) {
+        size_type j = 0;
+        while(triangles[j].pointIndex(0) < numberOfPoints && triangles[j].pointIndex(1) < numberOfPoints
+        && triangles[j].pointIndex(2) < numberOfPoints && triangles[j].propertyIndex() < numberOfTriangleProperties) {
+            ++j;
+        }
+        throw std::out_of_range("point or property index of triangle " + std::to_string(j) + " out of range");
+    }
+}
+
 template<class T, class S>
 inline const typename Graphics<T, S>::PointType&
 Graphics<T, S>::point(
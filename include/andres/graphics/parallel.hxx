@@ -0,0 +1,83 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_PARALLEL_HXX
+#define ANDRES_GRAPHICS_PARALLEL_HXX
+
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace andres {
+namespace graphics {
+
+/// Options for the parallel execution of operations on Graphics.
+///
+/// \param numberOfThreads Number of threads. 0 means one thread per
+///     hardware thread. 1 means serial execution in the calling thread.
+///
+struct ParallelOptions {
+    ParallelOptions(const std::size_t numberOfThreads = 0)
+        : numberOfThreads_(numberOfThreads)
+        {}
+    std::size_t numberOfThreads() const
+        {
+            if(numberOfThreads_ == 0) {
+                const std::size_t n = std::thread::hardware_concurrency();
+                return n == 0 ? 1 : n;
+            }
+            return numberOfThreads_;
+        }
+
+private:
+    std::size_t numberOfThreads_;
+};
+
+/// Number of threads among which parallelFor() splits a range.
+///
+/// Ranges are split only into blocks of at least minimumBlockSize
+/// elements, so that small ranges are processed in the calling thread.
+///
+inline std::size_t
+numberOfBlocks(
+    const std::size_t size,
+    const ParallelOptions& parallelOptions,
+    const std::size_t minimumBlockSize = 1 << 16
+) {
+    const std::size_t n = std::min(parallelOptions.numberOfThreads(), size / minimumBlockSize);
+    return n == 0 ? 1 : n;
+}
+
+/// Split [0, size) into numberOfBlocks(size, parallelOptions,
+/// minimumBlockSize) contiguous blocks and call f(blockIndex, begin, end)
+/// for each block, one block per thread. Block 0 is processed by the
+/// calling thread.
+///
+template<class FUNCTION>
+inline void
+parallelFor(
+    const std::size_t size,
+    const ParallelOptions& parallelOptions,
+    FUNCTION f,
+    const std::size_t minimumBlockSize = 1 << 16
+) {
+    const std::size_t n = numberOfBlocks(size, parallelOptions, minimumBlockSize);
+    if(n == 1) {
+        f(std::size_t(0), std::size_t(0), size);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    for(std::size_t j = 1; j < n; ++j) {
+        threads.push_back(std::thread(f, j, size * j / n, size * (j + 1) / n));
+    }
+    f(std::size_t(0), std::size_t(0), size / n);
+    for(std::size_t j = 0; j < threads.size(); ++j) {
+        threads[j].join();
+    }
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_PARALLEL_HXX
@@ -7,6 +7,11 @@
 namespace andres {
 namespace graphics {
 
+/// Orthogonal projection of 3D coordinates onto 2D coordinates (r, s).
+///
+/// The third row of the parameters defines the depth of a projected point
+/// that is used by the rasterizer. Smaller depth is nearer to the viewer.
+///
 template<class T = float, class S = std::size_t>
 struct OrthogonalProjection {
     typedef T value_type;
@@ -18,19 +23,73 @@ struct OrthogonalProjection {
     OrthogonalProjection(
         const value_type p00, const value_type p01, const value_type p02,
         const value_type p10, const value_type p11, const value_type p12
+    )
+        : OrthogonalProjection(p00, p01, p02, p10, p11, p12, 0.0, 0.0, 1.0)
+        {}
+    OrthogonalProjection(
+        const value_type p00, const value_type p01, const value_type p02,
+        const value_type p10, const value_type p11, const value_type p12,
+        const value_type p20, const value_type p21, const value_type p22
     )
         {
             parameters_[0][0] = p00; parameters_[0][1] = p01; parameters_[0][2] = p02;
             parameters_[1][0] = p10; parameters_[1][1] = p11; parameters_[1][2] = p12;
+            parameters_[2][0] = p20; parameters_[2][1] = p21; parameters_[2][2] = p22;
         }
     void operator()(const value_type x, const value_type y, const value_type z, value_type& r, value_type& s) const
         {
             r = parameters_[0][0] * x + parameters_[0][1] * y + parameters_[0][2] * z;
             s = parameters_[1][0] * x + parameters_[1][1] * y + parameters_[1][2] * z;
         }
+    void operator()(const value_type x, const value_type y, const value_type z, value_type& r, value_type& s, value_type& depth) const
+        {
+            (*this)(x, y, z, r, s);
+            depth = parameters_[2][0] * x + parameters_[2][1] * y + parameters_[2][2] * z;
+        }
     value_type parameters_[3][3];
 };
 
+/// Affine projection of 3D coordinates onto 2D coordinates (r, s) and a
+/// depth, by a 3x4 matrix as in Graphics::transform().
+///
+/// E.g. a camera given by a rotation R and scale a, viewing [-1, 1]^2 in a
+/// window of w x h pixels with the origin at the top left corner, is the
+/// matrix with the rows (a w/2 R_0, w/2), (-a h/2 R_1, h/2), (a R_2, 0).
+///
+template<class T = float, class S = std::size_t>
+struct AffineProjection {
+    typedef T value_type;
+    typedef S size_type;
+
+    AffineProjection()
+        {
+            for(std::size_t j = 0; j < 3; ++j) {
+                for(std::size_t k = 0; k < 4; ++k) {
+                    matrix_[j][k] = (j == k ? 1 : 0);
+                }
+            }
+        }
+    AffineProjection(const value_type (&matrix)[3][4])
+        {
+            for(std::size_t j = 0; j < 3; ++j) {
+                for(std::size_t k = 0; k < 4; ++k) {
+                    matrix_[j][k] = matrix[j][k];
+                }
+            }
+        }
+    void operator()(const value_type x, const value_type y, const value_type z, value_type& r, value_type& s) const
+        {
+            r = matrix_[0][0] * x + matrix_[0][1] * y + matrix_[0][2] * z + matrix_[0][3];
+            s = matrix_[1][0] * x + matrix_[1][1] * y + matrix_[1][2] * z + matrix_[1][3];
+        }
+    void operator()(const value_type x, const value_type y, const value_type z, value_type& r, value_type& s, value_type& depth) const
+        {
+            (*this)(x, y, z, r, s);
+            depth = matrix_[2][0] * x + matrix_[2][1] * y + matrix_[2][2] * z + matrix_[2][3];
+        }
+    value_type matrix_[3][4];
+};
+
 } // namespace graphics
 } // namespace andres
 
@@ -0,0 +1,204 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_QUANTIZATION_HXX
+#define ANDRES_GRAPHICS_QUANTIZATION_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "graphics.hxx"
+
+namespace andres {
+namespace graphics {
+
+namespace hdf5 {
+    template<class T> class HDF5Type;
+}
+
+/// Point with coordinates quantized to 16 bits, see Quantization.
+///
+/// With a 16-bit property index, a quantized point takes 8 bytes instead
+/// of the 24 bytes of Point<float, std::size_t>.
+///
+template<class P = std::uint16_t>
+class QuantizedPoint {
+public:
+    typedef std::uint16_t value_type;
+    typedef P size_type;
+
+    QuantizedPoint()
+        : QuantizedPoint(0, 0, 0)
+        {}
+    QuantizedPoint(const value_type x, const value_type y, const value_type z, const size_type propertyIndex = 0)
+        : propertyIndex_(propertyIndex)
+        { r_[0] = x; r_[1] = y; r_[2] = z; }
+    value_type& operator[](const std::size_t index)
+        { assert(index < 3); return r_[index]; }
+    size_type& propertyIndex()
+        { return propertyIndex_; }
+    value_type operator[](const std::size_t index) const
+        { assert(index < 3); return r_[index]; }
+    size_type propertyIndex() const
+        { return propertyIndex_; }
+    bool operator==(const QuantizedPoint<P>& other) const
+        { return r_[0] == other.r_[0]
+            && r_[1] == other.r_[1]
+            && r_[2] == other.r_[2]
+            && propertyIndex_ == other.propertyIndex_;
+        }
+
+private:
+    value_type r_[3];
+    size_type propertyIndex_;
+
+friend class hdf5::HDF5Type<QuantizedPoint<P> >;
+};
+
+/// Affine map between coordinates in a bounding box and 16-bit integers.
+///
+/// The bounding box is divided into 65535 steps per axis. The error of a
+/// quantized coordinate is at most half a step, error(k).
+///
+template<class T = float>
+class Quantization {
+public:
+    typedef T value_type;
+
+    static const std::uint16_t maximumValue = 65535;
+
+    Quantization()
+        { for(std::size_t k = 0; k < 3; ++k) { minimum_[k] = 0; maximum_[k] = 1; } }
+    Quantization(const value_type* minimum, const value_type* maximum)
+        { for(std::size_t k = 0; k < 3; ++k) { minimum_[k] = minimum[k]; maximum_[k] = maximum[k]; } }
+    template<class S>
+    explicit Quantization(const Graphics<T, S>&);
+
+    std::uint16_t quantize(const value_type, const std::size_t) const;
+    value_type dequantize(const std::uint16_t, const std::size_t) const;
+    value_type minimum(const std::size_t k) const
+        { assert(k < 3); return minimum_[k]; }
+    value_type maximum(const std::size_t k) const
+        { assert(k < 3); return maximum_[k]; }
+    value_type error(const std::size_t k) const
+        { assert(k < 3); return (maximum_[k] - minimum_[k]) / maximumValue / 2; }
+
+private:
+    value_type minimum_[3];
+    value_type maximum_[3];
+};
+
+/// Quantization with the bounding box of all points of a graphics.
+///
+template<class T>
+template<class S>
+inline
+Quantization<T>::Quantization(
+    const Graphics<T, S>& graphics
+) {
+    for(std::size_t k = 0; k < 3; ++k) {
+        minimum_[k] = std::numeric_limits<value_type>::infinity();
+        maximum_[k] = -std::numeric_limits<value_type>::infinity();
+    }
+    for(S j = 0; j < graphics.numberOfPoints(); ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            if(graphics.point(j)[k] < minimum_[k]) {
+                minimum_[k] = graphics.point(j)[k];
+            }
+            if(graphics.point(j)[k] > maximum_[k]) {
+                maximum_[k] = graphics.point(j)[k];
+            }
+        }
+    }
+    for(std::size_t k = 0; k < 3; ++k) {
+        if(!(minimum_[k] <= maximum_[k])) { // no points
+            minimum_[k] = 0;
+            maximum_[k] = 1;
+        }
+    }
+}
+
+template<class T>
+inline std::uint16_t
+Quantization<T>::quantize(
+    const value_type x,
+    const std::size_t k
+) const {
+    assert(k < 3);
+    if(!(x > minimum_[k])) {
+        return 0;
+    }
+    if(!(x < maximum_[k])) {
+        return maximumValue;
+    }
+    const double relative = (static_cast<double>(x) - minimum_[k]) / (static_cast<double>(maximum_[k]) - minimum_[k]);
+    return static_cast<std::uint16_t>(relative * maximumValue + 0.5);
+}
+
+template<class T>
+inline typename Quantization<T>::value_type
+Quantization<T>::dequantize(
+    const std::uint16_t q,
+    const std::size_t k
+) const {
+    assert(k < 3);
+    const double step = (static_cast<double>(maximum_[k]) - minimum_[k]) / maximumValue;
+    return static_cast<value_type>(minimum_[k] + q * step);
+}
+
+/// Quantize the points of a graphics.
+///
+/// \param graphics Graphics.
+/// \param quantization Quantization, e.g. Quantization<T>(graphics).
+/// \param points Vector to which the quantized points are written.
+///
+template<class T, class S, class P>
+inline void
+quantize(
+    const Graphics<T, S>& graphics,
+    const Quantization<T>& quantization,
+    std::vector<QuantizedPoint<P> >& points
+) {
+    if(graphics.numberOfPointProperties() - 1 > std::numeric_limits<P>::max()) {
+        throw std::out_of_range("point property index exceeds range of property index type");
+    }
+    points.resize(graphics.numberOfPoints());
+    for(S j = 0; j < graphics.numberOfPoints(); ++j) {
+        const typename Graphics<T, S>::PointType& point = graphics.point(j);
+        points[j] = QuantizedPoint<P>(
+            quantization.quantize(point[0], 0),
+            quantization.quantize(point[1], 1),
+            quantization.quantize(point[2], 2),
+            static_cast<P>(point.propertyIndex())
+        );
+    }
+}
+
+/// Dequantize points.
+///
+template<class T, class S, class P>
+inline void
+dequantize(
+    const Quantization<T>& quantization,
+    const std::vector<QuantizedPoint<P> >& quantizedPoints,
+    std::vector<Point<T, S> >& points
+) {
+    points.resize(quantizedPoints.size());
+    for(std::size_t j = 0; j < quantizedPoints.size(); ++j) {
+        const QuantizedPoint<P>& q = quantizedPoints[j];
+        points[j] = Point<T, S>(
+            quantization.dequantize(q[0], 0),
+            quantization.dequantize(q[1], 1),
+            quantization.dequantize(q[2], 2),
+            static_cast<S>(q.propertyIndex())
+        );
+    }
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_QUANTIZATION_HXX
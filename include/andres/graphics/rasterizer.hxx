@@ -0,0 +1,817 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_RASTERIZER_HXX
+#define ANDRES_GRAPHICS_RASTERIZER_HXX
+
+#include <cstddef>
+#include <cassert>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+#include "zlib.h"
+#endif
+
+#include "graphics.hxx"
+#include "parallel.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Options for the rasterization of graphics.
+///
+/// \param pointSize Edge length of the squares drawn for points, in pixels.
+/// \param lineWidth Width of lines, in pixels.
+/// \param tileSize Edge length of the square tiles of the framebuffer that
+///     are rasterized independently, in pixels.
+/// \param minimumDepth Fragments of smaller depth are discarded.
+/// \param maximumDepth Fragments of greater depth are discarded.
+///
+struct RasterizerOptions {
+    RasterizerOptions(
+        const float pointSize = 5.0f,
+        const float lineWidth = 1.0f,
+        const std::size_t tileSize = 64,
+        const float minimumDepth = -std::numeric_limits<float>::infinity(),
+        const float maximumDepth = std::numeric_limits<float>::infinity()
+    )
+    :   pointSize_(pointSize),
+        lineWidth_(lineWidth),
+        tileSize_(tileSize),
+        minimumDepth_(minimumDepth),
+        maximumDepth_(maximumDepth)
+    {}
+
+    float pointSize_;
+    float lineWidth_;
+    std::size_t tileSize_;
+    float minimumDepth_;
+    float maximumDepth_;
+};
+
+/// RGBA image with a depth buffer. Row 0 is the top row.
+///
+class Framebuffer {
+public:
+    Framebuffer(const std::size_t = 0, const std::size_t = 0,
+        const unsigned char = 255, const unsigned char = 255, const unsigned char = 255, const unsigned char = 255);
+    void clear(const unsigned char, const unsigned char, const unsigned char, const unsigned char = 255);
+    std::size_t width() const
+        { return width_; }
+    std::size_t height() const
+        { return height_; }
+    unsigned char* pixel(const std::size_t x, const std::size_t y)
+        { assert(x < width_ && y < height_); return &rgba_[4 * (y * width_ + x)]; }
+    const unsigned char* pixel(const std::size_t x, const std::size_t y) const
+        { assert(x < width_ && y < height_); return &rgba_[4 * (y * width_ + x)]; }
+    float& depth(const std::size_t x, const std::size_t y)
+        { assert(x < width_ && y < height_); return depth_[y * width_ + x]; }
+    float depth(const std::size_t x, const std::size_t y) const
+        { assert(x < width_ && y < height_); return depth_[y * width_ + x]; }
+    const std::vector<unsigned char>& rgba() const
+        { return rgba_; }
+
+private:
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<unsigned char> rgba_;
+    std::vector<float> depth_;
+};
+
+/// Framebuffer of the given size, cleared to the given color.
+///
+inline
+Framebuffer::Framebuffer(
+    const std::size_t width,
+    const std::size_t height,
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+)
+:   width_(width),
+    height_(height),
+    rgba_(4 * width * height),
+    depth_(width * height)
+{
+    clear(r, g, b, alpha);
+}
+
+/// Set all pixels to the given color and all depths to infinity.
+///
+inline void
+Framebuffer::clear(
+    const unsigned char r,
+    const unsigned char g,
+    const unsigned char b,
+    const unsigned char alpha
+) {
+    for(std::size_t j = 0; j < rgba_.size(); j += 4) {
+        rgba_[j] = r;
+        rgba_[j + 1] = g;
+        rgba_[j + 2] = b;
+        rgba_[j + 3] = alpha;
+    }
+    std::fill(depth_.begin(), depth_.end(), std::numeric_limits<float>::infinity());
+}
+
+namespace detail {
+
+/// Pixels [x0_, x1_) x [y0_, y1_).
+///
+struct PixelRectangle {
+    std::ptrdiff_t x0_;
+    std::ptrdiff_t y0_;
+    std::ptrdiff_t x1_;
+    std::ptrdiff_t y1_;
+};
+
+/// Indices of the primitives that overlap each tile, in the order of the
+/// primitives.
+///
+template<class S>
+struct TileBins {
+    std::vector<std::size_t> offsets_; // primitives of tile t: indices_[offsets_[t]] ... indices_[offsets_[t + 1] - 1]
+    std::vector<S> indices_;
+};
+
+/// Integer in [minimum, maximum] nearest to x, also for infinite x.
+///
+inline std::ptrdiff_t
+clampToInteger(
+    const float x,
+    const std::ptrdiff_t minimum,
+    const std::ptrdiff_t maximum
+) {
+    if(!(x > minimum)) {
+        return minimum;
+    }
+    if(!(x < maximum)) {
+        return maximum;
+    }
+    return static_cast<std::ptrdiff_t>(x);
+}
+
+/// Tiles overlapped by a box in window coordinates, or false if the box is
+/// empty, not finite or outside the framebuffer.
+///
+inline bool
+tilesOfBox(
+    const float minimumX,
+    const float minimumY,
+    const float maximumX,
+    const float maximumY,
+    const std::size_t width,
+    const std::size_t height,
+    const std::size_t tileSize,
+    PixelRectangle& tiles
+) {
+    if(!(minimumX <= maximumX && minimumY <= maximumY)) { // also NaN
+        return false;
+    }
+    // conservative by one pixel
+    const std::ptrdiff_t x0 = clampToInteger(std::floor(minimumX) - 1, -1, width);
+    const std::ptrdiff_t y0 = clampToInteger(std::floor(minimumY) - 1, -1, height);
+    const std::ptrdiff_t x1 = clampToInteger(std::floor(maximumX) + 1, -1, width);
+    const std::ptrdiff_t y1 = clampToInteger(std::floor(maximumY) + 1, -1, height);
+    if(x1 < 0 || y1 < 0 || x0 >= static_cast<std::ptrdiff_t>(width) || y0 >= static_cast<std::ptrdiff_t>(height)) {
+        return false;
+    }
+    const std::ptrdiff_t t = static_cast<std::ptrdiff_t>(tileSize);
+    tiles.x0_ = std::max(x0, std::ptrdiff_t(0)) / t;
+    tiles.y0_ = std::max(y0, std::ptrdiff_t(0)) / t;
+    tiles.x1_ = std::min(x1, static_cast<std::ptrdiff_t>(width) - 1) / t + 1;
+    tiles.y1_ = std::min(y1, static_cast<std::ptrdiff_t>(height) - 1) / t + 1;
+    return true;
+}
+
+/// Sort primitives into the tiles they overlap.
+///
+/// Each thread counts and then writes the primitives of a contiguous block,
+/// and the blocks are concatenated per tile, such that the primitives of
+/// each tile are in their original order.
+///
+/// \param tilesOf Function tilesOf(index, tiles) that writes the tiles
+///     overlapped by a primitive and returns false if it is not drawn.
+///
+template<class S, class TILES_OF>
+inline void
+binPrimitives(
+    const std::size_t numberOfPrimitives,
+    const std::size_t numberOfColumns,
+    const std::size_t numberOfTiles,
+    TILES_OF tilesOf,
+    const ParallelOptions& parallelOptions,
+    TileBins<S>& bins
+) {
+    const std::size_t minimumBlockSize = 1 << 14;
+    const std::size_t numberOfBlocks = graphics::numberOfBlocks(numberOfPrimitives, parallelOptions, minimumBlockSize);
+    std::vector<std::size_t> counts(numberOfBlocks * numberOfTiles, 0);
+    parallelFor(numberOfPrimitives, parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            std::size_t* c = &counts[block * numberOfTiles];
+            PixelRectangle tiles;
+            for(std::size_t j = begin; j < end; ++j) {
+                if(tilesOf(j, tiles)) {
+                    for(std::ptrdiff_t y = tiles.y0_; y < tiles.y1_; ++y) {
+                        for(std::ptrdiff_t x = tiles.x0_; x < tiles.x1_; ++x) {
+                            ++c[y * numberOfColumns + x];
+                        }
+                    }
+                }
+            }
+        },
+        minimumBlockSize
+    );
+
+    // turn counts into write positions
+    bins.offsets_.resize(numberOfTiles + 1);
+    std::size_t offset = 0;
+    for(std::size_t t = 0; t < numberOfTiles; ++t) {
+        bins.offsets_[t] = offset;
+        for(std::size_t block = 0; block < numberOfBlocks; ++block) {
+            const std::size_t count = counts[block * numberOfTiles + t];
+            counts[block * numberOfTiles + t] = offset;
+            offset += count;
+        }
+    }
+    bins.offsets_[numberOfTiles] = offset;
+    bins.indices_.resize(offset);
+
+    parallelFor(numberOfPrimitives, parallelOptions,
+        [&](const std::size_t block, const std::size_t begin, const std::size_t end) {
+            std::size_t* positions = &counts[block * numberOfTiles];
+            PixelRectangle tiles;
+            for(std::size_t j = begin; j < end; ++j) {
+                if(tilesOf(j, tiles)) {
+                    for(std::ptrdiff_t y = tiles.y0_; y < tiles.y1_; ++y) {
+                        for(std::ptrdiff_t x = tiles.x0_; x < tiles.x1_; ++x) {
+                            bins.indices_[positions[y * numberOfColumns + x]++] = static_cast<S>(j);
+                        }
+                    }
+                }
+            }
+        },
+        minimumBlockSize
+    );
+}
+
+/// Depth test and blending of one fragment, as glDepthFunc(GL_LESS) and
+/// glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) in the viewer. The
+/// alpha channel is composited by the over operator.
+///
+inline void
+shadeFragment(
+    Framebuffer& framebuffer,
+    const std::size_t x,
+    const std::size_t y,
+    const float depth,
+    const unsigned char* color,
+    const RasterizerOptions& options
+) {
+    if(!(depth >= options.minimumDepth_ && depth <= options.maximumDepth_)) {
+        return;
+    }
+    float& d = framebuffer.depth(x, y);
+    if(!(depth < d)) {
+        return;
+    }
+    d = depth;
+    unsigned char* p = framebuffer.pixel(x, y);
+    const unsigned int alpha = color[3];
+    if(alpha == 255) {
+        p[0] = color[0];
+        p[1] = color[1];
+        p[2] = color[2];
+        p[3] = 255;
+    }
+    else {
+        const unsigned int beta = 255 - alpha;
+        p[0] = static_cast<unsigned char>((color[0] * alpha + p[0] * beta + 127) / 255);
+        p[1] = static_cast<unsigned char>((color[1] * alpha + p[1] * beta + 127) / 255);
+        p[2] = static_cast<unsigned char>((color[2] * alpha + p[2] * beta + 127) / 255);
+        p[3] = static_cast<unsigned char>(alpha + (p[3] * beta + 127) / 255);
+    }
+}
+
+/// Draw a point as a square of pixels, clipped to a tile.
+///
+inline void
+rasterizePoint(
+    Framebuffer& framebuffer,
+    const float* v,
+    const unsigned char* color,
+    const PixelRectangle& tile,
+    const RasterizerOptions& options
+) {
+    const float size = std::max(1.0f, std::floor(options.pointSize_ + 0.5f));
+    // pixels whose centers are in [v - size / 2, v + size / 2)
+    const std::ptrdiff_t x0 = std::max(tile.x0_, clampToInteger(std::ceil(v[0] - size / 2 - 0.5f), tile.x0_, tile.x1_));
+    const std::ptrdiff_t y0 = std::max(tile.y0_, clampToInteger(std::ceil(v[1] - size / 2 - 0.5f), tile.y0_, tile.y1_));
+    const std::ptrdiff_t x1 = std::min(tile.x1_, clampToInteger(std::ceil(v[0] + size / 2 - 0.5f), tile.x0_, tile.x1_));
+    const std::ptrdiff_t y1 = std::min(tile.y1_, clampToInteger(std::ceil(v[1] + size / 2 - 0.5f), tile.y0_, tile.y1_));
+    for(std::ptrdiff_t y = y0; y < y1; ++y) {
+        for(std::ptrdiff_t x = x0; x < x1; ++x) {
+            shadeFragment(framebuffer, x, y, v[2], color, options);
+        }
+    }
+}
+
+/// Draw a line as in OpenGL without antialiasing: for each pixel along the
+/// major axis, from the first point up to but excluding the second, a span
+/// of lineWidth pixels along the minor axis.
+///
+inline void
+rasterizeLine(
+    Framebuffer& framebuffer,
+    const float* p,
+    const float* q,
+    const unsigned char* color,
+    const PixelRectangle& tile,
+    const RasterizerOptions& options
+) {
+    const float width = std::max(1.0f, std::floor(options.lineWidth_ + 0.5f));
+    const float d[] = {q[0] - p[0], q[1] - p[1], q[2] - p[2]};
+    const std::size_t major = std::abs(d[0]) >= std::abs(d[1]) ? 0 : 1;
+    const std::size_t minor = 1 - major;
+    if(!(d[major] != 0)) { // degenerate or NaN
+        return;
+    }
+    const std::ptrdiff_t tile0[] = {tile.x0_, tile.y0_};
+    const std::ptrdiff_t tile1[] = {tile.x1_, tile.y1_};
+
+    // pixels whose centers are in [p, q) along the major axis
+    std::ptrdiff_t begin;
+    std::ptrdiff_t end;
+    if(d[major] > 0) {
+        begin = clampToInteger(std::ceil(p[major] - 0.5f), tile0[major], tile1[major]);
+        end = clampToInteger(std::ceil(q[major] - 0.5f), tile0[major], tile1[major]);
+    }
+    else {
+        begin = clampToInteger(std::floor(q[major] - 0.5f) + 1, tile0[major], tile1[major]);
+        end = clampToInteger(std::floor(p[major] - 0.5f) + 1, tile0[major], tile1[major]);
+    }
+    for(std::ptrdiff_t j = begin; j < end; ++j) {
+        const float t = (j + 0.5f - p[major]) / d[major];
+        const float center = p[minor] + t * d[minor];
+        const float depth = p[2] + t * d[2];
+        const std::ptrdiff_t k0 = std::max(tile0[minor], clampToInteger(std::ceil(center - width / 2 - 0.5f), tile0[minor], tile1[minor]));
+        const std::ptrdiff_t k1 = std::min(tile1[minor], clampToInteger(std::ceil(center + width / 2 - 0.5f), tile0[minor], tile1[minor]));
+        for(std::ptrdiff_t k = k0; k < k1; ++k) {
+            if(major == 0) {
+                shadeFragment(framebuffer, j, k, depth, color, options);
+            }
+            else {
+                shadeFragment(framebuffer, k, j, depth, color, options);
+            }
+        }
+    }
+}
+
+/// Draw a triangle, clipped to a tile.
+///
+/// A pixel is covered if its center is inside the triangle. Pixels whose
+/// centers lie on an edge shared by two triangles are covered by exactly
+/// one of them, so that no pixel is blended twice.
+///
+inline void
+rasterizeTriangle(
+    Framebuffer& framebuffer,
+    const float* a,
+    const float* b,
+    const float* c,
+    const unsigned char* color,
+    const PixelRectangle& tile,
+    const RasterizerOptions& options
+) {
+    float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    if(!(area != 0)) { // degenerate or NaN
+        return;
+    }
+    if(area < 0) {
+        std::swap(b, c);
+        area = -area;
+    }
+    const float* vertices[] = {a, b, c};
+    float dx[3];
+    float dy[3];
+    bool topLeft[3]; // whether pixel centers on edge j are covered
+    for(std::size_t j = 0; j < 3; ++j) {
+        const float* p = vertices[j];
+        const float* q = vertices[(j + 1) % 3];
+        dx[j] = q[0] - p[0];
+        dy[j] = q[1] - p[1];
+        topLeft[j] = dy[j] < 0 || (dy[j] == 0 && dx[j] > 0);
+    }
+
+    const float minimumX = std::min(a[0], std::min(b[0], c[0]));
+    const float minimumY = std::min(a[1], std::min(b[1], c[1]));
+    const float maximumX = std::max(a[0], std::max(b[0], c[0]));
+    const float maximumY = std::max(a[1], std::max(b[1], c[1]));
+    const std::ptrdiff_t x0 = clampToInteger(std::ceil(minimumX - 0.5f), tile.x0_, tile.x1_);
+    const std::ptrdiff_t y0 = clampToInteger(std::ceil(minimumY - 0.5f), tile.y0_, tile.y1_);
+    const std::ptrdiff_t x1 = clampToInteger(std::floor(maximumX - 0.5f) + 1, tile.x0_, tile.x1_);
+    const std::ptrdiff_t y1 = clampToInteger(std::floor(maximumY - 0.5f) + 1, tile.y0_, tile.y1_);
+    for(std::ptrdiff_t y = y0; y < y1; ++y) {
+        const float cy = y + 0.5f;
+        for(std::ptrdiff_t x = x0; x < x1; ++x) {
+            const float cx = x + 0.5f;
+            // edge functions, evaluated directly such that they do not
+            // depend on the tile
+            float w[3];
+            bool inside = true;
+            for(std::size_t j = 0; j < 3; ++j) {
+                w[j] = dx[j] * (cy - vertices[j][1]) - dy[j] * (cx - vertices[j][0]);
+                if(w[j] < 0 || (w[j] == 0 && !topLeft[j])) {
+                    inside = false;
+                    break;
+                }
+            }
+            if(inside) {
+                // w[j] is the weight of the vertex opposite of edge j
+                const float depth = (w[1] * vertices[0][2] + w[2] * vertices[1][2] + w[0] * vertices[2][2]) / area;
+                shadeFragment(framebuffer, x, y, depth, color, options);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/// Rasterize a graphics into a framebuffer.
+///
+/// Points, lines and triangles are drawn in this order, each in the order
+/// of their indices, with depth test and alpha blending, as in the
+/// immediate mode of the viewer. The framebuffer is divided into tiles that
+/// are rasterized in parallel; the result does not depend on the number of
+/// threads.
+///
+/// \param graphics Graphics.
+/// \param projection Projection onto window coordinates in pixels with the
+///     origin at the top left corner, and depth, e.g. AffineProjection.
+/// \param framebuffer Framebuffer onto which the graphics is drawn.
+/// \param options Options.
+/// \param parallelOptions Parallel options.
+///
+template<class T, class S, class PROJECTION>
+void
+rasterize(
+    const Graphics<T, S>& graphics,
+    const PROJECTION& projection,
+    Framebuffer& framebuffer,
+    const RasterizerOptions& options = RasterizerOptions(),
+    const ParallelOptions& parallelOptions = ParallelOptions()
+) {
+    typedef typename PROJECTION::value_type projection_value_type;
+
+    const std::size_t width = framebuffer.width();
+    const std::size_t height = framebuffer.height();
+    if(width == 0 || height == 0) {
+        return;
+    }
+    const std::size_t tileSize = std::max(options.tileSize_, std::size_t(1));
+    const std::size_t numberOfColumns = (width + tileSize - 1) / tileSize;
+    const std::size_t numberOfRows = (height + tileSize - 1) / tileSize;
+    const std::size_t numberOfTiles = numberOfColumns * numberOfRows;
+
+    // window coordinates and depth of all points
+    std::vector<float> vertices(3 * static_cast<std::size_t>(graphics.numberOfPoints()));
+    parallelFor(graphics.numberOfPoints(), parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                const typename Graphics<T, S>::PointType& point = graphics.point(j);
+                projection_value_type r;
+                projection_value_type s;
+                projection_value_type depth;
+                projection(point[0], point[1], point[2], r, s, depth);
+                vertices[3 * j] = static_cast<float>(r);
+                vertices[3 * j + 1] = static_cast<float>(s);
+                vertices[3 * j + 2] = static_cast<float>(depth);
+            }
+        }
+    );
+    const float pointRadius = std::max(1.0f, options.pointSize_) / 2;
+    const float lineRadius = std::max(1.0f, options.lineWidth_) / 2;
+
+    detail::TileBins<S> pointBins;
+    detail::binPrimitives(graphics.numberOfPoints(), numberOfColumns, numberOfTiles,
+        [&](const std::size_t j, detail::PixelRectangle& tiles) {
+            if(!graphics.pointProperty(graphics.point(j).propertyIndex()).visibility()) {
+                return false;
+            }
+            const float* v = &vertices[3 * j];
+            return detail::tilesOfBox(v[0] - pointRadius, v[1] - pointRadius, v[0] + pointRadius, v[1] + pointRadius,
+                width, height, tileSize, tiles);
+        },
+        parallelOptions, pointBins
+    );
+    detail::TileBins<S> lineBins;
+    detail::binPrimitives(graphics.numberOfLines(), numberOfColumns, numberOfTiles,
+        [&](const std::size_t j, detail::PixelRectangle& tiles) {
+            const typename Graphics<T, S>::LineType& line = graphics.line(j);
+            if(!graphics.lineProperty(line.propertyIndex()).visibility()) {
+                return false;
+            }
+            const float* p = &vertices[3 * line.pointIndex(0)];
+            const float* q = &vertices[3 * line.pointIndex(1)];
+            return detail::tilesOfBox(std::min(p[0], q[0]) - lineRadius, std::min(p[1], q[1]) - lineRadius,
+                std::max(p[0], q[0]) + lineRadius, std::max(p[1], q[1]) + lineRadius,
+                width, height, tileSize, tiles);
+        },
+        parallelOptions, lineBins
+    );
+    detail::TileBins<S> triangleBins;
+    detail::binPrimitives(graphics.numberOfTriangles(), numberOfColumns, numberOfTiles,
+        [&](const std::size_t j, detail::PixelRectangle& tiles) {
+            const typename Graphics<T, S>::TriangleType& triangle = graphics.triangle(j);
+            if(!graphics.triangleProperty(triangle.propertyIndex()).visibility()) {
+                return false;
+            }
+            const float* a = &vertices[3 * triangle.pointIndex(0)];
+            const float* b = &vertices[3 * triangle.pointIndex(1)];
+            const float* c = &vertices[3 * triangle.pointIndex(2)];
+            return detail::tilesOfBox(std::min(a[0], std::min(b[0], c[0])), std::min(a[1], std::min(b[1], c[1])),
+                std::max(a[0], std::max(b[0], c[0])), std::max(a[1], std::max(b[1], c[1])),
+                width, height, tileSize, tiles);
+        },
+        parallelOptions, triangleBins
+    );
+
+    // rasterize tiles, each thread taking the next tile as soon as it is done
+    std::atomic<std::size_t> nextTile(0);
+    parallelFor(numberOfTiles, parallelOptions,
+        [&](const std::size_t, const std::size_t, const std::size_t) {
+            for(std::size_t t = nextTile++; t < numberOfTiles; t = nextTile++) {
+                detail::PixelRectangle tile;
+                tile.x0_ = static_cast<std::ptrdiff_t>((t % numberOfColumns) * tileSize);
+                tile.y0_ = static_cast<std::ptrdiff_t>((t / numberOfColumns) * tileSize);
+                tile.x1_ = static_cast<std::ptrdiff_t>(std::min((t % numberOfColumns + 1) * tileSize, width));
+                tile.y1_ = static_cast<std::ptrdiff_t>(std::min((t / numberOfColumns + 1) * tileSize, height));
+
+                for(std::size_t m = pointBins.offsets_[t]; m < pointBins.offsets_[t + 1]; ++m) {
+                    const typename Graphics<T, S>::PointType& point = graphics.point(pointBins.indices_[m]);
+                    const typename Graphics<T, S>::PointPropertyType& property = graphics.pointProperty(point.propertyIndex());
+                    const unsigned char color[] = {property.color(0), property.color(1), property.color(2), property.alpha()};
+                    detail::rasterizePoint(framebuffer, &vertices[3 * pointBins.indices_[m]], color, tile, options);
+                }
+                for(std::size_t m = lineBins.offsets_[t]; m < lineBins.offsets_[t + 1]; ++m) {
+                    const typename Graphics<T, S>::LineType& line = graphics.line(lineBins.indices_[m]);
+                    const typename Graphics<T, S>::LinePropertyType& property = graphics.lineProperty(line.propertyIndex());
+                    const unsigned char color[] = {property.color(0), property.color(1), property.color(2), property.alpha()};
+                    detail::rasterizeLine(framebuffer, &vertices[3 * line.pointIndex(0)], &vertices[3 * line.pointIndex(1)], color, tile, options);
+                }
+                for(std::size_t m = triangleBins.offsets_[t]; m < triangleBins.offsets_[t + 1]; ++m) {
+                    const typename Graphics<T, S>::TriangleType& triangle = graphics.triangle(triangleBins.indices_[m]);
+                    const typename Graphics<T, S>::TrianglePropertyType& property = graphics.triangleProperty(triangle.propertyIndex());
+                    const unsigned char color[] = {property.color(0), property.color(1), property.color(2), property.alpha()};
+                    detail::rasterizeTriangle(framebuffer, &vertices[3 * triangle.pointIndex(0)], &vertices[3 * triangle.pointIndex(1)],
+                        &vertices[3 * triangle.pointIndex(2)], color, tile, options);
+                }
+            }
+        },
+        1
+    );
+}
+
+/// Save the color channels of a framebuffer as binary PPM (P6) image.
+///
+/// \returns Number of bytes written.
+///
+inline std::size_t
+savePPM(
+    const Framebuffer& framebuffer,
+    std::ostream& out
+) {
+    const std::string header = "P6\n" + std::to_string(framebuffer.width()) + " "
+        + std::to_string(framebuffer.height()) + "\n255\n";
+    out << header;
+    std::vector<unsigned char> row(3 * framebuffer.width());
+    for(std::size_t y = 0; y < framebuffer.height(); ++y) {
+        for(std::size_t x = 0; x < framebuffer.width(); ++x) {
+            const unsigned char* p = framebuffer.pixel(x, y);
+            row[3 * x] = p[0];
+            row[3 * x + 1] = p[1];
+            row[3 * x + 2] = p[2];
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    if(!out) {
+        throw std::runtime_error("error writing PPM image.");
+    }
+    return header.size() + row.size() * framebuffer.height();
+}
+
+namespace detail {
+
+inline std::uint32_t
+crc32(
+    std::uint32_t crc,
+    const unsigned char* data,
+    const std::size_t size
+) {
+    struct Table {
+        Table()
+            {
+                for(std::uint32_t j = 0; j < 256; ++j) {
+                    std::uint32_t c = j;
+                    for(std::size_t k = 0; k < 8; ++k) {
+                        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    }
+                    entries_[j] = c;
+                }
+            }
+        std::uint32_t entries_[256];
+    };
+    static const Table table;
+
+    crc = ~crc;
+    for(std::size_t j = 0; j < size; ++j) {
+        crc = table.entries_[(crc ^ data[j]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+class PNGWriter {
+public:
+    PNGWriter(std::ostream& out)
+        : out_(out), bytes_(0)
+        {}
+    void chunk(const char* type, const unsigned char* data, const std::size_t size)
+        {
+            unsigned char header[8];
+            bigEndian(static_cast<std::uint32_t>(size), header);
+            std::copy(type, type + 4, header + 4);
+            unsigned char footer[4];
+            bigEndian(crc32(crc32(0, header + 4, 4), data, size), footer);
+            out_.write(reinterpret_cast<const char*>(header), 8);
+            out_.write(reinterpret_cast<const char*>(data), size);
+            out_.write(reinterpret_cast<const char*>(footer), 4);
+            bytes_ += size + 12;
+        }
+    void write(const unsigned char* data, const std::size_t size)
+        {
+            out_.write(reinterpret_cast<const char*>(data), size);
+            bytes_ += size;
+        }
+    std::size_t bytesWritten() const
+        { return bytes_; }
+    static void bigEndian(const std::uint32_t value, unsigned char* out)
+        {
+            out[0] = static_cast<unsigned char>(value >> 24);
+            out[1] = static_cast<unsigned char>(value >> 16);
+            out[2] = static_cast<unsigned char>(value >> 8);
+            out[3] = static_cast<unsigned char>(value);
+        }
+
+private:
+    std::ostream& out_;
+    std::size_t bytes_;
+};
+
+} // namespace detail
+
+/// Save a framebuffer as PNG image (8-bit RGBA).
+///
+/// Rows are filtered by the Up filter. Without zlib, i.e. if
+/// ANDRES_GRAPHICS_WITH_ZLIB is not defined, the image data is stored
+/// uncompressed.
+///
+/// \param framebuffer Framebuffer.
+/// \param out Output stream, opened in binary mode.
+/// \param compressionLevel zlib compression level (1-9).
+/// \returns Number of bytes written.
+///
+inline std::size_t
+savePNG(
+    const Framebuffer& framebuffer,
+    std::ostream& out,
+    const int compressionLevel = 6
+) {
+    const std::size_t width = framebuffer.width();
+    const std::size_t height = framebuffer.height();
+    if(width == 0 || height == 0) {
+        throw std::runtime_error("PNG images must not be empty.");
+    }
+    if(width > 0x7fffffff || height > 0x7fffffff) {
+        throw std::runtime_error("framebuffer too large for PNG.");
+    }
+
+    detail::PNGWriter writer(out);
+    const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    writer.write(signature, 8);
+    unsigned char header[13];
+    detail::PNGWriter::bigEndian(static_cast<std::uint32_t>(width), header);
+    detail::PNGWriter::bigEndian(static_cast<std::uint32_t>(height), header + 4);
+    header[8] = 8; // bit depth
+    header[9] = 6; // color type RGBA
+    header[10] = 0; // compression
+    header[11] = 0; // filter
+    header[12] = 0; // no interlace
+    writer.chunk("IHDR", header, 13);
+
+    // filtered rows
+    const std::size_t rowSize = 1 + 4 * width;
+    std::vector<unsigned char> row(rowSize);
+    const auto filter = [&](const std::size_t y) {
+        row[0] = 2; // Up
+        const unsigned char* p = framebuffer.pixel(0, y);
+        if(y == 0) {
+            std::copy(p, p + 4 * width, row.begin() + 1);
+        }
+        else {
+            const unsigned char* above = framebuffer.pixel(0, y - 1);
+            for(std::size_t j = 0; j < 4 * width; ++j) {
+                row[1 + j] = static_cast<unsigned char>(p[j] - above[j]);
+            }
+        }
+    };
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+    std::vector<unsigned char> buffer(1 << 16);
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    if(deflateInit(&stream, compressionLevel) != Z_OK) {
+        throw std::runtime_error("error initializing zlib.");
+    }
+    stream.next_out = buffer.data();
+    stream.avail_out = static_cast<uInt>(buffer.size());
+    for(std::size_t y = 0; y < height; ++y) {
+        filter(y);
+        stream.next_in = row.data();
+        stream.avail_in = static_cast<uInt>(row.size());
+        const int flush = y + 1 == height ? Z_FINISH : Z_NO_FLUSH;
+        for(;;) {
+            const int status = deflate(&stream, flush);
+            if(status == Z_STREAM_ERROR) {
+                deflateEnd(&stream);
+                throw std::runtime_error("error compressing PNG image.");
+            }
+            if(stream.avail_out == 0) {
+                writer.chunk("IDAT", buffer.data(), buffer.size());
+                stream.next_out = buffer.data();
+                stream.avail_out = static_cast<uInt>(buffer.size());
+                continue;
+            }
+            if(flush == Z_FINISH ? status == Z_STREAM_END : stream.avail_in == 0) {
+                break;
+            }
+        }
+    }
+    if(stream.avail_out != buffer.size()) {
+        writer.chunk("IDAT", buffer.data(), buffer.size() - stream.avail_out);
+    }
+    deflateEnd(&stream);
+#else
+    // zlib stream of stored deflate blocks
+    (void)compressionLevel;
+    std::vector<unsigned char> data;
+    data.reserve(2 + rowSize * height + (rowSize * height / 65535 + 1) * 5 + 4);
+    data.push_back(0x78);
+    data.push_back(0x01);
+    std::uint32_t a = 1;
+    std::uint32_t b = 0;
+    std::size_t blockStart = 0; // position of the header of the current block
+    std::size_t blockSize = 0;
+    for(std::size_t y = 0; y < height; ++y) {
+        filter(y);
+        for(std::size_t j = 0; j < rowSize; ++j) {
+            if(blockSize == 0 || blockSize == 65535) {
+                blockStart = data.size();
+                data.insert(data.end(), 5, 0);
+                blockSize = 0;
+            }
+            data.push_back(row[j]);
+            ++blockSize;
+            data[blockStart + 1] = static_cast<unsigned char>(blockSize);
+            data[blockStart + 2] = static_cast<unsigned char>(blockSize >> 8);
+            data[blockStart + 3] = static_cast<unsigned char>(~blockSize);
+            data[blockStart + 4] = static_cast<unsigned char>(~blockSize >> 8);
+            a = (a + row[j]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    data[blockStart] = 1; // final block
+    data.resize(data.size() + 4);
+    detail::PNGWriter::bigEndian((b << 16) | a, &data[data.size() - 4]);
+    writer.chunk("IDAT", data.data(), data.size());
+#endif
+
+    writer.chunk("IEND", 0, 0);
+    if(!out) {
+        throw std::runtime_error("error writing PNG image.");
+    }
+    return writer.bytesWritten();
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_RASTERIZER_HXX
@@ -0,0 +1,397 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_SIMD_HXX
+#define ANDRES_GRAPHICS_SIMD_HXX
+
+#include <cstddef>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace andres {
+namespace graphics {
+
+/// Reductions and transforms over contiguous coordinate arrays.
+///
+/// The functions for float are vectorized with AVX if the code is compiled
+/// with AVX support (e.g. -mavx or -march=native), with SSE otherwise, and
+/// fall back to scalar code on other architectures. All functions return
+/// results bit-identical to the scalar loops in Graphics: NaN coordinates
+/// are ignored by minimum and maximum, and divisions are not replaced by
+/// multiplications with the reciprocal.
+///
+namespace simd {
+
+template<class T>
+inline void
+minMaxScalar(
+    const T* data,
+    const std::size_t size,
+    T& minimum,
+    T& maximum
+) {
+    for(std::size_t j = 0; j < size; ++j) {
+        if(data[j] < minimum) {
+            minimum = data[j];
+        }
+        if(data[j] > maximum) {
+            maximum = data[j];
+        }
+    }
+}
+
+template<class T>
+inline T
+maxAbsScalar(
+    const T* data,
+    const std::size_t size,
+    T maximum = 0
+) {
+    for(std::size_t j = 0; j < size; ++j) {
+        const T value = std::abs(data[j]);
+        if(value > maximum) {
+            maximum = value;
+        }
+    }
+    return maximum;
+}
+
+template<class T>
+inline T
+maxSquaredNormScalar(
+    const T* x,
+    const T* y,
+    const T* z,
+    const std::size_t size,
+    T maximum = 0
+) {
+    for(std::size_t j = 0; j < size; ++j) {
+        T value = 0;
+        value += x[j] * x[j];
+        value += y[j] * y[j];
+        if(z != 0) {
+            value += z[j] * z[j];
+        }
+        if(value > maximum) {
+            maximum = value;
+        }
+    }
+    return maximum;
+}
+
+template<class T>
+inline void
+subtractScalar(
+    T* data,
+    const std::size_t size,
+    const T value
+) {
+    for(std::size_t j = 0; j < size; ++j) {
+        data[j] -= value;
+    }
+}
+
+template<class T>
+inline void
+divideScalar(
+    T* data,
+    const std::size_t size,
+    const T value
+) {
+    for(std::size_t j = 0; j < size; ++j) {
+        data[j] /= value;
+    }
+}
+
+template<class T>
+inline void
+minMax(const T* data, const std::size_t size, T& minimum, T& maximum)
+    { minMaxScalar(data, size, minimum, maximum); }
+
+template<class T>
+inline T
+maxAbs(const T* data, const std::size_t size, T maximum = 0)
+    { return maxAbsScalar(data, size, maximum); }
+
+/// Maximum of x[j]^2 + y[j]^2 + z[j]^2 over all j, where z can be null.
+template<class T>
+inline T
+maxSquaredNorm(const T* x, const T* y, const T* z, const std::size_t size, T maximum = 0)
+    { return maxSquaredNormScalar(x, y, z, size, maximum); }
+
+template<class T>
+inline void
+subtract(T* data, const std::size_t size, const T value)
+    { subtractScalar(data, size, value); }
+
+template<class T>
+inline void
+divide(T* data, const std::size_t size, const T value)
+    { divideScalar(data, size, value); }
+
+#if defined(__AVX__)
+
+inline float horizontalMin(const __m256 v) {
+    float buffer[8];
+    _mm256_storeu_ps(buffer, v);
+    float result = buffer[0];
+    for(std::size_t j = 1; j < 8; ++j) {
+        if(buffer[j] < result) {
+            result = buffer[j];
+        }
+    }
+    return result;
+}
+
+inline float horizontalMax(const __m256 v) {
+    float buffer[8];
+    _mm256_storeu_ps(buffer, v);
+    float result = buffer[0];
+    for(std::size_t j = 1; j < 8; ++j) {
+        if(buffer[j] > result) {
+            result = buffer[j];
+        }
+    }
+    return result;
+}
+
+template<>
+inline void
+minMax<float>(
+    const float* data,
+    const std::size_t size,
+    float& minimum,
+    float& maximum
+) {
+    const std::size_t sizeVectorized = size - size % 8;
+    if(sizeVectorized != 0) {
+        // min_ps(x, m) returns m if x is NaN
+        __m256 vectorMin = _mm256_set1_ps(minimum);
+        __m256 vectorMax = _mm256_set1_ps(maximum);
+        for(std::size_t j = 0; j < sizeVectorized; j += 8) {
+            const __m256 x = _mm256_loadu_ps(data + j);
+            vectorMin = _mm256_min_ps(x, vectorMin);
+            vectorMax = _mm256_max_ps(x, vectorMax);
+        }
+        minimum = horizontalMin(vectorMin);
+        maximum = horizontalMax(vectorMax);
+    }
+    minMaxScalar(data + sizeVectorized, size - sizeVectorized, minimum, maximum);
+}
+
+template<>
+inline float
+maxAbs<float>(
+    const float* data,
+    const std::size_t size,
+    float maximum
+) {
+    const std::size_t sizeVectorized = size - size % 8;
+    if(sizeVectorized != 0) {
+        const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 vectorMax = _mm256_set1_ps(maximum);
+        for(std::size_t j = 0; j < sizeVectorized; j += 8) {
+            const __m256 x = _mm256_and_ps(_mm256_loadu_ps(data + j), mask);
+            vectorMax = _mm256_max_ps(x, vectorMax);
+        }
+        maximum = horizontalMax(vectorMax);
+    }
+    return maxAbsScalar(data + sizeVectorized, size - sizeVectorized, maximum);
+}
+
+template<>
+inline float
+maxSquaredNorm<float>(
+    const float* x,
+    const float* y,
+    const float* z,
+    const std::size_t size,
+    float maximum
+) {
+    const std::size_t sizeVectorized = size - size % 8;
+    if(sizeVectorized != 0) {
+        __m256 vectorMax = _mm256_set1_ps(maximum);
+        for(std::size_t j = 0; j < sizeVectorized; j += 8) {
+            const __m256 vx = _mm256_loadu_ps(x + j);
+            const __m256 vy = _mm256_loadu_ps(y + j);
+            __m256 value = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+            if(z != 0) {
+                const __m256 vz = _mm256_loadu_ps(z + j);
+                value = _mm256_add_ps(value, _mm256_mul_ps(vz, vz));
+            }
+            vectorMax = _mm256_max_ps(value, vectorMax);
+        }
+        maximum = horizontalMax(vectorMax);
+    }
+    return maxSquaredNormScalar(x + sizeVectorized, y + sizeVectorized,
+        z == 0 ? 0 : z + sizeVectorized, size - sizeVectorized, maximum);
+}
+
+template<>
+inline void
+subtract<float>(
+    float* data,
+    const std::size_t size,
+    const float value
+) {
+    const std::size_t sizeVectorized = size - size % 8;
+    const __m256 v = _mm256_set1_ps(value);
+    for(std::size_t j = 0; j < sizeVectorized; j += 8) {
+        _mm256_storeu_ps(data + j, _mm256_sub_ps(_mm256_loadu_ps(data + j), v));
+    }
+    subtractScalar(data + sizeVectorized, size - sizeVectorized, value);
+}
+
+template<>
+inline void
+divide<float>(
+    float* data,
+    const std::size_t size,
+    const float value
+) {
+    const std::size_t sizeVectorized = size - size % 8;
+    const __m256 v = _mm256_set1_ps(value);
+    for(std::size_t j = 0; j < sizeVectorized; j += 8) {
+        _mm256_storeu_ps(data + j, _mm256_div_ps(_mm256_loadu_ps(data + j), v));
+    }
+    divideScalar(data + sizeVectorized, size - sizeVectorized, value);
+}
+
+#elif defined(__SSE2__)
+
+inline float horizontalMin(const __m128 v) {
+    float buffer[4];
+    _mm_storeu_ps(buffer, v);
+    float result = buffer[0];
+    for(std::size_t j = 1; j < 4; ++j) {
+        if(buffer[j] < result) {
+            result = buffer[j];
+        }
+    }
+    return result;
+}
+
+inline float horizontalMax(const __m128 v) {
+    float buffer[4];
+    _mm_storeu_ps(buffer, v);
+    float result = buffer[0];
+    for(std::size_t j = 1; j < 4; ++j) {
+        if(buffer[j] > result) {
+            result = buffer[j];
+        }
+    }
+    return result;
+}
+
+template<>
+inline void
+minMax<float>(
+    const float* data,
+    const std::size_t size,
+    float& minimum,
+    float& maximum
+) {
+    const std::size_t sizeVectorized = size - size % 4;
+    if(sizeVectorized != 0) {
+        // min_ps(x, m) returns m if x is NaN
+        __m128 vectorMin = _mm_set1_ps(minimum);
+        __m128 vectorMax = _mm_set1_ps(maximum);
+        for(std::size_t j = 0; j < sizeVectorized; j += 4) {
+            const __m128 x = _mm_loadu_ps(data + j);
+            vectorMin = _mm_min_ps(x, vectorMin);
+            vectorMax = _mm_max_ps(x, vectorMax);
+        }
+        minimum = horizontalMin(vectorMin);
+        maximum = horizontalMax(vectorMax);
+    }
+    minMaxScalar(data + sizeVectorized, size - sizeVectorized, minimum, maximum);
+}
+
+template<>
+inline float
+maxAbs<float>(
+    const float* data,
+    const std::size_t size,
+    float maximum
+) {
+    const std::size_t sizeVectorized = size - size % 4;
+    if(sizeVectorized != 0) {
+        const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 vectorMax = _mm_set1_ps(maximum);
+        for(std::size_t j = 0; j < sizeVectorized; j += 4) {
+            const __m128 x = _mm_and_ps(_mm_loadu_ps(data + j), mask);
+            vectorMax = _mm_max_ps(x, vectorMax);
+        }
+        maximum = horizontalMax(vectorMax);
+    }
+    return maxAbsScalar(data + sizeVectorized, size - sizeVectorized, maximum);
+}
+
+template<>
+inline float
+maxSquaredNorm<float>(
+    const float* x,
+    const float* y,
+    const float* z,
+    const std::size_t size,
+    float maximum
+) {
+    const std::size_t sizeVectorized = size - size % 4;
+    if(sizeVectorized != 0) {
+        __m128 vectorMax = _mm_set1_ps(maximum);
+        for(std::size_t j = 0; j < sizeVectorized; j += 4) {
+            const __m128 vx = _mm_loadu_ps(x + j);
+            const __m128 vy = _mm_loadu_ps(y + j);
+            __m128 value = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+            if(z != 0) {
+                const __m128 vz = _mm_loadu_ps(z + j);
+                value = _mm_add_ps(value, _mm_mul_ps(vz, vz));
+            }
+            vectorMax = _mm_max_ps(value, vectorMax);
+        }
+        maximum = horizontalMax(vectorMax);
+    }
+    return maxSquaredNormScalar(x + sizeVectorized, y + sizeVectorized,
+        z == 0 ? 0 : z + sizeVectorized, size - sizeVectorized, maximum);
+}
+
+template<>
+inline void
+subtract<float>(
+    float* data,
+    const std::size_t size,
+    const float value
+) {
+    const std::size_t sizeVectorized = size - size % 4;
+    const __m128 v = _mm_set1_ps(value);
+    for(std::size_t j = 0; j < sizeVectorized; j += 4) {
+        _mm_storeu_ps(data + j, _mm_sub_ps(_mm_loadu_ps(data + j), v));
+    }
+    subtractScalar(data + sizeVectorized, size - sizeVectorized, value);
+}
+
+template<>
+inline void
+divide<float>(
+    float* data,
+    const std::size_t size,
+    const float value
+) {
+    const std::size_t sizeVectorized = size - size % 4;
+    const __m128 v = _mm_set1_ps(value);
+    for(std::size_t j = 0; j < sizeVectorized; j += 4) {
+        _mm_storeu_ps(data + j, _mm_div_ps(_mm_loadu_ps(data + j), v));
+    }
+    divideScalar(data + sizeVectorized, size - sizeVectorized, value);
+}
+
+#endif
+
+} // namespace simd
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_SIMD_HXX
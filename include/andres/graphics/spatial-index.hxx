@@ -0,0 +1,1139 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_SPATIAL_INDEX_HXX
+#define ANDRES_GRAPHICS_SPATIAL_INDEX_HXX
+
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "graphics.hxx"
+#include "parallel.hxx"
+
+namespace andres {
+namespace graphics {
+
+/// Kinds of primitives.
+///
+enum PrimitiveKind {
+    NoPrimitive,
+    PointPrimitive,
+    LinePrimitive,
+    TrianglePrimitive
+};
+
+/// Primitive hit by a ray, see SpatialIndex::pick().
+///
+template<class T = float, class S = std::size_t>
+struct Pick {
+    typedef T value_type;
+    typedef S size_type;
+
+    Pick()
+        :   kind_(NoPrimitive),
+            index_(0),
+            distance_(std::numeric_limits<value_type>::infinity())
+        {}
+
+    PrimitiveKind kind_;
+    size_type index_;
+    value_type distance_; // along the ray, in units of its direction
+};
+
+namespace detail {
+
+/// Bounding volume hierarchy over a range of primitives given by their
+/// axis-aligned bounding boxes.
+///
+/// Nodes are split where the surface area heuristic, evaluated at the
+/// boundaries of a fixed number of bins of the box centers, is minimal.
+/// Unlike median splits along the axis of largest extent, this does not
+/// cut surfaces into thin slabs whose boxes overlap in the view direction.
+/// Nodes are stored in preorder: the left child of a node is the next
+/// node. Subtrees near the root are built in parallel into separate node
+/// vectors that are concatenated afterwards.
+///
+template<class T, class S>
+class BoundingVolumeHierarchy {
+public:
+    typedef T value_type;
+    typedef S size_type;
+
+    static const std::size_t leafSize = 8;
+    static const std::size_t numberOfBins = 16;
+
+    struct Node {
+        bool isLeaf() const
+            { return right_ == 0; }
+
+        value_type box_[6]; // minimum and maximum coordinates
+        std::size_t first_; // position of the first primitive in indices()
+        std::size_t size_; // number of primitives
+        std::size_t right_; // index of the right child, 0 for leaves
+    };
+
+    BoundingVolumeHierarchy()
+        : first_(0), nodes_(), indices_()
+        {}
+    template<class BOX_OF>
+    void build(const size_type, const size_type, BOX_OF, const ParallelOptions&);
+    template<class BOX_OF>
+    void refit(BOX_OF);
+    size_type first() const
+        { return first_; }
+    size_type end() const
+        { return first_ + static_cast<size_type>(indices_.size()); }
+    std::size_t size() const
+        { return indices_.size(); }
+    const std::vector<Node>& nodes() const
+        { return nodes_; }
+    const std::vector<size_type>& indices() const
+        { return indices_; }
+
+private:
+    std::size_t split(const std::size_t, const std::size_t, const value_type*, const std::vector<value_type>&);
+    void buildNode(std::vector<Node>&, const std::size_t, const std::size_t, const std::vector<value_type>&, const std::size_t);
+
+    size_type first_;
+    std::vector<Node> nodes_;
+    std::vector<size_type> indices_;
+};
+
+/// Build the tree over the primitives [first, end).
+///
+/// \param boxOf Function boxOf(index, box) that writes the minimum and
+///     maximum coordinates of the primitive with the given index to box.
+///
+template<class T, class S>
+template<class BOX_OF>
+void
+BoundingVolumeHierarchy<T, S>::build(
+    const size_type first,
+    const size_type end,
+    BOX_OF boxOf,
+    const ParallelOptions& parallelOptions
+) {
+    const std::size_t size = end - first;
+    first_ = first;
+    indices_.resize(size);
+    nodes_.clear();
+    if(size == 0) {
+        return;
+    }
+
+    std::vector<value_type> boxes(6 * size);
+    parallelFor(size, parallelOptions,
+        [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+            for(std::size_t j = begin; j < end; ++j) {
+                indices_[j] = first + static_cast<size_type>(j);
+                boxOf(indices_[j], &boxes[6 * j]);
+            }
+        }
+    );
+
+    std::size_t depth = 0; // number of levels at which subtrees are built in parallel
+    for(std::size_t n = parallelOptions.numberOfThreads(); n > 1; n /= 2) {
+        ++depth;
+    }
+    nodes_.reserve(4 * size / leafSize + 1);
+    buildNode(nodes_, 0, size, boxes, depth);
+}
+
+/// Partition the primitives [first, first + size) and return the size of
+/// the left part.
+///
+template<class T, class S>
+std::size_t
+BoundingVolumeHierarchy<T, S>::split(
+    const std::size_t first,
+    const std::size_t size,
+    const value_type* centers,
+    const std::vector<value_type>& boxes
+) {
+    struct Bin {
+        value_type box_[6];
+        std::size_t size_;
+    };
+    const size_type offset = first_;
+    const auto center = [&](const size_type j, const std::size_t k) {
+        return (boxes[6 * (j - offset) + k] + boxes[6 * (j - offset) + 3 + k]) / 2;
+    };
+    const auto area = [](const value_type* box) {
+        const value_type d[] = {box[3] - box[0], box[4] - box[1], box[5] - box[2]};
+        return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+    };
+
+    // for each axis, bin the primitives by their centers
+    Bin bins[3][numberOfBins];
+    for(std::size_t k = 0; k < 3; ++k) {
+        for(std::size_t b = 0; b < numberOfBins; ++b) {
+            for(std::size_t c = 0; c < 3; ++c) {
+                bins[k][b].box_[c] = std::numeric_limits<value_type>::infinity();
+                bins[k][b].box_[3 + c] = -std::numeric_limits<value_type>::infinity();
+            }
+            bins[k][b].size_ = 0;
+        }
+    }
+    value_type scales[3];
+    for(std::size_t k = 0; k < 3; ++k) {
+        const value_type extent = centers[3 + k] - centers[k];
+        scales[k] = extent > 0 ? numberOfBins / extent : 0;
+    }
+    for(std::size_t j = first; j < first + size; ++j) {
+        const value_type* box = &boxes[6 * (indices_[j] - offset)];
+        for(std::size_t k = 0; k < 3; ++k) {
+            const std::size_t b = std::min(static_cast<std::size_t>((center(indices_[j], k) - centers[k]) * scales[k]), numberOfBins - 1);
+            Bin& bin = bins[k][b];
+            for(std::size_t c = 0; c < 3; ++c) {
+                bin.box_[c] = std::min(bin.box_[c], box[c]);
+                bin.box_[3 + c] = std::max(bin.box_[3 + c], box[3 + c]);
+            }
+            ++bin.size_;
+        }
+    }
+
+    // split between the bins where the surface area heuristic is minimal
+    value_type bestCost = std::numeric_limits<value_type>::infinity();
+    std::size_t bestAxis = 0;
+    std::size_t bestBin = 0;
+    for(std::size_t k = 0; k < 3; ++k) {
+        if(scales[k] == 0) {
+            continue;
+        }
+        value_type costs[numberOfBins] = {};
+        Bin sum = bins[k][0];
+        for(std::size_t b = 1; b < numberOfBins; ++b) { // left parts
+            costs[b] = sum.size_ * area(sum.box_);
+            for(std::size_t c = 0; c < 3; ++c) {
+                sum.box_[c] = std::min(sum.box_[c], bins[k][b].box_[c]);
+                sum.box_[3 + c] = std::max(sum.box_[3 + c], bins[k][b].box_[3 + c]);
+            }
+            sum.size_ += bins[k][b].size_;
+        }
+        sum = bins[k][numberOfBins - 1];
+        for(std::size_t b = numberOfBins - 1; b > 0; --b) { // right parts
+            if(sum.size_ != 0 && sum.size_ != size) {
+                const value_type cost = costs[b] + sum.size_ * area(sum.box_);
+                if(cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = k;
+                    bestBin = b;
+                }
+            }
+            for(std::size_t c = 0; c < 3; ++c) {
+                sum.box_[c] = std::min(sum.box_[c], bins[k][b - 1].box_[c]);
+                sum.box_[3 + c] = std::max(sum.box_[3 + c], bins[k][b - 1].box_[3 + c]);
+            }
+            sum.size_ += bins[k][b - 1].size_;
+        }
+    }
+
+    if(bestCost == std::numeric_limits<value_type>::infinity()) {
+        // all centers coincide
+        return size / 2;
+    }
+    const value_type minimum = centers[bestAxis];
+    const value_type scale = scales[bestAxis];
+    return std::partition(indices_.begin() + first, indices_.begin() + first + size,
+        [&](const size_type j) {
+            return std::min(static_cast<std::size_t>((center(j, bestAxis) - minimum) * scale), numberOfBins - 1) < bestBin;
+        }
+    ) - (indices_.begin() + first);
+}
+
+template<class T, class S>
+void
+BoundingVolumeHierarchy<T, S>::buildNode(
+    std::vector<Node>& nodes,
+    const std::size_t first,
+    const std::size_t size,
+    const std::vector<value_type>& boxes,
+    const std::size_t parallelDepth
+) {
+    const std::size_t nodeIndex = nodes.size();
+    nodes.push_back(Node());
+    Node& node = nodes.back();
+    node.first_ = first;
+    node.size_ = size;
+    node.right_ = 0;
+
+    // bounding box and bounds of the box centers
+    value_type centers[6];
+    for(std::size_t k = 0; k < 3; ++k) {
+        node.box_[k] = centers[k] = std::numeric_limits<value_type>::infinity();
+        node.box_[3 + k] = centers[3 + k] = -std::numeric_limits<value_type>::infinity();
+    }
+    for(std::size_t j = first; j < first + size; ++j) {
+        const value_type* box = &boxes[6 * (indices_[j] - first_)];
+        for(std::size_t k = 0; k < 3; ++k) {
+            node.box_[k] = std::min(node.box_[k], box[k]);
+            node.box_[3 + k] = std::max(node.box_[3 + k], box[3 + k]);
+            const value_type center = (box[k] + box[3 + k]) / 2;
+            centers[k] = std::min(centers[k], center);
+            centers[3 + k] = std::max(centers[3 + k], center);
+        }
+    }
+    if(size <= leafSize) {
+        return;
+    }
+
+    const std::size_t sizeLeft = split(first, size, centers, boxes);
+    if(parallelDepth > 0 && size >= (1 << 14)) {
+        std::vector<Node> nodesRight;
+        nodesRight.reserve(4 * (size - sizeLeft) / leafSize + 1);
+        std::thread thread(&BoundingVolumeHierarchy<T, S>::buildNode, this,
+            std::ref(nodesRight), first + sizeLeft, size - sizeLeft, std::cref(boxes), parallelDepth - 1);
+        buildNode(nodes, first, sizeLeft, boxes, parallelDepth - 1);
+        thread.join();
+        const std::size_t offset = nodes.size();
+        nodes[nodeIndex].right_ = offset;
+        for(std::size_t j = 0; j < nodesRight.size(); ++j) {
+            if(!nodesRight[j].isLeaf()) {
+                nodesRight[j].right_ += offset;
+            }
+        }
+        nodes.insert(nodes.end(), nodesRight.begin(), nodesRight.end());
+    }
+    else {
+        buildNode(nodes, first, sizeLeft, boxes, 0);
+        nodes[nodeIndex].right_ = nodes.size();
+        buildNode(nodes, first + sizeLeft, size - sizeLeft, boxes, 0);
+    }
+}
+
+/// Recompute the bounding boxes of all nodes, e.g. after points have moved.
+///
+template<class T, class S>
+template<class BOX_OF>
+void
+BoundingVolumeHierarchy<T, S>::refit(
+    BOX_OF boxOf
+) {
+    // children are stored after their parents
+    for(std::size_t j = nodes_.size(); j > 0; --j) {
+        Node& node = nodes_[j - 1];
+        for(std::size_t k = 0; k < 3; ++k) {
+            node.box_[k] = std::numeric_limits<value_type>::infinity();
+            node.box_[3 + k] = -std::numeric_limits<value_type>::infinity();
+        }
+        if(node.isLeaf()) {
+            for(std::size_t m = node.first_; m < node.first_ + node.size_; ++m) {
+                value_type box[6];
+                boxOf(indices_[m], box);
+                for(std::size_t k = 0; k < 3; ++k) {
+                    node.box_[k] = std::min(node.box_[k], box[k]);
+                    node.box_[3 + k] = std::max(node.box_[3 + k], box[3 + k]);
+                }
+            }
+        }
+        else {
+            const Node& left = nodes_[j];
+            const Node& right = nodes_[node.right_];
+            for(std::size_t k = 0; k < 3; ++k) {
+                node.box_[k] = std::min(left.box_[k], right.box_[k]);
+                node.box_[3 + k] = std::max(left.box_[3 + k], right.box_[3 + k]);
+            }
+        }
+    }
+}
+
+template<class T>
+inline bool
+boxesIntersect(
+    const T* a,
+    const T* b
+) {
+    return a[0] <= b[3] && b[0] <= a[3]
+        && a[1] <= b[4] && b[1] <= a[4]
+        && a[2] <= b[5] && b[2] <= a[5];
+}
+
+template<class T>
+inline T
+squaredDistanceToBox(
+    const T* x,
+    const T* box
+) {
+    T result = 0;
+    for(std::size_t k = 0; k < 3; ++k) {
+        const T d = std::max(std::max(box[k] - x[k], x[k] - box[3 + k]), T(0));
+        result += d * d;
+    }
+    return result;
+}
+
+template<class T>
+inline bool
+segmentIntersectsBox(
+    const T* p,
+    const T* q,
+    const T* box
+) {
+    T t0 = 0;
+    T t1 = 1;
+    for(std::size_t k = 0; k < 3; ++k) {
+        const T d = q[k] - p[k];
+        if(d == 0) {
+            if(p[k] < box[k] || p[k] > box[3 + k]) {
+                return false;
+            }
+        }
+        else {
+            T a = (box[k] - p[k]) / d;
+            T b = (box[3 + k] - p[k]) / d;
+            if(a > b) {
+                std::swap(a, b);
+            }
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+            if(t0 > t1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Separating axis test of a triangle, translated such that the box is
+/// centered at the origin, and a box with the given half extents.
+///
+template<class T>
+inline bool
+separatedByAxis(
+    const T* axis,
+    const T (&v)[3][3],
+    const T* halfExtents
+) {
+    T minimum = std::numeric_limits<T>::infinity();
+    T maximum = -std::numeric_limits<T>::infinity();
+    for(std::size_t j = 0; j < 3; ++j) {
+        const T p = axis[0] * v[j][0] + axis[1] * v[j][1] + axis[2] * v[j][2];
+        minimum = std::min(minimum, p);
+        maximum = std::max(maximum, p);
+    }
+    const T r = halfExtents[0] * std::abs(axis[0]) + halfExtents[1] * std::abs(axis[1]) + halfExtents[2] * std::abs(axis[2]);
+    return minimum > r || maximum < -r;
+}
+
+template<class T>
+inline void
+cross(
+    const T* a,
+    const T* b,
+    T* result
+) {
+    result[0] = a[1] * b[2] - a[2] * b[1];
+    result[1] = a[2] * b[0] - a[0] * b[2];
+    result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+template<class T>
+inline T
+dot(
+    const T* a,
+    const T* b
+) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+template<class T>
+inline bool
+triangleIntersectsBox(
+    const T* v0,
+    const T* v1,
+    const T* v2,
+    const T* box
+) {
+    T halfExtents[3];
+    T v[3][3];
+    for(std::size_t k = 0; k < 3; ++k) {
+        const T center = (box[k] + box[3 + k]) / 2;
+        halfExtents[k] = (box[3 + k] - box[k]) / 2;
+        v[0][k] = v0[k] - center;
+        v[1][k] = v1[k] - center;
+        v[2][k] = v2[k] - center;
+    }
+    T edges[3][3];
+    for(std::size_t k = 0; k < 3; ++k) {
+        edges[0][k] = v[1][k] - v[0][k];
+        edges[1][k] = v[2][k] - v[1][k];
+        edges[2][k] = v[0][k] - v[2][k];
+    }
+
+    // axes of the box
+    for(std::size_t k = 0; k < 3; ++k) {
+        T axis[3] = {0, 0, 0};
+        axis[k] = 1;
+        if(separatedByAxis(axis, v, halfExtents)) {
+            return false;
+        }
+    }
+    // normal of the triangle
+    T axis[3];
+    cross(edges[0], edges[1], axis);
+    if(separatedByAxis(axis, v, halfExtents)) {
+        return false;
+    }
+    // cross products of the edges with the axes of the box
+    for(std::size_t j = 0; j < 3; ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            T unit[3] = {0, 0, 0};
+            unit[k] = 1;
+            cross(unit, edges[j], axis);
+            if(separatedByAxis(axis, v, halfExtents)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Entry distance of a ray into a box, or infinity if the ray misses the box.
+///
+template<class T>
+inline T
+rayBoxDistance(
+    const T* origin,
+    const T* direction,
+    const T* box
+) {
+    T t0 = 0;
+    T t1 = std::numeric_limits<T>::infinity();
+    for(std::size_t k = 0; k < 3; ++k) {
+        if(direction[k] == 0) {
+            if(origin[k] < box[k] || origin[k] > box[3 + k]) {
+                return std::numeric_limits<T>::infinity();
+            }
+        }
+        else {
+            T a = (box[k] - origin[k]) / direction[k];
+            T b = (box[3 + k] - origin[k]) / direction[k];
+            if(a > b) {
+                std::swap(a, b);
+            }
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+            if(t0 > t1) {
+                return std::numeric_limits<T>::infinity();
+            }
+        }
+    }
+    return t0;
+}
+
+/// Distance along a ray to a triangle (Moeller-Trumbore), or infinity.
+///
+template<class T>
+inline T
+rayTriangleDistance(
+    const T* origin,
+    const T* direction,
+    const T* v0,
+    const T* v1,
+    const T* v2
+) {
+    T e1[3];
+    T e2[3];
+    T s[3];
+    for(std::size_t k = 0; k < 3; ++k) {
+        e1[k] = v1[k] - v0[k];
+        e2[k] = v2[k] - v0[k];
+        s[k] = origin[k] - v0[k];
+    }
+    T p[3];
+    cross(direction, e2, p);
+    const T determinant = dot(e1, p);
+    if(std::abs(determinant) < std::numeric_limits<T>::epsilon() * dot(e1, e1) * dot(e2, e2)) {
+        return std::numeric_limits<T>::infinity(); // parallel or degenerate
+    }
+    const T u = dot(s, p) / determinant;
+    if(u < 0 || u > 1) {
+        return std::numeric_limits<T>::infinity();
+    }
+    T q[3];
+    cross(s, e1, q);
+    const T v = dot(direction, q) / determinant;
+    if(v < 0 || u + v > 1) {
+        return std::numeric_limits<T>::infinity();
+    }
+    const T t = dot(e2, q) / determinant;
+    return t >= 0 ? t : std::numeric_limits<T>::infinity();
+}
+
+/// Distance along a ray with unit direction to the point of closest
+/// approach to a segment, if the distance between ray and segment is at
+/// most tolerance, or infinity.
+///
+template<class T>
+inline T
+raySegmentDistance(
+    const T* origin,
+    const T* direction,
+    const T* p,
+    const T* q,
+    const T tolerance
+) {
+    T v[3];
+    T w[3];
+    for(std::size_t k = 0; k < 3; ++k) {
+        v[k] = q[k] - p[k];
+        w[k] = origin[k] - p[k];
+    }
+    const T b = dot(direction, v);
+    const T c = dot(v, v);
+    const T d = dot(direction, w);
+    const T e = dot(v, w);
+    const T denominator = c - b * b;
+    T s = denominator > 0 ? (e - b * d) / denominator : 0;
+    s = std::min(std::max(s, T(0)), T(1));
+    T t = s * b - d;
+    if(t < 0) {
+        t = 0;
+        s = c > 0 ? std::min(std::max(e / c, T(0)), T(1)) : 0;
+    }
+    T squaredDistance = 0;
+    for(std::size_t k = 0; k < 3; ++k) {
+        const T delta = origin[k] + t * direction[k] - p[k] - s * v[k];
+        squaredDistance += delta * delta;
+    }
+    return squaredDistance <= tolerance * tolerance ? t : std::numeric_limits<T>::infinity();
+}
+
+} // namespace detail
+
+/// Spatial index over the points, lines and triangles of a graphics.
+///
+/// The index consists of one bounding volume hierarchy per kind of
+/// primitive. Primitives defined after the index has been built are added
+/// by update() in a separate hierarchy. Whenever a hierarchy has grown to
+/// at least half the size of the hierarchy before it, the two are merged,
+/// such that there are at most logarithmically many hierarchies of
+/// geometrically decreasing size, and each primitive is re-indexed at
+/// most logarithmically often. Queries also scan the primitives defined
+/// since the last update() linearly. After points
+/// have moved (e.g. by Graphics::transform()), refit() recomputes the
+/// bounding boxes.
+///
+/// The graphics must outlive the index.
+///
+template<class T = float, class S = std::size_t>
+class SpatialIndex {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef Graphics<value_type, size_type> GraphicsType;
+    typedef Pick<value_type, size_type> PickType;
+
+    SpatialIndex(const GraphicsType&, const ParallelOptions& = ParallelOptions());
+    void build(const ParallelOptions& = ParallelOptions());
+    void update(const ParallelOptions& = ParallelOptions());
+    void refit();
+
+    void pointsInBox(const value_type*, const value_type*, std::vector<size_type>&) const;
+    void linesInBox(const value_type*, const value_type*, std::vector<size_type>&) const;
+    void trianglesInBox(const value_type*, const value_type*, std::vector<size_type>&) const;
+    void nearestPoints(const value_type*, const std::size_t, std::vector<size_type>&) const;
+    PickType pick(const value_type*, const value_type*, const value_type = 0) const;
+
+private:
+    typedef detail::BoundingVolumeHierarchy<value_type, size_type> Hierarchy;
+    typedef typename Hierarchy::Node Node;
+
+    typedef std::vector<Hierarchy> Hierarchies; // over consecutive ranges of primitives
+
+    void pointBox(const size_type, value_type*) const;
+    void lineBox(const size_type, value_type*) const;
+    void triangleBox(const size_type, value_type*) const;
+    template<class BOX_OF>
+    static void update(Hierarchies&, const size_type, BOX_OF, const ParallelOptions&);
+    static size_type end(const Hierarchies& hierarchies)
+        { return hierarchies.empty() ? 0 : hierarchies.back().end(); }
+    template<class INTERSECTS>
+    static void query(const Hierarchies&, const size_type, const value_type*, INTERSECTS, std::vector<size_type>&);
+    template<class DISTANCE>
+    static void pick(const Hierarchies&, const size_type, const value_type*, const value_type*, const value_type, DISTANCE, const PrimitiveKind, PickType&);
+
+    const GraphicsType& graphics_;
+    Hierarchies points_;
+    Hierarchies lines_;
+    Hierarchies triangles_;
+};
+
+/// Build a spatial index over all primitives of a graphics.
+///
+template<class T, class S>
+inline
+SpatialIndex<T, S>::SpatialIndex(
+    const GraphicsType& graphics,
+    const ParallelOptions& parallelOptions
+)
+:   graphics_(graphics),
+    points_(),
+    lines_(),
+    triangles_()
+{
+    build(parallelOptions);
+}
+
+/// Rebuild the index over all primitives.
+///
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::build(
+    const ParallelOptions& parallelOptions
+) {
+    points_.clear();
+    lines_.clear();
+    triangles_.clear();
+    update(parallelOptions);
+}
+
+/// Add the primitives defined since the last build() or update().
+///
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::update(
+    const ParallelOptions& parallelOptions
+) {
+    update(points_, graphics_.numberOfPoints(),
+        [this](const size_type j, value_type* box) { pointBox(j, box); }, parallelOptions);
+    update(lines_, graphics_.numberOfLines(),
+        [this](const size_type j, value_type* box) { lineBox(j, box); }, parallelOptions);
+    update(triangles_, graphics_.numberOfTriangles(),
+        [this](const size_type j, value_type* box) { triangleBox(j, box); }, parallelOptions);
+}
+
+/// Recompute the bounding boxes after points have moved.
+///
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::refit() {
+    for(std::size_t j = 0; j < points_.size(); ++j) {
+        points_[j].refit([this](const size_type k, value_type* box) { pointBox(k, box); });
+    }
+    for(std::size_t j = 0; j < lines_.size(); ++j) {
+        lines_[j].refit([this](const size_type k, value_type* box) { lineBox(k, box); });
+    }
+    for(std::size_t j = 0; j < triangles_.size(); ++j) {
+        triangles_[j].refit([this](const size_type k, value_type* box) { triangleBox(k, box); });
+    }
+}
+
+/// Points in a box.
+///
+/// \param minimum Minimum coordinates of the box.
+/// \param maximum Maximum coordinates of the box.
+/// \param result Vector to which the indices of the points are written.
+///
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::pointsInBox(
+    const value_type* minimum,
+    const value_type* maximum,
+    std::vector<size_type>& result
+) const {
+    const value_type box[] = {minimum[0], minimum[1], minimum[2], maximum[0], maximum[1], maximum[2]};
+    query(points_, graphics_.numberOfPoints(), box,
+        [this, &box](const size_type j) {
+            const typename GraphicsType::PointType& point = graphics_.point(j);
+            return point[0] >= box[0] && point[0] <= box[3]
+                && point[1] >= box[1] && point[1] <= box[4]
+                && point[2] >= box[2] && point[2] <= box[5];
+        },
+        result
+    );
+}
+
+/// Lines that intersect a box.
+///
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::linesInBox(
+    const value_type* minimum,
+    const value_type* maximum,
+    std::vector<size_type>& result
+) const {
+    const value_type box[] = {minimum[0], minimum[1], minimum[2], maximum[0], maximum[1], maximum[2]};
+    query(lines_, graphics_.numberOfLines(), box,
+        [this, &box](const size_type j) {
+            const typename GraphicsType::LineType& line = graphics_.line(j);
+            value_type p[3];
+            value_type q[3];
+            for(std::size_t k = 0; k < 3; ++k) {
+                p[k] = graphics_.point(line.pointIndex(0))[k];
+                q[k] = graphics_.point(line.pointIndex(1))[k];
+            }
+            return detail::segmentIntersectsBox(p, q, box);
+        },
+        result
+    );
+}
+
+/// Triangles that intersect a box.
+///
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::trianglesInBox(
+    const value_type* minimum,
+    const value_type* maximum,
+    std::vector<size_type>& result
+) const {
+    const value_type box[] = {minimum[0], minimum[1], minimum[2], maximum[0], maximum[1], maximum[2]};
+    query(triangles_, graphics_.numberOfTriangles(), box,
+        [this, &box](const size_type j) {
+            const typename GraphicsType::TriangleType& triangle = graphics_.triangle(j);
+            value_type v[3][3];
+            for(std::size_t m = 0; m < 3; ++m) {
+                for(std::size_t k = 0; k < 3; ++k) {
+                    v[m][k] = graphics_.point(triangle.pointIndex(m))[k];
+                }
+            }
+            return detail::triangleIntersectsBox(v[0], v[1], v[2], box);
+        },
+        result
+    );
+}
+
+/// The k points nearest to a position, in the order of their distance.
+///
+/// \param position Coordinates of the position.
+/// \param k Number of points.
+/// \param result Vector to which the indices of the points are written.
+///
+template<class T, class S>
+void
+SpatialIndex<T, S>::nearestPoints(
+    const value_type* position,
+    const std::size_t k,
+    std::vector<size_type>& result
+) const {
+    typedef std::pair<value_type, size_type> Candidate; // squared distance, point index
+    typedef std::pair<value_type, std::pair<std::size_t, std::size_t> > Entry; // squared distance, hierarchy, node
+
+    result.clear();
+    if(k == 0) {
+        return;
+    }
+    std::priority_queue<Candidate> candidates; // largest distance on top
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > entries; // smallest distance on top
+    for(std::size_t h = 0; h < points_.size(); ++h) {
+        if(!points_[h].nodes().empty()) {
+            entries.push(Entry(detail::squaredDistanceToBox(position, points_[h].nodes()[0].box_), std::make_pair(h, std::size_t(0))));
+        }
+    }
+    for(size_type j = end(points_); j < graphics_.numberOfPoints(); ++j) { // not yet indexed
+        entries.push(Entry(0, std::make_pair(points_.size(), static_cast<std::size_t>(j))));
+    }
+    while(!entries.empty()) {
+        const Entry entry = entries.top();
+        entries.pop();
+        if(candidates.size() == k && entry.first > candidates.top().first) {
+            break;
+        }
+        const std::size_t h = entry.second.first;
+        std::size_t first = entry.second.second;
+        std::size_t end = first + 1;
+        const size_type* indices = 0;
+        if(h < points_.size()) {
+            const Hierarchy& hierarchy = points_[h];
+            const Node& node = hierarchy.nodes()[entry.second.second];
+            if(!node.isLeaf()) {
+                const std::size_t children[] = {entry.second.second + 1, node.right_};
+                for(std::size_t c = 0; c < 2; ++c) {
+                    entries.push(Entry(detail::squaredDistanceToBox(position, hierarchy.nodes()[children[c]].box_), std::make_pair(h, children[c])));
+                }
+                continue;
+            }
+            first = node.first_;
+            end = node.first_ + node.size_;
+            indices = hierarchy.indices().data();
+        }
+        for(std::size_t m = first; m < end; ++m) {
+            const size_type j = indices == 0 ? static_cast<size_type>(m) : indices[m];
+            const typename GraphicsType::PointType& point = graphics_.point(j);
+            value_type squaredDistance = 0;
+            for(std::size_t c = 0; c < 3; ++c) {
+                squaredDistance += (point[c] - position[c]) * (point[c] - position[c]);
+            }
+            if(candidates.size() < k) {
+                candidates.push(Candidate(squaredDistance, j));
+            }
+            else if(squaredDistance < candidates.top().first) {
+                candidates.pop();
+                candidates.push(Candidate(squaredDistance, j));
+            }
+        }
+    }
+    result.resize(candidates.size());
+    for(std::size_t j = result.size(); j > 0; --j) {
+        result[j - 1] = candidates.top().second;
+        candidates.pop();
+    }
+}
+
+/// Visible primitive hit first by a ray.
+///
+/// Points and lines are hit if the distance between them and the ray is
+/// at most the tolerance.
+///
+/// \param origin Origin of the ray.
+/// \param direction Direction of the ray.
+/// \param tolerance Radius of points and lines.
+///
+template<class T, class S>
+typename SpatialIndex<T, S>::PickType
+SpatialIndex<T, S>::pick(
+    const value_type* origin,
+    const value_type* direction,
+    const value_type tolerance
+) const {
+    PickType result;
+    const value_type length = std::sqrt(detail::dot(direction, direction));
+    if(!(length > 0)) {
+        return result;
+    }
+    const value_type unit[] = {direction[0] / length, direction[1] / length, direction[2] / length};
+
+    pick(triangles_, graphics_.numberOfTriangles(), origin, unit, 0,
+        [this, origin, &unit](const size_type j) {
+            const typename GraphicsType::TriangleType& triangle = graphics_.triangle(j);
+            if(!graphics_.triangleProperty(triangle.propertyIndex()).visibility()) {
+                return std::numeric_limits<value_type>::infinity();
+            }
+            value_type v[3][3];
+            for(std::size_t m = 0; m < 3; ++m) {
+                for(std::size_t k = 0; k < 3; ++k) {
+                    v[m][k] = graphics_.point(triangle.pointIndex(m))[k];
+                }
+            }
+            return detail::rayTriangleDistance(origin, unit, v[0], v[1], v[2]);
+        },
+        TrianglePrimitive, result
+    );
+    pick(lines_, graphics_.numberOfLines(), origin, unit, tolerance,
+        [this, origin, &unit, tolerance](const size_type j) {
+            const typename GraphicsType::LineType& line = graphics_.line(j);
+            if(!graphics_.lineProperty(line.propertyIndex()).visibility()) {
+                return std::numeric_limits<value_type>::infinity();
+            }
+            value_type p[3];
+            value_type q[3];
+            for(std::size_t k = 0; k < 3; ++k) {
+                p[k] = graphics_.point(line.pointIndex(0))[k];
+                q[k] = graphics_.point(line.pointIndex(1))[k];
+            }
+            return detail::raySegmentDistance(origin, unit, p, q, tolerance);
+        },
+        LinePrimitive, result
+    );
+    pick(points_, graphics_.numberOfPoints(), origin, unit, tolerance,
+        [this, origin, &unit, tolerance](const size_type j) {
+            const typename GraphicsType::PointType& point = graphics_.point(j);
+            if(!graphics_.pointProperty(point.propertyIndex()).visibility()) {
+                return std::numeric_limits<value_type>::infinity();
+            }
+            value_type p[3];
+            for(std::size_t k = 0; k < 3; ++k) {
+                p[k] = point[k];
+            }
+            return detail::raySegmentDistance(origin, unit, p, p, tolerance);
+        },
+        PointPrimitive, result
+    );
+    if(result.kind_ != NoPrimitive) {
+        result.distance_ /= length;
+    }
+    return result;
+}
+
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::pointBox(
+    const size_type j,
+    value_type* box
+) const {
+    const typename GraphicsType::PointType& point = graphics_.point(j);
+    for(std::size_t k = 0; k < 3; ++k) {
+        box[k] = box[3 + k] = point[k];
+    }
+}
+
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::lineBox(
+    const size_type j,
+    value_type* box
+) const {
+    const typename GraphicsType::LineType& line = graphics_.line(j);
+    const typename GraphicsType::PointType& p = graphics_.point(line.pointIndex(0));
+    const typename GraphicsType::PointType& q = graphics_.point(line.pointIndex(1));
+    for(std::size_t k = 0; k < 3; ++k) {
+        box[k] = std::min(p[k], q[k]);
+        box[3 + k] = std::max(p[k], q[k]);
+    }
+}
+
+template<class T, class S>
+inline void
+SpatialIndex<T, S>::triangleBox(
+    const size_type j,
+    value_type* box
+) const {
+    const typename GraphicsType::TriangleType& triangle = graphics_.triangle(j);
+    for(std::size_t k = 0; k < 3; ++k) {
+        box[k] = box[3 + k] = graphics_.point(triangle.pointIndex(0))[k];
+    }
+    for(std::size_t m = 1; m < 3; ++m) {
+        const typename GraphicsType::PointType& point = graphics_.point(triangle.pointIndex(m));
+        for(std::size_t k = 0; k < 3; ++k) {
+            box[k] = std::min(box[k], point[k]);
+            box[3 + k] = std::max(box[3 + k], point[k]);
+        }
+    }
+}
+
+template<class T, class S>
+template<class BOX_OF>
+inline void
+SpatialIndex<T, S>::update(
+    Hierarchies& hierarchies,
+    const size_type size,
+    BOX_OF boxOf,
+    const ParallelOptions& parallelOptions
+) {
+    if(size < end(hierarchies)) { // primitives have been removed
+        hierarchies.clear();
+    }
+    size_type first = end(hierarchies);
+    if(size == first) {
+        return;
+    }
+    while(!hierarchies.empty() && hierarchies.back().size() <= 2 * static_cast<std::size_t>(size - first)) {
+        first = hierarchies.back().first();
+        hierarchies.pop_back();
+    }
+    hierarchies.push_back(Hierarchy());
+    hierarchies.back().build(first, size, boxOf, parallelOptions);
+}
+
+template<class T, class S>
+template<class INTERSECTS>
+inline void
+SpatialIndex<T, S>::query(
+    const Hierarchies& hierarchies,
+    const size_type size,
+    const value_type* box,
+    INTERSECTS intersects,
+    std::vector<size_type>& result
+) {
+    result.clear();
+    std::vector<std::size_t> stack;
+    for(std::size_t h = 0; h < hierarchies.size(); ++h) {
+        const Hierarchy& hierarchy = hierarchies[h];
+        if(hierarchy.nodes().empty()) {
+            continue;
+        }
+        stack.push_back(0);
+        while(!stack.empty()) {
+            const std::size_t j = stack.back();
+            stack.pop_back();
+            const Node& node = hierarchy.nodes()[j];
+            if(!detail::boxesIntersect(node.box_, box)) {
+                continue;
+            }
+            if(node.isLeaf()) {
+                for(std::size_t m = node.first_; m < node.first_ + node.size_; ++m) {
+                    if(intersects(hierarchy.indices()[m])) {
+                        result.push_back(hierarchy.indices()[m]);
+                    }
+                }
+            }
+            else {
+                stack.push_back(node.right_);
+                stack.push_back(j + 1);
+            }
+        }
+    }
+    for(size_type j = end(hierarchies); j < size; ++j) { // not yet indexed
+        if(intersects(j)) {
+            result.push_back(j);
+        }
+    }
+}
+
+template<class T, class S>
+template<class DISTANCE>
+inline void
+SpatialIndex<T, S>::pick(
+    const Hierarchies& hierarchies,
+    const size_type size,
+    const value_type* origin,
+    const value_type* direction,
+    const value_type tolerance,
+    DISTANCE distance,
+    const PrimitiveKind kind,
+    PickType& result
+) {
+    std::vector<std::pair<value_type, std::size_t> > stack; // entry distance, node
+    for(std::size_t h = 0; h < hierarchies.size(); ++h) {
+        const Hierarchy& hierarchy = hierarchies[h];
+        const auto enter = [&](const std::size_t j) { // entry distance into the box of node j, widened by the tolerance
+            value_type box[6];
+            for(std::size_t k = 0; k < 3; ++k) {
+                box[k] = hierarchy.nodes()[j].box_[k] - tolerance;
+                box[3 + k] = hierarchy.nodes()[j].box_[3 + k] + tolerance;
+            }
+            return std::make_pair(detail::rayBoxDistance(origin, direction, box), j);
+        };
+        if(!hierarchy.nodes().empty()) {
+            stack.push_back(enter(0));
+        }
+        while(!stack.empty()) {
+            const std::pair<value_type, std::size_t> entry = stack.back();
+            stack.pop_back();
+            if(!(entry.first < result.distance_)) { // missed or farther than the nearest hit
+                continue;
+            }
+            const Node& node = hierarchy.nodes()[entry.second];
+            if(node.isLeaf()) {
+                for(std::size_t m = node.first_; m < node.first_ + node.size_; ++m) {
+                    const value_type d = distance(hierarchy.indices()[m]);
+                    if(d < result.distance_) {
+                        result.kind_ = kind;
+                        result.index_ = hierarchy.indices()[m];
+                        result.distance_ = d;
+                    }
+                }
+            }
+            else {
+                // visit the nearer child first
+                std::pair<value_type, std::size_t> left = enter(entry.second + 1);
+                std::pair<value_type, std::size_t> right = enter(node.right_);
+                if(left.first < right.first) {
+                    std::swap(left, right);
+                }
+                stack.push_back(left);
+                stack.push_back(right);
+            }
+        }
+    }
+    for(size_type j = end(hierarchies); j < size; ++j) { // not yet indexed
+        const value_type d = distance(j);
+        if(d < result.distance_) {
+            result.kind_ = kind;
+            result.index_ = j;
+            result.distance_ = d;
+        }
+    }
+}
+
+} // namespace graphics
+} // namespace andres
+
+#endif // #ifndef ANDRES_GRAPHICS_SPATIAL_INDEX_HXX
@@ -1,94 +1,513 @@
-// TODO: implement SVG export of triangles
 #pragma once
 #ifndef ANDRES_GRAPHICS_SVG_HXX
 #define ANDRES_GRAPHICS_SVG_HXX
 
+#include <cstddef>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+#include "zlib.h"
+#endif
 
 #include "graphics.hxx"
+#include "culling.hxx"
+#include "instrumentation.hxx"
 
 namespace andres {
 namespace graphics {
 
-template<class Projection>
-void
-saveSVG(
-    const Graphics<typename Projection::value_type, typename Projection::size_type>& g,
-    const Projection& projection,
-    std::ostream& output = std::cout
+/// Options for the export of graphics as SVG.
+///
+/// \param decimals Number of decimal places of coordinates (at most 9).
+/// \param bufferSize Number of bytes buffered before they are written.
+/// \param compressionLevel zlib compression level (1-9) of .svgz files.
+///
+/// More than 9 decimals throw std::runtime_error, here and, if decimals_
+/// is changed later, in saveSVG() and saveSVGZ() before any output is
+/// opened.
+///
+struct SVGOptions {
+    SVGOptions(
+        const unsigned int decimals = 3,
+        const std::size_t bufferSize = 1 << 20,
+        const int compressionLevel = 6
+    )
+    :   decimals_(decimals),
+        bufferSize_(bufferSize),
+        compressionLevel_(compressionLevel)
+    {
+        validate();
+    }
+    void validate() const
+        {
+            if(decimals_ > 9) {
+                throw std::runtime_error("more than 9 decimals of SVG coordinates are not supported.");
+            }
+        }
+
+    unsigned int decimals_;
+    std::size_t bufferSize_;
+    int compressionLevel_;
+};
+
+namespace detail {
+
+/// Write the decimal representation of an unsigned integer to output and
+/// return the end of the representation.
+///
+inline char*
+formatUnsigned(
+    std::uint64_t value,
+    char* output
+) {
+    char digits[20];
+    std::size_t n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while(value != 0);
+    while(n != 0) {
+        *output++ = digits[--n];
+    }
+    return output;
+}
+
+/// Write a number rounded to the given number of decimal places, without
+/// trailing zeros, to output and return the end of the representation.
+///
+/// At most 32 characters are written.
+///
+inline char*
+formatFixed(
+    const double value,
+    const unsigned int decimals,
+    char* output
+) {
+    static const std::uint64_t powersOf10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    assert(decimals <= 9);
+    const double absoluteValue = std::abs(value);
+    if(!(absoluteValue < 1e9)) { // also NaN
+        return output + std::snprintf(output, 32, "%g", value);
+    }
+    const std::uint64_t scale = powersOf10[decimals];
+    const std::uint64_t scaled = static_cast<std::uint64_t>(absoluteValue * scale + 0.5);
+    if(value < 0 && scaled != 0) {
+        *output++ = '-';
+    }
+    output = formatUnsigned(scaled / scale, output);
+    std::uint64_t fraction = scaled % scale;
+    if(fraction != 0) {
+        *output++ = '.';
+        unsigned int n = decimals;
+        while(fraction % 10 == 0) {
+            fraction /= 10;
+            --n;
+        }
+        for(unsigned int j = n; j > 0; --j) {
+            output[j - 1] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        output += n;
+    }
+    return output;
+}
+
+/// Sink that writes to an output stream.
+///
+class OstreamSink {
+public:
+    OstreamSink(std::ostream& stream)
+        : stream_(stream)
+        {}
+    void write(const char* data, const std::size_t size)
+        { stream_.write(data, static_cast<std::streamsize>(size)); }
+    void close()
+        { stream_.flush(); }
+
+private:
+    std::ostream& stream_;
+};
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+/// Sink that writes to a gzip-compressed file.
+///
+class GzipSink {
+public:
+    GzipSink(const std::string& fileName, const int compressionLevel)
+        : file_(gzopen(fileName.c_str(), ("wb" + std::to_string(compressionLevel)).c_str()))
+        {
+            if(file_ == NULL) {
+                throw std::runtime_error("could not open file '" + fileName + "' for writing.");
+            }
+        }
+    ~GzipSink()
+        { if(file_ != NULL) { gzclose(file_); } }
+    void write(const char* data, const std::size_t size)
+        {
+            if(size != 0 && gzwrite(file_, data, static_cast<unsigned int>(size)) == 0) {
+                throw std::runtime_error("could not write gzip-compressed data.");
+            }
+        }
+    void close()
+        {
+            const int status = gzclose(file_);
+            file_ = NULL;
+            if(status != Z_OK) {
+                throw std::runtime_error("could not close gzip-compressed file.");
+            }
+        }
+
+private:
+    gzFile file_;
+};
+#endif
+
+/// Buffered writer of SVG text.
+///
+/// Text is collected in a buffer that is passed to the sink only when it
+/// is full, instead of once per element.
+///
+template<class SINK>
+class SVGWriter {
+public:
+    SVGWriter(SINK& sink, const SVGOptions& options)
+        :   sink_(sink),
+            buffer_(std::max<std::size_t>(options.bufferSize_, 256)),
+            size_(0),
+            bytesWritten_(0),
+            decimals_(options.decimals_)
+        {}
+    SVGWriter& operator<<(const char* text)
+        {
+            while(*text != '\0') {
+                reserve(1);
+                buffer_[size_++] = *text++;
+            }
+            return *this;
+        }
+    SVGWriter& operator<<(const std::string& text)
+        {
+            for(std::size_t j = 0; j < text.size(); ++j) {
+                reserve(1);
+                buffer_[size_++] = text[j];
+            }
+            return *this;
+        }
+    SVGWriter& number(const double value)
+        {
+            reserve(32);
+            size_ = formatFixed(value, decimals_, buffer_.data() + size_) - buffer_.data();
+            return *this;
+        }
+    SVGWriter& integer(const std::uint64_t value)
+        {
+            reserve(20);
+            size_ = formatUnsigned(value, buffer_.data() + size_) - buffer_.data();
+            return *this;
+        }
+    void flush()
+        {
+            sink_.write(buffer_.data(), size_);
+            bytesWritten_ += size_;
+            size_ = 0;
+        }
+    std::size_t bytesWritten() const
+        { return bytesWritten_ + size_; }
+
+private:
+    void reserve(const std::size_t n)
+        {
+            if(size_ + n > buffer_.size()) {
+                flush();
+            }
+        }
+
+    SINK& sink_;
+    std::vector<char> buffer_;
+    std::size_t size_;
+    std::size_t bytesWritten_;
+    unsigned int decimals_;
+};
+
+/// Write one CSS class per visible property, e.g. '.l0{stroke:rgb(...);}'.
+///
+/// \param colorAttributes Null-terminated array of the names of the
+///     attributes set to the color.
+///
+template<class WRITER, class PROPERTIES>
+inline void
+writeStyleClasses(
+    WRITER& writer,
+    const PROPERTIES& properties,
+    const char* prefix,
+    const char* const* colorAttributes,
+    const char* opacityAttribute
 ) {
+    for(std::size_t j = 0; j < properties.size(); ++j) {
+        if(!properties[j].visibility()) {
+            continue;
+        }
+        writer << "." << prefix;
+        writer.integer(j) << "{";
+        for(const char* const* attribute = colorAttributes; *attribute != 0; ++attribute) {
+            writer << *attribute << ":rgb(";
+            writer.integer(properties[j].color(0)) << ",";
+            writer.integer(properties[j].color(1)) << ",";
+            writer.integer(properties[j].color(2)) << ");";
+        }
+        if(properties[j].alpha() != 255) {
+            writer << opacityAttribute << ":";
+            writer.number(properties[j].alpha() / 255.0) << ";";
+        }
+        writer << "}\n";
+    }
+}
+
+/// Primitives of a graphics to be written as SVG: all primitives, with
+/// coordinates projected by a projection.
+///
+template<class Projection, class GRAPHICS = Graphics<typename Projection::value_type, typename Projection::size_type> >
+class SVGPrimitives {
+public:
     typedef typename Projection::value_type value_type;
     typedef typename Projection::size_type size_type;
-    typedef Graphics<value_type, size_type> GraphicsType;
-    typedef typename GraphicsType::PointType PointType;
+    typedef GRAPHICS GraphicsType;
+
+    SVGPrimitives(const GraphicsType& graphics, const Projection& projection)
+        : graphics_(graphics), projection_(projection)
+        {}
+    size_type numberOfPoints() const
+        { return graphics_.numberOfPoints(); }
+    size_type numberOfLines() const
+        { return graphics_.numberOfLines(); }
+    size_type numberOfTriangles() const
+        { return graphics_.numberOfTriangles(); }
+    size_type point(const size_type j) const
+        { return j; }
+    size_type line(const size_type j) const
+        { return j; }
+    size_type triangle(const size_type j) const
+        { return j; }
+    void project(const size_type pointIndex, value_type& x, value_type& y) const
+        {
+            const typename GraphicsType::PointType& point = graphics_.point(pointIndex);
+            projection_(point[0], point[1], point[2], x, y);
+        }
+    bool canvas(value_type*) const
+        { return false; }
+
+private:
+    const GraphicsType& graphics_;
+    const Projection& projection_;
+};
+
+/// Primitives of a graphics to be written as SVG: the primitives kept by
+/// a screen-space culling, with the coordinates projected by the culling.
+///
+template<class T, class S, class GRAPHICS>
+class SVGPrimitives<ScreenSpaceCulling<T, S>, GRAPHICS> {
+public:
+    typedef T value_type;
+    typedef S size_type;
+    typedef GRAPHICS GraphicsType;
+
+    SVGPrimitives(const GraphicsType&, const ScreenSpaceCulling<T, S>& culling)
+        : culling_(culling)
+        {}
+    size_type numberOfPoints() const
+        { return culling_.pointIndices().size(); }
+    size_type numberOfLines() const
+        { return culling_.lineIndices().size(); }
+    size_type numberOfTriangles() const
+        { return culling_.triangleIndices().size(); }
+    size_type point(const size_type j) const
+        { return culling_.pointIndices()[j]; }
+    size_type line(const size_type j) const
+        { return culling_.lineIndices()[j]; }
+    size_type triangle(const size_type j) const
+        { return culling_.triangleIndices()[j]; }
+    void project(const size_type pointIndex, value_type& x, value_type& y) const
+        { culling_.project(pointIndex, x, y); }
+    bool canvas(value_type* box) const
+        {
+            box[0] = culling_.xMin(); box[1] = culling_.yMin();
+            box[2] = culling_.xMax(); box[3] = culling_.yMax();
+            return std::isfinite(box[0]) && std::isfinite(box[1])
+                && std::isfinite(box[2]) && std::isfinite(box[3]);
+        }
+
+private:
+    const ScreenSpaceCulling<T, S>& culling_;
+};
+
+template<class PRIMITIVES, class SINK>
+inline std::size_t
+saveSVG(
+    const typename PRIMITIVES::GraphicsType& g,
+    const PRIMITIVES& primitives,
+    SINK& sink,
+    const SVGOptions& options
+) {
+    typedef typename PRIMITIVES::value_type value_type;
+    typedef typename PRIMITIVES::size_type size_type;
+    typedef typename PRIMITIVES::GraphicsType GraphicsType;
     typedef typename GraphicsType::LineType LineType;
-    typedef typename GraphicsType::PointPropertyType PointPropertyType;
-    typedef typename GraphicsType::LinePropertyType LinePropertyType;
+    typedef typename GraphicsType::TriangleType TriangleType;
+
+    ANDRES_GRAPHICS_TIMER(timer, "saveSVG");
+    timer.addItems(primitives.numberOfPoints() + primitives.numberOfLines() + primitives.numberOfTriangles());
+    SVGWriter<SINK> writer(sink, options);
 
     // print header
-    output << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>"
-        << std::endl
+    writer << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
         << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
-        << "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">"
-        << std::endl
+        << "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n"
         << "<svg version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\" "
-        << "xmlns:xlink=\"http://www.w3.org/1999/xlink\""
-//        << " width=" << ???
-//        << " height=" << ???
-        << ">"
-        << std::endl;
+        << "xmlns:xlink=\"http://www.w3.org/1999/xlink\"";
+    value_type canvas[4];
+    if(primitives.canvas(canvas)) {
+        writer << " width=\"";
+        writer.number(canvas[2] - canvas[0]) << "\" height=\"";
+        writer.number(canvas[3] - canvas[1]) << "\" viewBox=\"";
+        writer.number(canvas[0]) << " ";
+        writer.number(canvas[1]) << " ";
+        writer.number(canvas[2] - canvas[0]) << " ";
+        writer.number(canvas[3] - canvas[1]) << "\"";
+    }
+    writer << ">\n";
+
+    // print one CSS class per property
+    writer << "<style type=\"text/css\">\n"
+        << "circle{stroke-width:1pt}\n"
+        << "line{stroke-width:1pt}\n"
+        << "polygon{stroke:none}\n";
+    const char* const pointAttributes[] = {"stroke", "fill", 0};
+    const char* const lineAttributes[] = {"stroke", 0};
+    const char* const triangleAttributes[] = {"fill", 0};
+    writeStyleClasses(writer, g.pointProperties(), "p", pointAttributes, "opacity");
+    writeStyleClasses(writer, g.lineProperties(), "l", lineAttributes, "stroke-opacity");
+    writeStyleClasses(writer, g.triangleProperties(), "t", triangleAttributes, "fill-opacity");
+    writer << "</style>\n";
+
+    // plot triangles first, beneath points and lines
+    for(size_type j = 0; j < primitives.numberOfTriangles(); ++j) {
+        const TriangleType& triangle = g.triangle(primitives.triangle(j));
+        if(g.triangleProperty(triangle.propertyIndex()).visibility()) {
+            writer << "<polygon class=\"t";
+            writer.integer(triangle.propertyIndex()) << "\" points=\"";
+            for(std::size_t k = 0; k < 3; ++k) {
+                value_type x = 0;
+                value_type y = 0;
+                primitives.project(triangle.pointIndex(k), x, y);
+                writer.number(x) << ",";
+                writer.number(y) << (k < 2 ? " " : "\"/>\n");
+            }
+        }
+    }
 
     // plot points
-    for(size_type j = 0; j < g.numberOfPoints(); ++j) {
-        const PointType& point = g.point(j);
-        const PointPropertyType& pointProperty = g.pointProperty(point.propertyIndex());
-        if(pointProperty.visibility()) {
+    for(size_type j = 0; j < primitives.numberOfPoints(); ++j) {
+        const size_type pointIndex = primitives.point(j);
+        const size_type propertyIndex = g.point(pointIndex).propertyIndex();
+        if(g.pointProperty(propertyIndex).visibility()) {
             value_type x = 0;
             value_type y = 0;
-            projection(point[0], point[1], point[2], x, y);
-            output << "<circle cx=\"" << x
-                << "\" cy=\"" << y
-                << "\" r=\"1pt\" style=\""
-                << "stroke:rgb(" << static_cast<unsigned int>(pointProperty.color(0))
-                << ", " << static_cast<unsigned int>(pointProperty.color(1))
-                << ", " << static_cast<unsigned int>(pointProperty.color(2)) << ");"
-                << " fill:rgb(" << static_cast<unsigned int>(pointProperty.color(0))
-                << ", " << static_cast<unsigned int>(pointProperty.color(1))
-                << ", " << static_cast<unsigned int>(pointProperty.color(2)) << ");"
-                << " stroke-width:1pt;"
-                << "\"/>"
-                << std::endl;
+            primitives.project(pointIndex, x, y);
+            writer << "<circle class=\"p";
+            writer.integer(propertyIndex) << "\" cx=\"";
+            writer.number(x) << "\" cy=\"";
+            writer.number(y) << "\" r=\"1pt\"/>\n";
         }
     }
 
     // plot lines
-    for(size_type j = 0; j < g.numberOfLines(); ++j) {
-        const LineType& line = g.line(j);
-        const LinePropertyType& lineProperty = g.lineProperty(line.propertyIndex());
-        if(lineProperty.visibility()) {
-            const PointType& point0 = g.point(line.pointIndex(0));
-            const PointType& point1 = g.point(line.pointIndex(1));
+    for(size_type j = 0; j < primitives.numberOfLines(); ++j) {
+        const LineType& line = g.line(primitives.line(j));
+        if(g.lineProperty(line.propertyIndex()).visibility()) {
             value_type x1 = 0;
             value_type y1 = 0;
-            projection(point0[0], point0[1], point0[2], x1, y1);
+            primitives.project(line.pointIndex(0), x1, y1);
             value_type x2 = 0;
             value_type y2 = 0;
-            projection(point1[0], point1[1], point1[2], x2, y2);
-            output << "<line x1=\"" << x1 << "\""
-                << " y1=\"" << y1 << "\""
-                << " x2=\"" << x2 << "\""
-                << " y2=\"" << y2 << "\""
-                << " style=\"stroke:rgb(" << static_cast<unsigned int>(lineProperty.color(0))
-                << ", " << static_cast<unsigned int>(lineProperty.color(1))
-                << ", " << static_cast<unsigned int>(lineProperty.color(2))
-                << "); stroke-width:1pt;" << "\"/>"
-                << std::endl;
+            primitives.project(line.pointIndex(1), x2, y2);
+            writer << "<line class=\"l";
+            writer.integer(line.propertyIndex()) << "\" x1=\"";
+            writer.number(x1) << "\" y1=\"";
+            writer.number(y1) << "\" x2=\"";
+            writer.number(x2) << "\" y2=\"";
+            writer.number(y2) << "\"/>\n";
         }
     }
 
     // print footer
-    output << "</svg>\n";
+    writer << "</svg>\n";
+    writer.flush();
+    sink.close();
+    return writer.bytesWritten();
+}
+
+} // namespace detail
+
+/// Save the projection of a graphics as SVG.
+///
+/// Points, lines and triangles are styled by one CSS class per property.
+/// Triangles are drawn first, as polygons, followed by points and lines.
+///
+/// \param g Graphics, or a read-only graphics with the same interface,
+///     e.g. binary::MappedGraphics.
+/// \param projection Projection of 3D coordinates to 2D SVG coordinates,
+///     or a ScreenSpaceCulling of g, in which case only the primitives kept
+///     by the culling are written and the canvas of the culling, if finite,
+///     becomes the size of the SVG.
+/// \param output Output stream.
+/// \param options Options.
+/// \returns Number of bytes written.
+///
+template<class GRAPHICS, class Projection>
+inline std::size_t
+saveSVG(
+    const GRAPHICS& g,
+    const Projection& projection,
+    std::ostream& output = std::cout,
+    const SVGOptions& options = SVGOptions()
+) {
+    options.validate();
+    detail::OstreamSink sink(output);
+    return detail::saveSVG(g, detail::SVGPrimitives<Projection, GRAPHICS>(g, projection), sink, options);
+}
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+/// Save the projection of a graphics as gzip-compressed SVG (.svgz).
+///
+/// \param g Graphics or read-only graphics, see saveSVG().
+/// \param projection Projection or ScreenSpaceCulling, see saveSVG().
+/// \param fileName Name of the file to be written.
+/// \param options Options.
+/// \returns Number of uncompressed bytes written.
+///
+template<class GRAPHICS, class Projection>
+inline std::size_t
+saveSVGZ(
+    const GRAPHICS& g,
+    const Projection& projection,
+    const std::string& fileName,
+    const SVGOptions& options = SVGOptions()
+) {
+    options.validate();
+    detail::GzipSink sink(fileName, options.compressionLevel_);
+    return detail::saveSVG(g, detail::SVGPrimitives<Projection, GRAPHICS>(g, projection), sink, options);
 }
+#endif
 
 } // namespace graphics
 } // namespace andres
@@ -0,0 +1,112 @@
+// Compares the startup time of loading graphics from HDF5 files with that
+// of loading and of memory-mapping binary files, and measures the
+// conversion from HDF5 to binary files.
+//
+// usage: benchmark-graphics-binary [grid size n (default: 2000)]
+//
+// The graphics is the grid mesh of defineGrid() in scenes.hxx. Times are
+// measured with the files in the page
+// cache (warm) and after evicting them from the page cache (cold).
+//
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "andres/graphics/graphics-hdf5.hxx"
+#include "andres/graphics/graphics-binary.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::binary::MappedGraphics<> MappedGraphics;
+typedef Graphics::size_type size_type;
+
+// evict a file from the page cache
+void evict(const std::string& fileName) {
+    const int descriptor = ::open(fileName.c_str(), O_RDONLY);
+    if(descriptor != -1) {
+        ::fdatasync(descriptor);
+        ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(descriptor);
+    }
+}
+
+template<class FUNCTION>
+void measure(const std::string& name, const std::string& fileName, FUNCTION f) {
+    evict(fileName);
+    const double cold = seconds(f);
+    const double warm = seconds(f);
+    std::cout << name << ": " << 1e3 * cold << " ms cold, " << 1e3 * warm << " ms warm" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const size_type n = argc > 1 ? std::stoull(argv[1]) : 2000;
+
+    Graphics graphics;
+    defineGrid(graphics, n);
+    std::cout << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles" << std::endl;
+
+    const std::string hdf5FileName = "benchmark-graphics-binary.h5";
+    const std::string binaryFileName = "benchmark-graphics-binary.agb";
+    const std::string convertedFileName = "benchmark-graphics-binary-converted.agb";
+    double t = seconds([&]() {
+        hid_t file = andres::graphics::hdf5::createFile(hdf5FileName);
+        andres::graphics::hdf5::save(file, graphics);
+        andres::graphics::hdf5::closeFile(file);
+    });
+    std::cout << "save HDF5: " << 1e3 * t << " ms" << std::endl;
+    std::size_t bytes = 0;
+    t = seconds([&]() { bytes = andres::graphics::binary::save(binaryFileName, graphics); });
+    std::cout << "save binary: " << 1e3 * t << " ms, " << bytes << " bytes" << std::endl;
+    t = seconds([&]() {
+        andres::graphics::binary::Writer<> writer(convertedFileName);
+        hid_t file = andres::graphics::hdf5::openFile(hdf5FileName);
+        andres::graphics::hdf5::visit(file, writer);
+        andres::graphics::hdf5::closeFile(file);
+        writer.close();
+    });
+    std::cout << "convert HDF5 to binary: " << 1e3 * t << " ms" << std::endl;
+    graphics = Graphics();
+
+    // startup
+    measure("load HDF5", hdf5FileName, [&]() {
+        Graphics g;
+        hid_t file = andres::graphics::hdf5::openFile(hdf5FileName);
+        andres::graphics::hdf5::load(file, g);
+        andres::graphics::hdf5::closeFile(file);
+    });
+    measure("load binary", binaryFileName, [&]() {
+        Graphics g;
+        andres::graphics::binary::load(binaryFileName, g);
+    });
+    measure("map binary", binaryFileName, [&]() {
+        MappedGraphics g(binaryFileName);
+    });
+
+    // access to mapped files
+    float sum = 0;
+    measure("map binary, read 1000 random points", binaryFileName, [&]() {
+        MappedGraphics g(binaryFileName);
+        for(std::size_t j = 0; j < 1000; ++j) {
+            sum += g.point((j * 7919 * 7907) % g.numberOfPoints())[2];
+        }
+    });
+    measure("map binary, read all points", binaryFileName, [&]() {
+        MappedGraphics g(binaryFileName);
+        for(std::size_t j = 0; j < g.numberOfPoints(); ++j) {
+            sum += g.point(j)[2];
+        }
+    });
+    std::cout << "(" << sum << ")" << std::endl;
+
+    std::remove(hdf5FileName.c_str());
+    std::remove(binaryFileName.c_str());
+    std::remove(convertedFileName.c_str());
+    return 0;
+}
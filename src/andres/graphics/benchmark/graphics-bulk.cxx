@@ -0,0 +1,139 @@
+// Compares the construction of graphics by definePoint(), defineLine() and
+// defineTriangle() one primitive at a time with the bulk definition by
+// definePoints(), defineLines() and defineTriangles() from arrays and
+// vectors.
+//
+// usage: benchmark-graphics-bulk [number of points (default: 1000000)] [number of lines (default: 10000000)]
+//
+// There are as many triangles as lines. Point indices are random.
+//
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef Graphics::size_type size_type;
+
+void print(const std::string& name, const double t, const std::size_t n) {
+    std::cout << name << ": " << 1e3 * t << " ms, " << 1e9 * t / n << " ns per primitive" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t numberOfPoints = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    const std::size_t numberOfLines = argc > 2 ? std::stoull(argv[2]) : 10000000;
+    const std::size_t numberOfTriangles = numberOfLines;
+    const std::size_t batchSize = 4096;
+
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, 1.0f);
+    std::uniform_int_distribution<std::uint32_t> pointIndex(0, static_cast<std::uint32_t>(numberOfPoints - 1));
+    std::vector<float> coordinates(3 * numberOfPoints);
+    for(std::size_t j = 0; j < coordinates.size(); ++j) {
+        coordinates[j] = coordinate(randomEngine);
+    }
+    std::vector<std::uint32_t> lineIndices(2 * numberOfLines);
+    for(std::size_t j = 0; j < lineIndices.size(); ++j) {
+        lineIndices[j] = pointIndex(randomEngine);
+    }
+    std::vector<std::uint32_t> triangleIndices(3 * numberOfTriangles);
+    for(std::size_t j = 0; j < triangleIndices.size(); ++j) {
+        triangleIndices[j] = pointIndex(randomEngine);
+    }
+    std::cout << numberOfPoints << " points, " << numberOfLines << " lines, "
+        << numberOfTriangles << " triangles" << std::endl;
+
+    // points
+    {
+        Graphics graphics;
+        print("definePoint()", seconds([&]() {
+            for(std::size_t j = 0; j < numberOfPoints; ++j) {
+                graphics.definePoint(coordinates[3 * j], coordinates[3 * j + 1], coordinates[3 * j + 2]);
+            }
+        }), numberOfPoints);
+    }
+    {
+        Graphics graphics;
+        print("definePoints(array)", seconds([&]() {
+            graphics.definePoints(&coordinates[0], numberOfPoints);
+        }), numberOfPoints);
+    }
+
+    // lines
+    Graphics graphics;
+    graphics.definePoints(&coordinates[0], numberOfPoints);
+    print("defineLine()", seconds([&]() {
+        for(std::size_t j = 0; j < numberOfLines; ++j) {
+            graphics.defineLine(lineIndices[2 * j], lineIndices[2 * j + 1]);
+        }
+    }), numberOfLines);
+    Graphics::LinesVector lines = graphics.lines();
+    graphics = Graphics();
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("reserve(), defineLine()", seconds([&]() {
+            g.reserve(numberOfPoints, numberOfLines);
+            for(std::size_t j = 0; j < numberOfLines; ++j) {
+                g.defineLine(lineIndices[2 * j], lineIndices[2 * j + 1]);
+            }
+        }), numberOfLines);
+    }
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("defineLines(array)", seconds([&]() {
+            g.defineLines(&lineIndices[0], numberOfLines);
+        }), numberOfLines);
+    }
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("defineLines(array), batches of 4096", seconds([&]() {
+            for(std::size_t j = 0; j < numberOfLines; j += batchSize) {
+                g.defineLines(&lineIndices[2 * j], std::min(batchSize, numberOfLines - j));
+            }
+        }), numberOfLines);
+    }
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("defineLines(const vector&)", seconds([&]() {
+            g.defineLines(lines);
+        }), numberOfLines);
+    }
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("defineLines(vector&&)", seconds([&]() {
+            g.defineLines(std::move(lines));
+        }), numberOfLines);
+    }
+
+    // triangles
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("defineTriangle()", seconds([&]() {
+            for(std::size_t j = 0; j < numberOfTriangles; ++j) {
+                g.defineTriangle(triangleIndices[3 * j], triangleIndices[3 * j + 1], triangleIndices[3 * j + 2]);
+            }
+        }), numberOfTriangles);
+    }
+    {
+        Graphics g;
+        g.definePoints(&coordinates[0], numberOfPoints);
+        print("defineTriangles(array)", seconds([&]() {
+            g.defineTriangles(&triangleIndices[0], numberOfTriangles);
+        }), numberOfTriangles);
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Measures the time of cleanup() and what it saves in memory, file size
+// and render time on graphics as emitted by producers that define the
+// corners and edges of each triangle separately.
+//
+// usage: benchmark-graphics-cleanup [grid size n (default: 500)]
+//
+// The scene is an n x n grid with two triangles per cell. Each triangle
+// has its own three points and three lines, such that there are 6 n^2
+// points, 6 n^2 lines and 2 n^2 triangles, of which n^2 + O(n) points and
+// 3 n^2 + O(n) lines remain after welding and removing duplicates. For
+// welding within a distance, the points are perturbed by noise much
+// smaller than the distance.
+//
+#include <cstddef>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "andres/graphics/cleanup.hxx"
+#include "andres/graphics/graphics-binary.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/rasterizer.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::CleanupOptions CleanupOptions;
+typedef andres::graphics::CleanupResult<> CleanupResult;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+Graphics triangleSoup(const std::size_t n, const float noise) {
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<float> perturbation(-noise, noise);
+    const float spacing = 2.0f / n;
+    Graphics graphics;
+    graphics.reserve(6 * n * n, 6 * n * n, 2 * n * n);
+    const size_type triangleProperty = graphics.defineTriangleProperty(true, 100, 150, 200);
+    const std::size_t corners[2][3][2] = {{{0, 0}, {1, 0}, {0, 1}}, {{1, 0}, {1, 1}, {0, 1}}};
+    for(std::size_t x = 0; x < n; ++x) {
+        for(std::size_t y = 0; y < n; ++y) {
+            for(std::size_t t = 0; t < 2; ++t) {
+                size_type p[3];
+                for(std::size_t k = 0; k < 3; ++k) {
+                    p[k] = graphics.definePoint(
+                        -1.0f + spacing * (x + corners[t][k][0]) + perturbation(randomEngine),
+                        -1.0f + spacing * (y + corners[t][k][1]) + perturbation(randomEngine),
+                        perturbation(randomEngine)
+                    );
+                }
+                graphics.defineTriangle(p[0], p[1], p[2], triangleProperty);
+                graphics.defineLine(p[0], p[1]);
+                graphics.defineLine(p[1], p[2]);
+                graphics.defineLine(p[2], p[0]);
+            }
+        }
+    }
+    return graphics;
+}
+
+void print(const CleanupResult& result) {
+    std::cout << "  points: " << result.points_ << std::endl
+        << "  lines: " << result.lines_ << std::endl
+        << "  triangles: " << result.triangles_ << std::endl
+        << "  memory: " << result.bytesBefore_ << " -> " << result.bytesAfter_ << " bytes ("
+        << 100.0 * result.bytesAfter_ / result.bytesBefore_ << "%)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : 500;
+    const float distance = 0.1f / n;
+
+    const Graphics soup = triangleSoup(n, 0);
+    std::cout << soup.numberOfPoints() << " points, "
+        << soup.numberOfLines() << " lines, "
+        << soup.numberOfTriangles() << " triangles" << std::endl;
+
+    // exact welding
+    const std::size_t hardwareThreads = ParallelOptions().numberOfThreads();
+    Graphics cleaned;
+    CleanupResult result;
+    for(std::size_t numberOfThreads = 1; ; numberOfThreads *= 2) {
+        numberOfThreads = std::min(numberOfThreads, hardwareThreads);
+        cleaned = soup;
+        const double t = seconds([&]() { result = andres::graphics::cleanup(cleaned, CleanupOptions(), ParallelOptions(numberOfThreads)); });
+        std::cout << "cleanup, exact, " << numberOfThreads << " threads: " << 1e3 * t << " ms, "
+            << 1e9 * t / (soup.numberOfPoints() + soup.numberOfLines() + soup.numberOfTriangles()) << " ns per primitive" << std::endl;
+        if(numberOfThreads == hardwareThreads) {
+            break;
+        }
+    }
+    print(result);
+
+    // welding within a distance
+    {
+        Graphics g = triangleSoup(n, distance / 10);
+        double t = seconds([&]() { result = andres::graphics::cleanup(g); });
+        std::cout << "cleanup, exact, with noise: " << 1e3 * t << " ms, " << g.numberOfPoints() << " points remain" << std::endl;
+        g = triangleSoup(n, distance / 10);
+        t = seconds([&]() { result = andres::graphics::cleanup(g, CleanupOptions(true, distance)); });
+        std::cout << "cleanup, distance " << distance << ", with noise: " << 1e3 * t << " ms" << std::endl;
+        print(result);
+    }
+
+    // reordering points
+    Graphics reordered = soup;
+    const double t = seconds([&]() {
+        andres::graphics::cleanup(reordered, CleanupOptions(true, 0, true, true, false, true, true));
+    });
+    std::cout << "cleanup, reordering points: " << 1e3 * t << " ms" << std::endl;
+
+    // file size
+    const std::string fileName = "benchmark-graphics-cleanup.agb";
+    std::cout << "binary file: " << andres::graphics::binary::save(fileName, soup) << " -> "
+        << andres::graphics::binary::save(fileName, cleaned) << " bytes" << std::endl;
+    std::remove(fileName.c_str());
+
+    // render time, fastest of 3
+    const std::size_t width = 1024;
+    const std::size_t height = 768;
+    const float matrix[3][4] = {
+        {0.5f * width, 0.0f, 0.0f, 0.5f * width},
+        {0.0f, -0.5f * height, 0.0f, 0.5f * height},
+        {0.0f, 0.0f, 1.0f, 0.0f}
+    };
+    const andres::graphics::AffineProjection<> projection(matrix);
+    andres::graphics::Framebuffer framebuffer(width, height);
+    const Graphics* scenes[3] = {&soup, &cleaned, &reordered};
+    const char* names[3] = {"original", "cleaned", "cleaned and reordered"};
+    for(std::size_t s = 0; s < 3; ++s) {
+        double best = std::numeric_limits<double>::infinity();
+        for(std::size_t repetition = 0; repetition < 3; ++repetition) {
+            framebuffer.clear(255, 255, 255);
+            best = std::min(best, seconds([&]() { andres::graphics::rasterize(*scenes[s], projection, framebuffer); }));
+        }
+        std::cout << "rasterize " << names[s] << ": " << 1e3 * best << " ms" << std::endl;
+    }
+
+    return 0;
+}
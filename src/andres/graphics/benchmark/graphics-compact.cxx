@@ -0,0 +1,69 @@
+// Compares memory footprint and throughput of Graphics with 64-bit and
+// 32-bit indices, and of points with 16-bit quantized coordinates.
+//
+// usage: benchmark-graphics-compact [grid size n (default: 2000)]
+//
+// The graphics is the grid mesh of defineGrid() in scenes.hxx. Its point
+// indices fit into 32 bits for n < 65536.
+//
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/quantization.hxx"
+
+#include "scenes.hxx"
+
+template<class GRAPHICS>
+void benchmark(const std::string& name, const std::size_t n) {
+    GRAPHICS graphics;
+    const double tDefine = milliseconds([&]() { defineGrid(graphics, n); });
+    const double bytes = bytesInMemory(graphics);
+    const double numberOfPoints = static_cast<double>(graphics.numberOfPoints());
+    const double tCenter = milliseconds([&]() { graphics.center(); });
+    const double tNormalize = milliseconds([&]() { graphics.normalize(); });
+    std::cout << name << ": " << bytes / 1e6 << " MB ("
+        << sizeof(typename GRAPHICS::PointType) << "/"
+        << sizeof(typename GRAPHICS::LineType) << "/"
+        << sizeof(typename GRAPHICS::TriangleType) << " bytes per point/line/triangle)" << std::endl
+        << "  define       " << tDefine << " ms" << std::endl
+        << "  center()     " << tCenter << " ms (" << numberOfPoints / tCenter / 1e3 << " Mpoints/s)" << std::endl
+        << "  normalize()  " << tNormalize << " ms (" << numberOfPoints / tNormalize / 1e3 << " Mpoints/s)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : 2000;
+
+    benchmark<andres::graphics::Graphics<float, std::size_t> >("Graphics<float, std::size_t>", n);
+    benchmark<andres::graphics::Graphics<float, std::uint32_t> >("Graphics<float, std::uint32_t>", n);
+
+    // quantized points
+    typedef andres::graphics::Graphics<float, std::uint32_t> Graphics;
+    Graphics graphics;
+    defineGrid(graphics, n);
+    const double numberOfPoints = static_cast<double>(graphics.numberOfPoints());
+    andres::graphics::Quantization<float> quantization(graphics);
+    std::vector<andres::graphics::QuantizedPoint<> > quantizedPoints;
+    std::vector<Graphics::PointType> points;
+    const double tQuantize = milliseconds([&]() { andres::graphics::quantize(graphics, quantization, quantizedPoints); });
+    const double tDequantize = milliseconds([&]() { andres::graphics::dequantize(quantization, quantizedPoints, points); });
+    float maximumError = 0;
+    for(std::size_t j = 0; j < points.size(); ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            maximumError = std::max(maximumError, std::abs(points[j][k] - graphics.point(j)[k]));
+        }
+    }
+    std::cout << "QuantizedPoint<std::uint16_t>: "
+        << quantizedPoints.size() * sizeof(andres::graphics::QuantizedPoint<>) / 1e6 << " MB for points ("
+        << sizeof(andres::graphics::QuantizedPoint<>) << " bytes per point)" << std::endl
+        << "  quantize     " << tQuantize << " ms (" << numberOfPoints / tQuantize / 1e3 << " Mpoints/s)" << std::endl
+        << "  dequantize   " << tDequantize << " ms (" << numberOfPoints / tDequantize / 1e3 << " Mpoints/s)" << std::endl
+        << "  max. error   " << maximumError << " (bound " << quantization.error(0) << ", "
+        << quantization.error(1) << ", " << quantization.error(2) << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Measures the latency of updates and the stall of readers while a writer
+// thread continuously modifies graphics, for ConcurrentGraphics and for a
+// baseline in which the writer and the reader share one Graphics object
+// protected by a mutex and the reader copies it entirely.
+//
+// usage: benchmark-graphics-concurrent [number of points (default: 1000000)] [number of updates (default: 1000)] [modifications per update (default: 1000)]
+//
+// Initially, there are as many lines as points. Each update redefines the
+// given number of random points and appends as many points and lines.
+// The reader repeatedly takes the current version and reprocesses the
+// changed points, summing their coordinates.
+//
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "andres/graphics/concurrent.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ConcurrentGraphics<> ConcurrentGraphics;
+typedef Graphics::size_type size_type;
+typedef std::chrono::steady_clock Clock;
+
+void print(const std::string& name, std::vector<double> times) {
+    if(times.empty()) {
+        return;
+    }
+    std::sort(times.begin(), times.end());
+    double sum = 0;
+    for(std::size_t j = 0; j < times.size(); ++j) {
+        sum += times[j];
+    }
+    std::cout << "  " << name << " (" << times.size() << "): "
+        << 1e6 * sum / times.size() << " us mean, "
+        << 1e6 * times[times.size() / 2] << " us median, "
+        << 1e6 * times[times.size() * 99 / 100] << " us 99th percentile, "
+        << 1e6 * times.back() << " us maximum" << std::endl;
+}
+
+template<class GRAPHICS>
+void initialize(GRAPHICS& graphics, const std::size_t numberOfPoints) {
+    std::vector<float> coordinates(3 * numberOfPoints);
+    std::vector<size_type> indices(2 * numberOfPoints);
+    for(std::size_t j = 0; j < numberOfPoints; ++j) {
+        coordinates[3 * j] = coordinates[3 * j + 1] = coordinates[3 * j + 2] = static_cast<float>(j);
+        indices[2 * j] = j;
+        indices[2 * j + 1] = (j + 1) % numberOfPoints;
+    }
+    graphics.definePoints(&coordinates[0], numberOfPoints);
+    graphics.defineLines(&indices[0], numberOfPoints);
+}
+
+const Graphics& current(const Graphics& graphics) {
+    return graphics;
+}
+
+const Graphics& current(const ConcurrentGraphics& graphics) {
+    return graphics.graphics();
+}
+
+// one update of the writer
+template<class GRAPHICS>
+void modify(GRAPHICS& graphics, std::mt19937& randomEngine, const std::size_t numberOfModifications) {
+    const size_type n = current(graphics).numberOfPoints();
+    std::uniform_int_distribution<size_type> index(0, n - 1);
+    for(std::size_t j = 0; j < numberOfModifications; ++j) {
+        graphics.setPoint(index(randomEngine), 1.0f, 2.0f, 3.0f);
+    }
+    for(std::size_t j = 0; j < numberOfModifications; ++j) {
+        graphics.definePoint(1.0f, 2.0f, 3.0f);
+        graphics.defineLine(n + j, index(randomEngine));
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t numberOfPoints = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    const std::size_t numberOfUpdates = argc > 2 ? std::stoull(argv[2]) : 1000;
+    const std::size_t numberOfModifications = argc > 3 ? std::stoull(argv[3]) : 1000;
+    std::cout << numberOfPoints << " points, " << numberOfUpdates << " updates of "
+        << numberOfModifications << " redefined and " << numberOfModifications << " appended points and lines" << std::endl;
+
+    double checksum = 0;
+
+    // ConcurrentGraphics, reader processes changed ranges
+    {
+        ConcurrentGraphics graphics;
+        initialize(graphics, numberOfPoints);
+        graphics.publish();
+        const std::size_t initialCopies = graphics.numberOfCopies();
+
+        std::atomic<bool> done(false);
+        std::vector<double> stalls;
+        std::size_t numberOfReprocessedPoints = 0;
+        std::size_t numberOfVersionsSeen = 0;
+        std::thread reader([&]() {
+            std::size_t version = 0;
+            ConcurrentGraphics::ChangesType changes;
+            double sum = 0;
+            while(!done) {
+                const Clock::time_point start = Clock::now();
+                ConcurrentGraphics::Snapshot snapshot = graphics.snapshot();
+                stalls.push_back(secondsSince(start));
+                if(snapshot->version() == version) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const Graphics& g = snapshot->graphics();
+                if(!snapshot->changes(version, changes)) {
+                    changes.clear();
+                    changes.points_.insert(0, g.numberOfPoints());
+                }
+                for(std::size_t k = 0; k < changes.points_.size(); ++k) {
+                    for(size_type j = changes.points_[k].begin_; j < changes.points_[k].end_; ++j) {
+                        sum += g.point(j)[0];
+                    }
+                }
+                numberOfReprocessedPoints += changes.points_.numberOfIndices();
+                ++numberOfVersionsSeen;
+                version = snapshot->version();
+            }
+            checksum += sum;
+        });
+
+        std::mt19937 randomEngine(42);
+        std::vector<double> modifications;
+        std::vector<double> publications;
+        const Clock::time_point start = Clock::now();
+        for(std::size_t u = 0; u < numberOfUpdates; ++u) {
+            Clock::time_point t = Clock::now();
+            modify(graphics, randomEngine, numberOfModifications);
+            modifications.push_back(secondsSince(t));
+            t = Clock::now();
+            graphics.publish();
+            publications.push_back(secondsSince(t));
+        }
+        const double total = secondsSince(start);
+        done = true;
+        reader.join();
+
+        std::cout << "ConcurrentGraphics: " << numberOfUpdates / total << " updates/s, "
+            << graphics.numberOfCopies() - initialCopies << " full copies" << std::endl;
+        print("writer, modify", modifications);
+        print("writer, publish", publications);
+        print("reader, snapshot", stalls);
+        std::cout << "  reader: " << numberOfVersionsSeen << " versions, "
+            << static_cast<double>(numberOfReprocessedPoints) / std::max<std::size_t>(numberOfVersionsSeen, 1)
+            << " points reprocessed per version" << std::endl;
+    }
+
+    // baseline: mutex, reader copies the graphics entirely
+    {
+        Graphics graphics;
+        initialize(graphics, numberOfPoints);
+        std::mutex mutex;
+
+        std::atomic<bool> done(false);
+        std::vector<double> stalls;
+        std::size_t numberOfCopies = 0;
+        std::thread reader([&]() {
+            double sum = 0;
+            while(!done) {
+                const Clock::time_point start = Clock::now();
+                Graphics copy;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    copy = graphics;
+                }
+                stalls.push_back(secondsSince(start));
+                for(size_type j = 0; j < copy.numberOfPoints(); ++j) {
+                    sum += copy.point(j)[0];
+                }
+                ++numberOfCopies;
+            }
+            checksum += sum;
+        });
+
+        std::mt19937 randomEngine(42);
+        std::vector<double> updates;
+        const Clock::time_point start = Clock::now();
+        for(std::size_t u = 0; u < numberOfUpdates; ++u) {
+            const Clock::time_point t = Clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                modify(graphics, randomEngine, numberOfModifications);
+            }
+            updates.push_back(secondsSince(t));
+        }
+        const double total = secondsSince(start);
+        done = true;
+        reader.join();
+
+        std::cout << "mutex and copy: " << numberOfUpdates / total << " updates/s" << std::endl;
+        print("writer, lock and modify", updates);
+        print("reader, lock and copy", stalls);
+        std::cout << "  reader: " << numberOfCopies << " versions, "
+            << numberOfPoints + numberOfUpdates * numberOfModifications / 2 << " points reprocessed per version on average" << std::endl;
+    }
+
+    std::cout << "(" << checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Measures screen-space culling: the numbers of primitives dropped for
+// different tolerances, the time of the culling, and the size and write
+// time of the resulting SVG, compared to the SVG of all primitives.
+//
+// usage: benchmark-graphics-culling [grid size n (default: 1500)]
+//
+// The graphics is the grid mesh of defineGrid() in scenes.hxx, scaled to
+// the unit cube. It is projected onto a canvas of
+// 1024 x 768 pixels such that about a quarter of it lies outside the canvas.
+//
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/culling.hxx"
+#include "andres/graphics/svg.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ScreenSpaceCulling<> ScreenSpaceCulling;
+typedef Graphics::size_type size_type;
+
+struct Projection {
+    typedef float value_type;
+    typedef std::size_t size_type;
+
+    void operator()(const float x, const float y, const float z, float& r, float& s) const
+        { r = 1200 * x + 2 * z - 100; s = 900 * y + z - 100; }
+};
+
+int main(int argc, char** argv) {
+    const size_type n = argc > 1 ? std::stoull(argv[1]) : 1500;
+    const std::string fileName = "benchmark-graphics-culling.svg";
+
+    Graphics graphics;
+    defineGrid(graphics, n, [n](const std::size_t x, const std::size_t y, float* coordinates) {
+        coordinates[0] = static_cast<float>(x) / n;
+        coordinates[1] = static_cast<float>(y) / n;
+        coordinates[2] = static_cast<float>((x * y) % 7) / 7;
+    });
+    const std::size_t primitives = numberOfPrimitives(graphics);
+    std::cout << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles" << std::endl;
+
+    {
+        std::size_t bytes = 0;
+        const double tWrite = seconds([&]() {
+            std::ofstream file(fileName.c_str());
+            bytes = andres::graphics::saveSVG(graphics, Projection(), file);
+        });
+        std::cout << "no culling: " << primitives << " primitives, "
+            << bytes / 1e6 << " MB SVG, write " << tWrite << " s" << std::endl;
+    }
+
+    const float tolerances[] = {0.0f, 0.5f, 1.0f, 2.0f, 4.0f};
+    for(std::size_t j = 0; j < sizeof(tolerances) / sizeof(float); ++j) {
+        ScreenSpaceCulling culling(0, 0, 1024, 768, tolerances[j]);
+        const double tCull = seconds([&]() { culling(graphics, Projection()); });
+        std::size_t bytes = 0;
+        const double tWrite = seconds([&]() {
+            std::ofstream file(fileName.c_str());
+            bytes = andres::graphics::saveSVG(graphics, culling, file);
+        });
+        const std::size_t kept = culling.points().kept_ + culling.lines().kept_ + culling.triangles().kept_;
+        std::cout << "tolerance " << tolerances[j] << " px: "
+            << kept << " primitives kept (" << 100.0 * kept / primitives << "%), "
+            << bytes / 1e6 << " MB SVG, cull " << tCull << " s, write " << tWrite << " s" << std::endl
+            << "  points: " << culling.points() << std::endl
+            << "  lines: " << culling.lines() << std::endl
+            << "  triangles: " << culling.triangles() << std::endl;
+    }
+    std::remove(fileName.c_str());
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Compares file size and save/load throughput of the contiguous HDF5 layout
+// with chunked, shuffled and deflate-compressed layouts, with compact index
+// types and quantized coordinates, and of loading
+// the whole graphics with streaming it in batches.
+//
+// usage: benchmark-graphics-hdf5 [grid size n (default: 2000)] [chunk size (default: 65536)]
+//
+// The graphics is the grid mesh of defineGrid() in scenes.hxx, whose
+// coordinates are small integers that compress well.
+//
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "andres/graphics/graphics-hdf5.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef Graphics::size_type size_type;
+
+// visitor that only counts the streamed elements
+struct CountingVisitor {
+    typedef float value_type;
+    typedef std::size_t size_type;
+
+    CountingVisitor()
+        : numberOfElements(0)
+        {}
+    template<class V>
+    void pointProperties(const V&)
+        {}
+    template<class V>
+    void points(const V& batch, const std::size_t)
+        { numberOfElements += batch.size(); }
+    template<class V>
+    void lineProperties(const V&)
+        {}
+    template<class V>
+    void lines(const V& batch, const std::size_t)
+        { numberOfElements += batch.size(); }
+    template<class V>
+    void triangleProperties(const V&)
+        {}
+    template<class V>
+    void triangles(const V& batch, const std::size_t)
+        { numberOfElements += batch.size(); }
+
+    std::size_t numberOfElements;
+};
+
+void benchmark(
+    const std::string& name,
+    const Graphics& graphics,
+    const andres::graphics::hdf5::SaveOptions& saveOptions,
+    const double bytes
+) {
+    const std::string fileName = "benchmark-graphics-hdf5.h5";
+    const double tSave = seconds([&]() {
+        hid_t file = andres::graphics::hdf5::createFile(fileName);
+        andres::graphics::hdf5::save(file, graphics, saveOptions);
+        andres::graphics::hdf5::closeFile(file);
+    });
+    const double bytesOnDisk = fileSize(fileName);
+    Graphics graphicsLoaded;
+    const double tLoad = seconds([&]() {
+        hid_t file = andres::graphics::hdf5::openFile(fileName);
+        andres::graphics::hdf5::load(file, graphicsLoaded);
+        andres::graphics::hdf5::closeFile(file);
+    });
+    CountingVisitor visitor;
+    const double tStream = seconds([&]() {
+        hid_t file = andres::graphics::hdf5::openFile(fileName);
+        andres::graphics::hdf5::visit(file, visitor);
+        andres::graphics::hdf5::closeFile(file);
+    });
+    std::remove(fileName.c_str());
+
+    std::cout << name << "\t" << bytesOnDisk / 1e6 << " MB"
+        << "\t" << bytes / bytesOnDisk << "x"
+        << "\t" << tSave << " s (" << bytes / tSave / 1e6 << " MB/s)"
+        << "\t" << tLoad << " s (" << bytes / tLoad / 1e6 << " MB/s)"
+        << "\t" << tStream << " s (" << bytes / tStream / 1e6 << " MB/s)"
+        << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const size_type n = argc > 1 ? std::stoull(argv[1]) : 2000;
+    const hsize_t chunkSize = argc > 2 ? std::stoull(argv[2]) : 1 << 16;
+
+    Graphics graphics;
+    defineGrid(graphics, n);
+    const double bytes = bytesInMemory(graphics);
+
+    std::cout << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles, "
+        << bytes / 1e6 << " MB in memory" << std::endl
+        << "layout\tfile size\tratio\tsave\tload\tstream (batches of 2^20)" << std::endl;
+
+    typedef andres::graphics::hdf5::SaveOptions SaveOptions;
+    benchmark("contiguous", graphics, SaveOptions(), bytes);
+    benchmark("chunked", graphics, SaveOptions(chunkSize), bytes);
+    benchmark("deflate-1", graphics, SaveOptions(chunkSize, 1, false), bytes);
+    benchmark("shuffle+deflate-1", graphics, SaveOptions::compressed(chunkSize, 1), bytes);
+    benchmark("shuffle+deflate-4", graphics, SaveOptions::compressed(chunkSize, 4), bytes);
+    benchmark("shuffle+deflate-9", graphics, SaveOptions::compressed(chunkSize, 9), bytes);
+    benchmark("compact", graphics, SaveOptions(0, 0, true, true), bytes);
+    benchmark("compact+shuffle+deflate-4", graphics, SaveOptions(chunkSize, 4, true, true), bytes);
+    benchmark("quantized", graphics, SaveOptions(0, 0, true, true, true), bytes);
+    benchmark("quantized+shuffle+deflate-4", graphics, SaveOptions(chunkSize, 4, true, true, true), bytes);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Measures the scaling of center(), normalize() and transform() from 1 to N
+// threads.
+//
+// usage: benchmark-graphics-parallel [number of points (default: 100000000)] [N (default: number of hardware threads)]
+//
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+int main(int argc, char** argv) {
+    const size_type numberOfPoints = argc > 1 ? std::stoull(argv[1]) : 100000000;
+    const size_type maximumNumberOfThreads = argc > 2 ? std::stoull(argv[2]) : ParallelOptions().numberOfThreads();
+
+    Graphics graphics;
+    defineRandomPoints(graphics, numberOfPoints);
+    const float matrix[3][4] = {
+        {0.0f, -1.0f, 0.0f, 1.0f},
+        {1.0f, 0.0f, 0.0f, 2.0f},
+        {0.0f, 0.0f, 1.0f, 3.0f}
+    };
+
+    std::cout << numberOfPoints << " points" << std::endl
+        << "threads\tcenter() [ms]\tnormalize() [ms]\ttransform() [ms]\tspeedup" << std::endl;
+    // 1, 2, 4, ... threads and maximumNumberOfThreads last
+    std::vector<size_type> numbersOfThreads;
+    for(size_type numberOfThreads = 1; numberOfThreads < maximumNumberOfThreads; numberOfThreads *= 2) {
+        numbersOfThreads.push_back(numberOfThreads);
+    }
+    if(maximumNumberOfThreads > 0) {
+        numbersOfThreads.push_back(maximumNumberOfThreads);
+    }
+
+    double tSerial = 0;
+    for(std::size_t j = 0; j < numbersOfThreads.size(); ++j) {
+        const size_type numberOfThreads = numbersOfThreads[j];
+        const ParallelOptions parallelOptions(numberOfThreads);
+        Graphics g = graphics;
+        const double tCenter = milliseconds([&]() { g.center(parallelOptions); });
+        const double tNormalize = milliseconds([&]() { g.normalize(parallelOptions); });
+        const double tTransform = milliseconds([&]() { g.transform(matrix, parallelOptions); });
+        const double t = tCenter + tNormalize + tTransform;
+        if(numberOfThreads == 1) {
+            tSerial = t;
+        }
+        std::cout << numberOfThreads << "\t" << tCenter << "\t" << tNormalize << "\t" << tTransform
+            << "\t" << tSerial / t << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Measures the software rasterizer: the latency of rendering one large
+// scene with different numbers of threads and tile sizes, the throughput of
+// rendering many small scenes, and the time and size of PNG and PPM output.
+//
+// usage: benchmark-graphics-rasterizer [grid size n (default: 1000)] [width (default: 1024)] [height (default: 768)]
+//
+// The large scene is the grid mesh of defineGrid() in scenes.hxx on a height
+// field, seen from above at an angle, with half transparent triangles. The
+// small scenes are 100 x 100 grids.
+//
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/rasterizer.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::AffineProjection<> Projection;
+typedef andres::graphics::Framebuffer Framebuffer;
+typedef andres::graphics::RasterizerOptions RasterizerOptions;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+// grid mesh on a height field in [-0.5, 0.5]^2, with a checkerboard of
+// opaque and half transparent triangles
+void defineHeightField(Graphics& graphics, const size_type n) {
+    const size_type pointProperty = graphics.definePointProperty(true, 200, 0, 0);
+    const size_type lineProperty = graphics.defineLineProperty(true, 0, 0, 100);
+    const size_type triangleProperties[] = {
+        graphics.defineTriangleProperty(true, 80, 160, 220),
+        graphics.defineTriangleProperty(true, 220, 160, 80, 128)
+    };
+    defineGrid(graphics, n,
+        [n](const std::size_t x, const std::size_t y, float* coordinates) {
+            const float u = static_cast<float>(x) / n - 0.5f;
+            const float v = static_cast<float>(y) / n - 0.5f;
+            coordinates[0] = u;
+            coordinates[1] = v;
+            coordinates[2] = 0.1f * std::sin(10 * u) * std::cos(10 * v);
+        },
+        pointProperty, lineProperty,
+        [&triangleProperties](const std::size_t x, const std::size_t y) {
+            return triangleProperties[(x / 16 + y / 16) % 2];
+        }
+    );
+}
+
+int main(int argc, char** argv) {
+    const size_type n = argc > 1 ? std::stoull(argv[1]) : 1000;
+    const std::size_t width = argc > 2 ? std::stoul(argv[2]) : 1024;
+    const std::size_t height = argc > 3 ? std::stoul(argv[3]) : 768;
+
+    // view rotated by 60 degrees around the x axis, [-1, 1]^2 onto the window
+    const float w = static_cast<float>(width) / 2;
+    const float h = static_cast<float>(height) / 2;
+    const float c = 0.5f;
+    const float s = 0.866f;
+    const float matrix[3][4] = {
+        {1.5f * w, 0.0f, 0.0f, w},
+        {0.0f, -1.5f * h * c, 1.5f * h * s, h},
+        {0.0f, s, c, 0.0f}
+    };
+    const Projection projection(matrix);
+
+    Graphics graphics;
+    defineHeightField(graphics, n);
+    std::cout << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles, "
+        << width << " x " << height << " pixels" << std::endl;
+
+    // latency
+    Framebuffer framebuffer(width, height);
+    const std::size_t hardwareThreads = ParallelOptions().numberOfThreads();
+    for(std::size_t numberOfThreads = 1; ; numberOfThreads *= 2) {
+        numberOfThreads = std::min(numberOfThreads, hardwareThreads);
+        double t = std::numeric_limits<double>::infinity();
+        for(std::size_t j = 0; j < 3; ++j) {
+            t = std::min(t, seconds([&]() {
+                framebuffer.clear(255, 255, 255);
+                andres::graphics::rasterize(graphics, projection, framebuffer, RasterizerOptions(), ParallelOptions(numberOfThreads));
+            }));
+        }
+        std::cout << "render, " << numberOfThreads << " thread(s): " << 1e3 * t << " ms" << std::endl;
+        if(numberOfThreads == hardwareThreads) {
+            break;
+        }
+    }
+    const std::size_t tileSizes[] = {16, 32, 64, 128, 256};
+    for(std::size_t j = 0; j < sizeof(tileSizes) / sizeof(std::size_t); ++j) {
+        RasterizerOptions options;
+        options.tileSize_ = tileSizes[j];
+        const double t = seconds([&]() {
+            framebuffer.clear(255, 255, 255);
+            andres::graphics::rasterize(graphics, projection, framebuffer, options);
+        });
+        std::cout << "render, tiles of " << tileSizes[j] << " pixels: " << 1e3 * t << " ms" << std::endl;
+    }
+
+    // output
+    {
+        framebuffer.clear(255, 255, 255);
+        andres::graphics::rasterize(graphics, projection, framebuffer);
+        std::ostringstream ppm;
+        std::size_t bytes = 0;
+        double t = seconds([&]() { bytes = andres::graphics::savePPM(framebuffer, ppm); });
+        std::cout << "PPM: " << bytes << " bytes, " << 1e3 * t << " ms" << std::endl;
+        const int levels[] = {1, 6, 9};
+        for(std::size_t j = 0; j < 3; ++j) {
+            std::ostringstream png;
+            t = seconds([&]() { bytes = andres::graphics::savePNG(framebuffer, png, levels[j]); });
+            std::cout << "PNG, compression level " << levels[j] << ": " << bytes << " bytes, " << 1e3 * t << " ms" << std::endl;
+        }
+    }
+
+    // throughput
+    {
+        Graphics small;
+        defineHeightField(small, 100);
+        const std::size_t numberOfImages = 100;
+        Framebuffer smallFramebuffer(width / 4, height / 4);
+        const float smallMatrix[3][4] = {
+            {matrix[0][0] / 4, matrix[0][1] / 4, matrix[0][2] / 4, matrix[0][3] / 4},
+            {matrix[1][0] / 4, matrix[1][1] / 4, matrix[1][2] / 4, matrix[1][3] / 4},
+            {matrix[2][0], matrix[2][1], matrix[2][2], matrix[2][3]}
+        };
+        const double t = seconds([&]() {
+            for(std::size_t j = 0; j < numberOfImages; ++j) {
+                smallFramebuffer.clear(255, 255, 255);
+                andres::graphics::rasterize(small, Projection(smallMatrix), smallFramebuffer);
+                std::ostringstream png;
+                andres::graphics::savePNG(smallFramebuffer, png);
+            }
+        });
+        std::cout << numberOfImages << " images of " << small.numberOfPoints() + small.numberOfLines() + small.numberOfTriangles()
+            << " primitives, " << width / 4 << " x " << height / 4 << " pixels, rendered and saved as PNG: "
+            << numberOfImages / t << " images/s" << std::endl;
+    }
+
+    return 0;
+}
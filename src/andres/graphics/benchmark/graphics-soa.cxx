@@ -0,0 +1,54 @@
+// Compares center() and normalize() on the array-of-structures layout of
+// Graphics with the structure-of-arrays layout of GraphicsSoA.
+//
+// usage: benchmark-graphics-soa [number of points (default: 100000000)]
+//
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "andres/graphics/graphics-soa.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::GraphicsSoA<> GraphicsSoA;
+typedef Graphics::size_type size_type;
+
+template<class GRAPHICS>
+void benchmark(const std::string& name, GRAPHICS& g, const std::size_t bytes) {
+    const double n = static_cast<double>(g.numberOfPoints());
+    const double tCenter = milliseconds([&]() { g.center(); });
+    const double tCenter0 = milliseconds([&]() { g.center(0); });
+    const double tNormalize = milliseconds([&]() { g.normalize(); });
+    const double tNormalize0 = milliseconds([&]() { g.normalize(0); });
+    const double tNormalize01 = milliseconds([&]() { g.normalize(0, 1); });
+    std::cout << name << ": " << bytes / n << " bytes/point" << std::endl
+        << "  center()         " << tCenter << " ms (" << n / tCenter / 1e3 << " Mpoints/s)" << std::endl
+        << "  center(0)        " << tCenter0 << " ms (" << n / tCenter0 / 1e3 << " Mpoints/s)" << std::endl
+        << "  normalize()      " << tNormalize << " ms (" << n / tNormalize / 1e3 << " Mpoints/s)" << std::endl
+        << "  normalize(0)     " << tNormalize0 << " ms (" << n / tNormalize0 / 1e3 << " Mpoints/s)" << std::endl
+        << "  normalize(0, 1)  " << tNormalize01 << " ms (" << n / tNormalize01 / 1e3 << " Mpoints/s)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const size_type numberOfPoints = argc > 1 ? std::stoull(argv[1]) : 100000000;
+
+    Graphics graphics;
+    defineRandomPoints(graphics, numberOfPoints);
+    GraphicsSoA graphicsSoA(graphics);
+
+    std::cout << numberOfPoints << " points" << std::endl;
+    benchmark("AoS (Graphics)", graphics, numberOfPoints * sizeof(Graphics::PointType));
+    benchmark("SoA (GraphicsSoA)", graphicsSoA, numberOfPoints * (3 * sizeof(float) + sizeof(GraphicsSoA::property_index_type)));
+
+    // the results of both layouts are identical
+    for(size_type j = 0; j < numberOfPoints; ++j) {
+        if(!(graphics.point(j) == graphicsSoA.point(j))) {
+            std::cerr << "results differ at point " << j << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+// Measures the spatial index: the time to build it with different numbers
+// of threads, the time to add recently defined primitives, and the latency
+// of box queries, nearest point queries and ray picks, compared to brute
+// force scans over all primitives.
+//
+// usage: benchmark-graphics-spatial-index [grid size n (default: 1000)]
+//
+// The scene is the grid mesh of defineGrid() in scenes.hxx on a height
+// field in the unit square.
+//
+#include <cstddef>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/spatial-index.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::SpatialIndex<> SpatialIndex;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+// grid mesh on a height field in the unit square, at the given height
+void defineHeightField(Graphics& graphics, const size_type n, const float offset) {
+    defineGrid(graphics, n, [n, offset](const std::size_t x, const std::size_t y, float* coordinates) {
+        const float u = static_cast<float>(x) / n;
+        const float v = static_cast<float>(y) / n;
+        coordinates[0] = u;
+        coordinates[1] = v;
+        coordinates[2] = offset + 0.1f * std::sin(10 * u) * std::cos(10 * v);
+    });
+}
+
+int main(int argc, char** argv) {
+    const size_type n = argc > 1 ? std::stoull(argv[1]) : 1000;
+    const std::size_t numberOfQueries = 1000;
+    const std::size_t numberOfBruteForceQueries = 10;
+
+    Graphics graphics;
+    defineHeightField(graphics, n, 0.0f);
+    std::cout << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles" << std::endl;
+
+    // build
+    const std::size_t hardwareThreads = ParallelOptions().numberOfThreads();
+    for(std::size_t numberOfThreads = 1; ; numberOfThreads *= 2) {
+        numberOfThreads = std::min(numberOfThreads, hardwareThreads);
+        const double t = seconds([&]() { SpatialIndex index(graphics, ParallelOptions(numberOfThreads)); });
+        std::cout << "build, " << numberOfThreads << " thread(s): " << t << " s" << std::endl;
+        if(numberOfThreads == hardwareThreads) {
+            break;
+        }
+    }
+    SpatialIndex index(graphics);
+
+    // queries
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, 1.0f);
+    std::vector<float> positions(3 * numberOfQueries);
+    for(std::size_t j = 0; j < positions.size(); ++j) {
+        positions[j] = coordinate(randomEngine);
+    }
+    const float extent = 0.01f;
+    std::vector<size_type> result;
+    std::size_t found = 0;
+
+    const double tBox = seconds([&]() {
+        for(std::size_t q = 0; q < numberOfQueries; ++q) {
+            const float minimum[] = {positions[3 * q], positions[3 * q + 1], -1.0f};
+            const float maximum[] = {positions[3 * q] + extent, positions[3 * q + 1] + extent, 1.0f};
+            index.pointsInBox(minimum, maximum, result);
+            found += result.size();
+            index.linesInBox(minimum, maximum, result);
+            found += result.size();
+            index.trianglesInBox(minimum, maximum, result);
+            found += result.size();
+        }
+    }) / numberOfQueries;
+    const double tBoxBruteForce = seconds([&]() {
+        for(std::size_t q = 0; q < numberOfBruteForceQueries; ++q) {
+            const float box[] = {positions[3 * q], positions[3 * q + 1], -1.0f, positions[3 * q] + extent, positions[3 * q + 1] + extent, 1.0f};
+            for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+                const float p[] = {graphics.point(j)[0], graphics.point(j)[1], graphics.point(j)[2]};
+                found += andres::graphics::detail::segmentIntersectsBox(p, p, box);
+            }
+            for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
+                const Graphics::LineType& line = graphics.line(j);
+                const float p[] = {graphics.point(line.pointIndex(0))[0], graphics.point(line.pointIndex(0))[1], graphics.point(line.pointIndex(0))[2]};
+                const float q[] = {graphics.point(line.pointIndex(1))[0], graphics.point(line.pointIndex(1))[1], graphics.point(line.pointIndex(1))[2]};
+                found += andres::graphics::detail::segmentIntersectsBox(p, q, box);
+            }
+            for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+                const Graphics::TriangleType& triangle = graphics.triangle(j);
+                float v[3][3];
+                for(std::size_t m = 0; m < 3; ++m) {
+                    for(std::size_t k = 0; k < 3; ++k) {
+                        v[m][k] = graphics.point(triangle.pointIndex(m))[k];
+                    }
+                }
+                found += andres::graphics::detail::triangleIntersectsBox(v[0], v[1], v[2], box);
+            }
+        }
+    }) / numberOfBruteForceQueries;
+    std::cout << "box query: " << 1e6 * tBox << " us, brute force " << 1e6 * tBoxBruteForce << " us" << std::endl;
+
+    const std::size_t k = 10;
+    const double tNearest = seconds([&]() {
+        for(std::size_t q = 0; q < numberOfQueries; ++q) {
+            index.nearestPoints(&positions[3 * q], k, result);
+            found += result.size();
+        }
+    }) / numberOfQueries;
+    const double tNearestBruteForce = seconds([&]() {
+        for(std::size_t q = 0; q < numberOfBruteForceQueries; ++q) {
+            std::vector<std::pair<float, size_type> > distances(graphics.numberOfPoints());
+            for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+                float d = 0;
+                for(std::size_t c = 0; c < 3; ++c) {
+                    d += (graphics.point(j)[c] - positions[3 * q + c]) * (graphics.point(j)[c] - positions[3 * q + c]);
+                }
+                distances[j] = std::make_pair(d, j);
+            }
+            std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+            found += distances[0].second;
+        }
+    }) / numberOfBruteForceQueries;
+    std::cout << k << " nearest points: " << 1e6 * tNearest << " us, brute force " << 1e6 * tNearestBruteForce << " us" << std::endl;
+
+    const float direction[] = {0.0f, 0.0f, -1.0f};
+    const float tolerance = 0.5f / n;
+    const double tPick = seconds([&]() {
+        for(std::size_t q = 0; q < numberOfQueries; ++q) {
+            const float origin[] = {positions[3 * q], positions[3 * q + 1], 1.0f};
+            found += index.pick(origin, direction, tolerance).kind_;
+        }
+    }) / numberOfQueries;
+    const double tPickBruteForce = seconds([&]() {
+        for(std::size_t q = 0; q < numberOfBruteForceQueries; ++q) {
+            const float origin[] = {positions[3 * q], positions[3 * q + 1], 1.0f};
+            float distance = std::numeric_limits<float>::infinity();
+            for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+                const Graphics::TriangleType& triangle = graphics.triangle(j);
+                float v[3][3];
+                for(std::size_t m = 0; m < 3; ++m) {
+                    for(std::size_t c = 0; c < 3; ++c) {
+                        v[m][c] = graphics.point(triangle.pointIndex(m))[c];
+                    }
+                }
+                distance = std::min(distance, andres::graphics::detail::rayTriangleDistance(origin, direction, v[0], v[1], v[2]));
+            }
+            for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
+                const Graphics::LineType& line = graphics.line(j);
+                const float p[] = {graphics.point(line.pointIndex(0))[0], graphics.point(line.pointIndex(0))[1], graphics.point(line.pointIndex(0))[2]};
+                const float r[] = {graphics.point(line.pointIndex(1))[0], graphics.point(line.pointIndex(1))[1], graphics.point(line.pointIndex(1))[2]};
+                distance = std::min(distance, andres::graphics::detail::raySegmentDistance(origin, direction, p, r, tolerance));
+            }
+            for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+                const float p[] = {graphics.point(j)[0], graphics.point(j)[1], graphics.point(j)[2]};
+                distance = std::min(distance, andres::graphics::detail::raySegmentDistance(origin, direction, p, p, tolerance));
+            }
+            found += distance < 2;
+        }
+    }) / numberOfBruteForceQueries;
+    std::cout << "pick: " << 1e6 * tPick << " us, brute force " << 1e6 * tPickBruteForce << " us" << std::endl;
+
+    // incremental update: a second grid, defined in batches of 1% of the first
+    const size_type numberOfPoints = graphics.numberOfPoints();
+    const size_type m = n / 10;
+    double tUpdate = 0;
+    std::size_t numberOfUpdates = 0;
+    for(std::size_t j = 0; j < 30; ++j) {
+        defineHeightField(graphics, m, 1.0f + j);
+        tUpdate += seconds([&]() { index.update(); });
+        ++numberOfUpdates;
+    }
+    std::cout << "update by " << (graphics.numberOfPoints() - numberOfPoints) / numberOfUpdates
+        << " points, lines and triangles each: " << 1e3 * tUpdate / numberOfUpdates << " ms on average" << std::endl;
+
+    std::cout << "(" << found << " primitives found)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Measures throughput and peak memory of each stage of the pipeline from
+// loading to rendering, on synthetic scenes of configurable size, and
+// prints the costs recorded by the instrumentation hooks.
+//
+// usage: benchmark-graphics-suite [number of points (default: 2000000)] [grid size n (default: 1000)] [number of graph vertices k (default: 500)] [number of threads (default: 0, one per hardware thread)]
+//
+// The scenes are the synthetic scenes of scenes.hxx: a point cloud of
+// random points in a cube, the n x n grid mesh of defineGrid() and a dense
+// graph of k points with k (k - 1) / 2 lines.
+// The stages are the generation of the scene, HDF5 save and load, center(),
+// normalize(), saveSVG() and rasterize(), which stands in for the display
+// of the OpenGL viewer. Peak memory is the maximum resident set size during
+// a stage above the resident set size at its start. It is measured per
+// stage by resetting the peak in /proc/self/clear_refs, where available.
+//
+#include <sys/resource.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#ifndef ANDRES_GRAPHICS_WITH_INSTRUMENTATION
+#   define ANDRES_GRAPHICS_WITH_INSTRUMENTATION
+#endif
+#include "andres/graphics/graphics-hdf5.hxx"
+#include "andres/graphics/instrumentation.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/rasterizer.hxx"
+#include "andres/graphics/svg.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+// field of /proc/self/status in bytes, or 0 if not available
+double memoryStatus(const std::string& key) {
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while(std::getline(file, line)) {
+        if(line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':') {
+            return 1024.0 * std::stod(line.substr(key.size() + 1));
+        }
+    }
+    return 0;
+}
+
+double residentMemory() {
+    return memoryStatus("VmRSS");
+}
+
+double peakMemory() {
+    const double peak = memoryStatus("VmHWM");
+    if(peak != 0) {
+        return peak;
+    }
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return 1024.0 * usage.ru_maxrss;
+}
+
+// reset the peak resident set size to the current one
+bool resetPeakMemory() {
+    std::ofstream file("/proc/self/clear_refs");
+    file << "5";
+    file.close();
+    return !file.fail();
+}
+
+// run one stage and print its time, throughput and peak memory. items and
+// bytes are called after the stage, such that they can depend on its result.
+template<class FUNCTION, class ITEMS, class BYTES>
+void stage(const std::string& name, FUNCTION f, ITEMS items, BYTES bytes) {
+    const bool perStage = resetPeakMemory();
+    const double before = residentMemory();
+    const double t = seconds(f);
+    const double peak = peakMemory();
+    std::cout << "  " << std::left << std::setw(12) << name << std::right
+        << std::setw(12) << 1e3 * t << " ms"
+        << std::setw(12) << 1e-6 * items() / t << " M primitives/s"
+        << std::setw(12) << 1e-6 * bytes() / t << " MB/s"
+        << std::setw(12) << 1e-6 * (perStage ? peak - before : peak) << " MB peak"
+        << (perStage ? "" : " (since start)") << std::endl;
+}
+
+template<class GENERATOR>
+void benchmark(const std::string& name, GENERATOR define, const ParallelOptions& parallelOptions) {
+    std::cout << name << std::endl;
+    const std::string fileNameHDF5 = "benchmark-graphics-suite.h5";
+    const std::string fileNameSVG = "benchmark-graphics-suite.svg";
+
+    Graphics graphics;
+    stage("generate",
+        [&]() { define(graphics); },
+        [&]() { return numberOfPrimitives(graphics); },
+        [&]() { return bytesInMemory(graphics); });
+    std::cout << "  (" << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles, "
+        << 1e-6 * bytesInMemory(graphics) << " MB)" << std::endl;
+
+    stage("hdf5 save",
+        [&]() {
+            hid_t file = andres::graphics::hdf5::createFile(fileNameHDF5);
+            andres::graphics::hdf5::save(file, graphics);
+            andres::graphics::hdf5::closeFile(file);
+        },
+        [&]() { return numberOfPrimitives(graphics); },
+        [&]() { return fileSize(fileNameHDF5); });
+
+    graphics = Graphics();
+    stage("hdf5 load",
+        [&]() {
+            hid_t file = andres::graphics::hdf5::openFile(fileNameHDF5);
+            andres::graphics::hdf5::load(file, graphics, parallelOptions);
+            andres::graphics::hdf5::closeFile(file);
+        },
+        [&]() { return numberOfPrimitives(graphics); },
+        [&]() { return fileSize(fileNameHDF5); });
+    std::remove(fileNameHDF5.c_str());
+
+    stage("center",
+        [&]() { graphics.center(parallelOptions); },
+        [&]() { return graphics.numberOfPoints(); },
+        [&]() { return graphics.numberOfPoints() * sizeof(Graphics::PointType); });
+    stage("normalize",
+        [&]() { graphics.normalize(parallelOptions); },
+        [&]() { return graphics.numberOfPoints(); },
+        [&]() { return graphics.numberOfPoints() * sizeof(Graphics::PointType); });
+
+    std::size_t bytesSVG = 0;
+    stage("saveSVG",
+        [&]() {
+            std::ofstream file(fileNameSVG.c_str());
+            bytesSVG = andres::graphics::saveSVG(graphics, andres::graphics::OrthogonalProjection<>(), file);
+        },
+        [&]() { return numberOfPrimitives(graphics); },
+        [&]() { return bytesSVG; });
+    std::remove(fileNameSVG.c_str());
+
+    // camera viewing [-1, 1]^2 in a window of 1024 x 768 pixels
+    const std::size_t width = 1024;
+    const std::size_t height = 768;
+    const float matrix[3][4] = {
+        {0.5f * width, 0.0f, 0.0f, 0.5f * width},
+        {0.0f, -0.5f * height, 0.0f, 0.5f * height},
+        {0.0f, 0.0f, 1.0f, 0.0f}
+    };
+    const andres::graphics::AffineProjection<> projection(matrix);
+    andres::graphics::Framebuffer framebuffer(width, height);
+    stage("rasterize",
+        [&]() {
+            framebuffer.clear(255, 255, 255);
+            andres::graphics::rasterize(graphics, projection, framebuffer,
+                andres::graphics::RasterizerOptions(), parallelOptions);
+        },
+        [&]() { return numberOfPrimitives(graphics); },
+        [&]() { return bytesInMemory(graphics); });
+}
+
+int main(int argc, char** argv) {
+    const std::size_t numberOfPoints = argc > 1 ? std::stoull(argv[1]) : 2000000;
+    const std::size_t n = argc > 2 ? std::stoull(argv[2]) : 1000;
+    const std::size_t k = argc > 3 ? std::stoull(argv[3]) : 500;
+    const ParallelOptions parallelOptions(argc > 4 ? std::stoull(argv[4]) : 0);
+    std::cout << parallelOptions.numberOfThreads() << " threads" << std::endl;
+
+    benchmark("point cloud", [&](Graphics& graphics) { defineRandomPoints(graphics, numberOfPoints); }, parallelOptions);
+    benchmark("grid mesh", [&](Graphics& graphics) { defineGrid(graphics, n); }, parallelOptions);
+    benchmark("dense graph", [&](Graphics& graphics) { defineCompleteGraph(graphics, k); }, parallelOptions);
+
+    // costs recorded by the hooks, summed over all scenes
+    std::cout << "instrumentation hooks" << std::endl;
+    andres::graphics::instrumentation::print(std::cout);
+
+    // overhead of one hook, enabled and disabled at runtime
+    const std::size_t numberOfCalls = 10000000;
+    for(std::size_t enabled = 0; enabled < 2; ++enabled) {
+        andres::graphics::instrumentation::enable(enabled == 1);
+        const double t = seconds([&]() {
+            for(std::size_t j = 0; j < numberOfCalls; ++j) {
+                ANDRES_GRAPHICS_TIMER(timer, "overhead");
+                timer.addItems(j);
+            }
+        });
+        std::cout << "hook overhead, " << (enabled ? "enabled" : "disabled") << ": "
+            << 1e9 * t / numberOfCalls << " ns per call" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Compares the SVG export of saveSVG() with the previous writer that
+// formats every number with std::ostream and flushes after every element.
+//
+// usage: benchmark-graphics-svg [grid size n (default: 1000)]
+//
+// The graphics is the grid mesh of defineGrid() in scenes.hxx, scaled
+// differently along x and y such that coordinates have fractional digits.
+//
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/svg.hxx"
+
+#include "scenes.hxx"
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::OrthogonalProjection<> Projection;
+typedef Graphics::size_type size_type;
+
+// previous writer (points and lines only)
+void saveSVGPrevious(const Graphics& g, const Projection& projection, std::ostream& output) {
+    output << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>" << std::endl
+        << "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
+        << "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">" << std::endl
+        << "<svg version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\" "
+        << "xmlns:xlink=\"http://www.w3.org/1999/xlink\">" << std::endl;
+    for(size_type j = 0; j < g.numberOfPoints(); ++j) {
+        const Graphics::PointType& point = g.point(j);
+        const Graphics::PointPropertyType& pointProperty = g.pointProperty(point.propertyIndex());
+        if(pointProperty.visibility()) {
+            float x = 0;
+            float y = 0;
+            projection(point[0], point[1], point[2], x, y);
+            output << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"1pt\" style=\""
+                << "stroke:rgb(" << static_cast<unsigned int>(pointProperty.color(0))
+                << ", " << static_cast<unsigned int>(pointProperty.color(1))
+                << ", " << static_cast<unsigned int>(pointProperty.color(2)) << ");"
+                << " fill:rgb(" << static_cast<unsigned int>(pointProperty.color(0))
+                << ", " << static_cast<unsigned int>(pointProperty.color(1))
+                << ", " << static_cast<unsigned int>(pointProperty.color(2)) << ");"
+                << " stroke-width:1pt;\"/>" << std::endl;
+        }
+    }
+    for(size_type j = 0; j < g.numberOfLines(); ++j) {
+        const Graphics::LineType& line = g.line(j);
+        const Graphics::LinePropertyType& lineProperty = g.lineProperty(line.propertyIndex());
+        if(lineProperty.visibility()) {
+            const Graphics::PointType& point0 = g.point(line.pointIndex(0));
+            const Graphics::PointType& point1 = g.point(line.pointIndex(1));
+            float x1 = 0;
+            float y1 = 0;
+            projection(point0[0], point0[1], point0[2], x1, y1);
+            float x2 = 0;
+            float y2 = 0;
+            projection(point1[0], point1[1], point1[2], x2, y2);
+            output << "<line x1=\"" << x1 << "\" y1=\"" << y1 << "\" x2=\"" << x2 << "\" y2=\"" << y2 << "\""
+                << " style=\"stroke:rgb(" << static_cast<unsigned int>(lineProperty.color(0))
+                << ", " << static_cast<unsigned int>(lineProperty.color(1))
+                << ", " << static_cast<unsigned int>(lineProperty.color(2))
+                << "); stroke-width:1pt;\"/>" << std::endl;
+        }
+    }
+    output << "</svg>\n";
+}
+
+void report(const std::string& name, const std::string& fileName, const double t, const size_type numberOfElements) {
+    const double bytes = fileSize(fileName);
+    std::cout << name << "\t" << t << " s\t" << numberOfElements / t / 1e6 << " Melements/s\t"
+        << bytes / 1e6 << " MB\t" << bytes / t / 1e6 << " MB/s" << std::endl;
+    std::remove(fileName.c_str());
+}
+
+int main(int argc, char** argv) {
+    const size_type n = argc > 1 ? std::stoull(argv[1]) : 1000;
+
+    Graphics graphics;
+    defineGrid(graphics, n, [](const std::size_t x, const std::size_t y, float* coordinates) {
+        coordinates[0] = static_cast<float>(x) / 7;
+        coordinates[1] = static_cast<float>(y) / 3;
+        coordinates[2] = static_cast<float>((x * y) % 7);
+    });
+    const Projection projection;
+    const size_type numberOfPointsAndLines = graphics.numberOfPoints() + graphics.numberOfLines();
+    const size_type numberOfElements = numberOfPointsAndLines + graphics.numberOfTriangles();
+
+    std::cout << graphics.numberOfPoints() << " points, "
+        << graphics.numberOfLines() << " lines, "
+        << graphics.numberOfTriangles() << " triangles" << std::endl
+        << "writer\ttime\tthroughput\tfile size\tbytes/s" << std::endl;
+
+    report("previous (no triangles)", "benchmark-graphics-svg-previous.svg", seconds([&]() {
+        std::ofstream file("benchmark-graphics-svg-previous.svg");
+        saveSVGPrevious(graphics, projection, file);
+    }), numberOfPointsAndLines);
+
+    report("buffered", "benchmark-graphics-svg.svg", seconds([&]() {
+        std::ofstream file("benchmark-graphics-svg.svg");
+        andres::graphics::saveSVG(graphics, projection, file);
+    }), numberOfElements);
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+    report("buffered, gzip-1", "benchmark-graphics-svg.svgz", seconds([&]() {
+        andres::graphics::saveSVGZ(graphics, projection, "benchmark-graphics-svg.svgz", andres::graphics::SVGOptions(3, 1 << 20, 1));
+    }), numberOfElements);
+    report("buffered, gzip-6", "benchmark-graphics-svg.svgz", seconds([&]() {
+        andres::graphics::saveSVGZ(graphics, projection, "benchmark-graphics-svg.svgz");
+    }), numberOfElements);
+#endif
+
+    return 0;
+}
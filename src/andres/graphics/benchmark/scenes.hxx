@@ -0,0 +1,225 @@
+#pragma once
+#ifndef ANDRES_GRAPHICS_BENCHMARK_SCENES_HXX
+#define ANDRES_GRAPHICS_BENCHMARK_SCENES_HXX
+
+// Timers and synthetic scenes shared by the benchmarks.
+
+#include <cstddef>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+
+/// Seconds elapsed since start.
+///
+inline double
+secondsSince(
+    const std::chrono::steady_clock::time_point start
+) {
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+/// Seconds it takes to call f().
+///
+template<class FUNCTION>
+inline double
+seconds(
+    FUNCTION f
+) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    return secondsSince(start);
+}
+
+/// Milliseconds it takes to call f().
+///
+template<class FUNCTION>
+inline double
+milliseconds(
+    FUNCTION f
+) {
+    return 1e3 * seconds(f);
+}
+
+/// Size of a file in bytes.
+///
+inline double
+fileSize(
+    const std::string& fileName
+) {
+    std::ifstream file(fileName.c_str(), std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg());
+}
+
+/// Memory occupied by the points, lines and triangles of a graphics.
+///
+template<class GRAPHICS>
+inline double
+bytesInMemory(
+    const GRAPHICS& graphics
+) {
+    return static_cast<double>(
+        graphics.numberOfPoints() * sizeof(typename GRAPHICS::PointType)
+        + graphics.numberOfLines() * sizeof(typename GRAPHICS::LineType)
+        + graphics.numberOfTriangles() * sizeof(typename GRAPHICS::TriangleType));
+}
+
+/// Number of points, lines and triangles of a graphics.
+///
+template<class GRAPHICS>
+inline std::size_t
+numberOfPrimitives(
+    const GRAPHICS& graphics
+) {
+    return graphics.numberOfPoints() + graphics.numberOfLines() + graphics.numberOfTriangles();
+}
+
+/// Define an n x n grid mesh with n^2 points, 2 n (n - 1) lines between
+/// neighboring points and 2 (n - 1)^2 triangles, two per cell.
+///
+/// \param position Called as position(x, y, coordinates) for the point in
+///     row x and column y, to write its three coordinates.
+/// \param triangleProperty Called as triangleProperty(x, y) for the
+///     triangles of the cell in row x and column y, to return their
+///     property index.
+///
+/// Point indices start at the current number of points, such that several
+/// grids can be defined in one graphics. Memory is reserved only for the
+/// first, as reserve() sets the exact capacity.
+///
+template<class GRAPHICS, class POSITION, class TRIANGLE_PROPERTY>
+void
+defineGrid(
+    GRAPHICS& graphics,
+    const std::size_t n,
+    POSITION position,
+    const typename GRAPHICS::size_type pointProperty,
+    const typename GRAPHICS::size_type lineProperty,
+    TRIANGLE_PROPERTY triangleProperty
+) {
+    typedef typename GRAPHICS::size_type size_type;
+    typedef typename GRAPHICS::value_type value_type;
+
+    const size_type first = static_cast<size_type>(graphics.numberOfPoints());
+    const size_type m = static_cast<size_type>(n);
+    if(first == 0) {
+        graphics.reserve(n * n, 2 * n * n, 2 * n * n);
+    }
+    for(std::size_t x = 0; x < n; ++x) {
+        for(std::size_t y = 0; y < n; ++y) {
+            value_type coordinates[3] = {0, 0, 0};
+            position(x, y, coordinates);
+            graphics.definePoint(coordinates[0], coordinates[1], coordinates[2], pointProperty);
+        }
+    }
+    for(std::size_t x = 0; x < n; ++x) {
+        for(std::size_t y = 0; y < n; ++y) {
+            const size_type j = first + static_cast<size_type>(x * n + y);
+            if(x + 1 < n) {
+                graphics.defineLine(j, j + m, lineProperty);
+            }
+            if(y + 1 < n) {
+                graphics.defineLine(j, j + 1, lineProperty);
+            }
+            if(x + 1 < n && y + 1 < n) {
+                const size_type property = triangleProperty(x, y);
+                graphics.defineTriangle(j, j + 1, j + m, property);
+                graphics.defineTriangle(j + 1, j + m + 1, j + m, property);
+            }
+        }
+    }
+}
+
+/// Define an n x n grid mesh with default properties.
+///
+template<class GRAPHICS, class POSITION>
+void
+defineGrid(
+    GRAPHICS& graphics,
+    const std::size_t n,
+    POSITION position
+) {
+    defineGrid(graphics, n, position, 0, 0,
+        [](const std::size_t, const std::size_t) { return typename GRAPHICS::size_type(0); });
+}
+
+/// Define an n x n grid mesh with default properties and the point in row
+/// x and column y at (x, y, (x y) mod 7).
+///
+template<class GRAPHICS>
+void
+defineGrid(
+    GRAPHICS& graphics,
+    const std::size_t n
+) {
+    typedef typename GRAPHICS::value_type value_type;
+    defineGrid(graphics, n, [](const std::size_t x, const std::size_t y, value_type* coordinates) {
+        coordinates[0] = static_cast<value_type>(x);
+        coordinates[1] = static_cast<value_type>(y);
+        coordinates[2] = static_cast<value_type>((x * y) % 7);
+    });
+}
+
+/// Define points with coordinates drawn uniformly from [minimum, maximum),
+/// with the property indices firstProperty, firstProperty + 1, ...,
+/// firstProperty + numberOfProperties - 1 in turn.
+///
+template<class GRAPHICS>
+void
+defineRandomPoints(
+    GRAPHICS& graphics,
+    const std::size_t numberOfPoints,
+    const float minimum = -3.0f,
+    const float maximum = 7.0f,
+    const typename GRAPHICS::size_type firstProperty = 0,
+    const std::size_t numberOfProperties = 1
+) {
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<float> coordinate(minimum, maximum);
+    if(graphics.numberOfPoints() == 0) {
+        graphics.reserve(numberOfPoints, graphics.numberOfLines(), graphics.numberOfTriangles());
+    }
+    for(std::size_t j = 0; j < numberOfPoints; ++j) {
+        const float x = coordinate(randomEngine);
+        const float y = coordinate(randomEngine);
+        const float z = coordinate(randomEngine);
+        graphics.definePoint(x, y, z, firstProperty + j % numberOfProperties);
+    }
+}
+
+/// Define k random points on a sphere of the given radius and one line
+/// between every pair of them, i.e. k (k - 1) / 2 lines.
+///
+template<class GRAPHICS>
+void
+defineCompleteGraph(
+    GRAPHICS& graphics,
+    const std::size_t k,
+    const float radius = 1.0f,
+    const typename GRAPHICS::size_type lineProperty = 0
+) {
+    typedef typename GRAPHICS::size_type size_type;
+
+    std::mt19937 randomEngine(42);
+    std::normal_distribution<float> normal;
+    const size_type first = static_cast<size_type>(graphics.numberOfPoints());
+    if(first == 0) {
+        graphics.reserve(k, graphics.numberOfLines() + k * (k - 1) / 2, graphics.numberOfTriangles());
+    }
+    for(std::size_t j = 0; j < k; ++j) {
+        const float x = normal(randomEngine);
+        const float y = normal(randomEngine);
+        const float z = normal(randomEngine);
+        const float r = std::sqrt(x * x + y * y + z * z);
+        graphics.definePoint(radius * x / r, radius * y / r, radius * z / r);
+    }
+    for(size_type j = 0; j < k; ++j) {
+        for(size_type l = j + 1; l < k; ++l) {
+            graphics.defineLine(first + j, first + l, lineProperty);
+        }
+    }
+}
+
+#endif // #ifndef ANDRES_GRAPHICS_BENCHMARK_SCENES_HXX
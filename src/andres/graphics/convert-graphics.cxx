@@ -0,0 +1,90 @@
+// Converts graphics between HDF5 files and binary files that can be
+// memory-mapped (see graphics-binary.hxx). The direction is determined by
+// the type of the input file.
+//
+// HDF5 files are streamed in batches, so that files larger than the main
+// memory can be converted to binary files. Binary files are converted to
+// HDF5 files with the default layout or with the given chunk size and
+// compression.
+//
+// usage: convert-graphics [--chunk-size <elements>] [--compression <level>] <input> <output>
+//
+#include <cstddef>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <andres/graphics/graphics-hdf5.hxx>
+#include <andres/graphics/graphics-binary.hxx>
+
+typedef andres::graphics::Graphics<float, std::size_t> Graphics;
+
+void usage() {
+    std::cerr << "usage: convert-graphics [--chunk-size <elements>] [--compression <level>] <input> <output>" << std::endl
+        << std::endl
+        << "converts an HDF5 file to a binary file or a binary file to an HDF5 file." << std::endl
+        << std::endl
+        << "options (HDF5 output):" << std::endl
+        << "  --chunk-size <elements>  elements per chunk (default: 0, contiguous layout)" << std::endl
+        << "  --compression <level>    deflate level of chunks (default: 0, none)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    andres::graphics::hdf5::SaveOptions saveOptions;
+    std::string input;
+    std::string output;
+    try {
+        for(int j = 1; j < argc; ++j) {
+            const std::string argument = argv[j];
+            if(argument == "--chunk-size" && j + 1 < argc) {
+                saveOptions.chunkSize_ = std::stoull(argv[++j]);
+            }
+            else if(argument == "--compression" && j + 1 < argc) {
+                saveOptions.compressionLevel_ = std::stoul(argv[++j]);
+            }
+            else if(argument.compare(0, 2, "--") != 0 && input.empty()) {
+                input = argument;
+            }
+            else if(argument.compare(0, 2, "--") != 0 && output.empty()) {
+                output = argument;
+            }
+            else {
+                usage();
+                return 1;
+            }
+        }
+    }
+    catch(const std::exception&) { // stoull, stoul
+        usage();
+        return 1;
+    }
+    if(input.empty() || output.empty()) {
+        usage();
+        return 1;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::size_t bytes = 0;
+    if(andres::graphics::binary::isBinaryFile(input)) {
+        Graphics graphics;
+        andres::graphics::binary::load(input, graphics);
+        hid_t file = andres::graphics::hdf5::createFile(output);
+        andres::graphics::hdf5::save(file, graphics, saveOptions);
+        andres::graphics::hdf5::closeFile(file);
+    }
+    else {
+        andres::graphics::binary::Writer<float, std::size_t> writer(output);
+        hid_t file = andres::graphics::hdf5::openFile(input);
+        andres::graphics::hdf5::visit(file, writer);
+        andres::graphics::hdf5::closeFile(file);
+        bytes = writer.close();
+    }
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::cout << input << " -> " << output;
+    if(bytes != 0) {
+        std::cout << " (" << bytes << " bytes)";
+    }
+    std::cout << " in " << duration.count() << " s" << std::endl;
+
+    return 0;
+}
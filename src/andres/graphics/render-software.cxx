@@ -0,0 +1,202 @@
+// Renders graphics from HDF5 or binary files to PNG or PPM images without
+// a display or GPU, as the viewer shows them: centered and normalized, seen
+// along the z axis, with points, lines and triangles, depth test and alpha
+// blending.
+//
+// usage: render-software [options] <graphics.h5|graphics.agb> <image.png|image.ppm> [<graphics> <image> ...]
+//
+#include <cstddef>
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <andres/graphics/graphics-hdf5.hxx>
+#include <andres/graphics/graphics-binary.hxx>
+#include <andres/graphics/projection.hxx>
+#include <andres/graphics/rasterizer.hxx>
+
+typedef andres::graphics::Graphics<float, std::size_t> Graphics;
+typedef andres::graphics::AffineProjection<float, std::size_t> Projection;
+
+void usage() {
+    std::cerr << "usage: render-software [options] <graphics.h5|graphics.agb> <image.png|image.ppm> [<graphics> <image> ...]" << std::endl
+        << std::endl
+        << "options:" << std::endl
+        << "  --width <pixels>           width of the images (default: 1024)" << std::endl
+        << "  --height <pixels>          height of the images (default: 768)" << std::endl
+        << "  --rotate <x|y|z> <degrees> rotate the view around an axis, as the keys 2/8, 4/6, 1/3 of the viewer" << std::endl
+        << "                             (may be repeated, applied in the given order)" << std::endl
+        << "  --scale <factor>           scale the view (default: 1)" << std::endl
+        << "  --point-size <pixels>      edge length of points (default: 5)" << std::endl
+        << "  --line-width <pixels>      width of lines (default: 1)" << std::endl
+        << "  --tile-size <pixels>       edge length of the tiles rasterized in parallel (default: 64)" << std::endl
+        << "  --threads <number>         number of threads (default: 0, one per hardware thread)" << std::endl
+        << "  --transparent              transparent instead of white background" << std::endl
+        << "  --compression <level>      zlib compression level of PNG images (default: 6)" << std::endl;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size()
+        && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// multiply the view from the right by a rotation, as glRotatef
+void rotate(float (&view)[3][3], const std::size_t axis, const float degrees) {
+    const float angle = degrees * 3.14159265358979f / 180.0f;
+    const float c = std::cos(angle);
+    const float s = std::sin(angle);
+    float rotation[3][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    const std::size_t j = (axis + 1) % 3;
+    const std::size_t k = (axis + 2) % 3;
+    rotation[j][j] = c;
+    rotation[j][k] = -s;
+    rotation[k][j] = s;
+    rotation[k][k] = c;
+    float result[3][3];
+    for(std::size_t r = 0; r < 3; ++r) {
+        for(std::size_t t = 0; t < 3; ++t) {
+            result[r][t] = view[r][0] * rotation[0][t] + view[r][1] * rotation[1][t] + view[r][2] * rotation[2][t];
+        }
+    }
+    std::copy(&result[0][0], &result[0][0] + 9, &view[0][0]);
+}
+
+template<class FUNCTION>
+double milliseconds(FUNCTION f) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+int main(int argc, char** argv) {
+    std::size_t width = 1024;
+    std::size_t height = 768;
+    float view[3][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    andres::graphics::RasterizerOptions options;
+    options.minimumDepth_ = -1.0f; // clipping planes of the viewer
+    options.maximumDepth_ = 1.0f;
+    std::size_t numberOfThreads = 0;
+    unsigned char backgroundAlpha = 255;
+    int compressionLevel = 6;
+    std::vector<std::string> fileNames;
+    try {
+        for(int j = 1; j < argc; ++j) {
+            const std::string argument = argv[j];
+            if(argument == "--width" && j + 1 < argc) {
+                width = std::stoul(argv[++j]);
+            }
+            else if(argument == "--height" && j + 1 < argc) {
+                height = std::stoul(argv[++j]);
+            }
+            else if(argument == "--rotate" && j + 2 < argc) {
+                const std::string axis = argv[++j];
+                if(axis != "x" && axis != "y" && axis != "z") {
+                    usage();
+                    return 1;
+                }
+                rotate(view, axis[0] - 'x', std::stof(argv[++j]));
+            }
+            else if(argument == "--scale" && j + 1 < argc) {
+                const float scale = std::stof(argv[++j]);
+                for(std::size_t r = 0; r < 3; ++r) {
+                    for(std::size_t t = 0; t < 3; ++t) {
+                        view[r][t] *= scale;
+                    }
+                }
+            }
+            else if(argument == "--point-size" && j + 1 < argc) {
+                options.pointSize_ = std::stof(argv[++j]);
+            }
+            else if(argument == "--line-width" && j + 1 < argc) {
+                options.lineWidth_ = std::stof(argv[++j]);
+            }
+            else if(argument == "--tile-size" && j + 1 < argc) {
+                options.tileSize_ = std::stoul(argv[++j]);
+            }
+            else if(argument == "--threads" && j + 1 < argc) {
+                numberOfThreads = std::stoul(argv[++j]);
+            }
+            else if(argument == "--transparent") {
+                backgroundAlpha = 0;
+            }
+            else if(argument == "--compression" && j + 1 < argc) {
+                compressionLevel = std::stoi(argv[++j]);
+            }
+            else if(argument.compare(0, 2, "--") == 0) {
+                usage();
+                return 1;
+            }
+            else {
+                fileNames.push_back(argument);
+            }
+        }
+    }
+    catch(const std::exception&) { // stoul, stof
+        usage();
+        return 1;
+    }
+    if(fileNames.empty() || fileNames.size() % 2 != 0 || width == 0 || height == 0) {
+        usage();
+        return 1;
+    }
+    const andres::graphics::ParallelOptions parallelOptions(numberOfThreads);
+
+    // window coordinates as in the viewer: the view maps [-1, 1]^2 onto the
+    // window, the origin of which is at the top left corner
+    const float w = static_cast<float>(width) / 2;
+    const float h = static_cast<float>(height) / 2;
+    const float matrix[3][4] = {
+        {w * view[0][0], w * view[0][1], w * view[0][2], w},
+        {-h * view[1][0], -h * view[1][1], -h * view[1][2], h},
+        {view[2][0], view[2][1], view[2][2], 0.0f}
+    };
+    const Projection projection(matrix);
+
+    Graphics graphics;
+    andres::graphics::Framebuffer framebuffer(width, height);
+    double total = 0;
+    for(std::size_t j = 0; j < fileNames.size(); j += 2) {
+        const double tLoad = milliseconds([&]() {
+            if(andres::graphics::binary::isBinaryFile(fileNames[j])) {
+                andres::graphics::binary::load(fileNames[j], graphics, parallelOptions);
+            }
+            else {
+                hid_t file = andres::graphics::hdf5::openFile(fileNames[j]);
+                andres::graphics::hdf5::load(file, graphics, parallelOptions);
+                andres::graphics::hdf5::closeFile(file);
+            }
+            graphics.center(parallelOptions);
+            graphics.normalize(parallelOptions);
+        });
+        const double tRender = milliseconds([&]() {
+            framebuffer.clear(255, 255, 255, backgroundAlpha);
+            andres::graphics::rasterize(graphics, projection, framebuffer, options, parallelOptions);
+        });
+        std::size_t bytes = 0;
+        const double tSave = milliseconds([&]() {
+            std::ofstream file(fileNames[j + 1].c_str(), std::ios::binary);
+            if(!file) {
+                throw std::runtime_error("could not open " + fileNames[j + 1] + " for writing.");
+            }
+            if(endsWith(fileNames[j + 1], ".ppm")) {
+                bytes = andres::graphics::savePPM(framebuffer, file);
+            }
+            else {
+                bytes = andres::graphics::savePNG(framebuffer, file, compressionLevel);
+            }
+        });
+        total += tLoad + tRender + tSave;
+        std::cout << fileNames[j + 1] << ": " << bytes << " bytes, load "
+            << tLoad << " ms, render " << tRender << " ms, save " << tSave << " ms" << std::endl;
+    }
+    if(fileNames.size() > 2) {
+        std::cout << fileNames.size() / 2 << " images in " << total / 1000 << " s, "
+            << 1000 * (fileNames.size() / 2) / total << " images/s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/graphics-binary.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/svg.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::binary::MappedGraphics<> MappedGraphics;
+typedef Graphics::size_type size_type;
+
+template<class GRAPHICS>
+GRAPHICS randomGraphics(const std::size_t numberOfPoints) {
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> color(0, 255);
+    GRAPHICS graphics;
+    for(std::size_t j = 0; j < 3; ++j) {
+        graphics.definePointProperty(j != 1, color(randomEngine), color(randomEngine), color(randomEngine), color(randomEngine));
+        graphics.defineLineProperty(j != 2, color(randomEngine), color(randomEngine), color(randomEngine), color(randomEngine));
+        graphics.defineTriangleProperty(true, color(randomEngine), color(randomEngine), color(randomEngine), color(randomEngine));
+    }
+    for(std::size_t j = 0; j < numberOfPoints; ++j) {
+        graphics.definePoint(coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine), j % 4);
+    }
+    for(std::size_t j = 0; j + 2 < numberOfPoints; ++j) {
+        graphics.defineLine(j, j + 1, j % 4);
+        if(j % 2 == 0) {
+            graphics.defineTriangle(j, j + 1, j + 2, j % 4);
+        }
+    }
+    return graphics;
+}
+
+// compare the primitives and properties of two graphics, converting
+// coordinates and indices to the types of the first
+template<class GRAPHICS0, class GRAPHICS1>
+bool equal(const GRAPHICS0& g0, const GRAPHICS1& g1) {
+    typedef typename GRAPHICS0::value_type value_type;
+    typedef typename GRAPHICS0::size_type index_type;
+
+    if(g0.numberOfPoints() != g1.numberOfPoints()
+    || g0.numberOfLines() != g1.numberOfLines()
+    || g0.numberOfTriangles() != g1.numberOfTriangles()
+    || g0.numberOfPointProperties() != g1.numberOfPointProperties()
+    || g0.numberOfLineProperties() != g1.numberOfLineProperties()
+    || g0.numberOfTriangleProperties() != g1.numberOfTriangleProperties()) {
+        return false;
+    }
+    for(std::size_t j = 0; j < g0.numberOfPoints(); ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            if(g0.point(j)[k] != static_cast<value_type>(g1.point(j)[k])) {
+                return false;
+            }
+        }
+        if(g0.point(j).propertyIndex() != static_cast<index_type>(g1.point(j).propertyIndex())) {
+            return false;
+        }
+    }
+    for(std::size_t j = 0; j < g0.numberOfLines(); ++j) {
+        for(std::size_t k = 0; k < 2; ++k) {
+            if(g0.line(j).pointIndex(k) != static_cast<index_type>(g1.line(j).pointIndex(k))) {
+                return false;
+            }
+        }
+        if(g0.line(j).propertyIndex() != static_cast<index_type>(g1.line(j).propertyIndex())) {
+            return false;
+        }
+    }
+    for(std::size_t j = 0; j < g0.numberOfTriangles(); ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            if(g0.triangle(j).pointIndex(k) != static_cast<index_type>(g1.triangle(j).pointIndex(k))) {
+                return false;
+            }
+        }
+        if(g0.triangle(j).propertyIndex() != static_cast<index_type>(g1.triangle(j).propertyIndex())) {
+            return false;
+        }
+    }
+    for(std::size_t j = 0; j < g0.numberOfPointProperties(); ++j) {
+        const typename GRAPHICS0::PointPropertyType& p = g0.pointProperty(j);
+        const typename GRAPHICS1::PointPropertyType& q = g1.pointProperty(j);
+        if(p.visibility() != q.visibility() || p.color(0) != q.color(0) || p.color(1) != q.color(1)
+        || p.color(2) != q.color(2) || p.alpha() != q.alpha()) {
+            return false;
+        }
+    }
+    for(std::size_t j = 0; j < g0.numberOfLineProperties(); ++j) {
+        if(!(g0.lineProperty(j).visibility() == g1.lineProperty(j).visibility()
+        && g0.lineProperty(j).alpha() == g1.lineProperty(j).alpha())) {
+            return false;
+        }
+    }
+    for(std::size_t j = 0; j < g0.numberOfTriangleProperties(); ++j) {
+        if(!(g0.triangleProperty(j).color(1) == g1.triangleProperty(j).color(1)
+        && g0.triangleProperty(j).alpha() == g1.triangleProperty(j).alpha())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string readFile(const std::string& fileName) {
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+void writeFile(const std::string& fileName, const std::string& data) {
+    std::ofstream file(fileName.c_str(), std::ios::binary);
+    file.write(data.data(), data.size());
+}
+
+template<class FUNCTION>
+bool throwsRuntimeError(FUNCTION f) {
+    try {
+        f();
+    }
+    catch(const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    const Graphics graphics = randomGraphics<Graphics>(1000);
+
+    // save, map and load
+    {
+        const std::size_t bytes = andres::graphics::binary::save("graphics.agb", graphics);
+        test(bytes == readFile("graphics.agb").size());
+        test(andres::graphics::binary::isBinaryFile("graphics.agb"));
+
+        MappedGraphics mapped("graphics.agb");
+        test(equal(graphics, mapped));
+        test(mapped.points()[17] == graphics.point(17));
+        test(reinterpret_cast<std::uintptr_t>(mapped.points().data()) % 64 == 0);
+
+        Graphics loaded;
+        andres::graphics::binary::load("graphics.agb", loaded);
+        test(loaded.points() == graphics.points());
+        test(loaded.lines() == graphics.lines());
+        test(loaded.triangles() == graphics.triangles());
+        test(loaded.pointProperties() == graphics.pointProperties());
+        test(loaded.lineProperties() == graphics.lineProperties());
+        test(loaded.triangleProperties() == graphics.triangleProperties());
+
+        // moved views remain valid, closed views are empty
+        MappedGraphics moved(std::move(mapped));
+        test(equal(graphics, moved));
+        moved.close();
+        test(moved.numberOfPoints() == 0 && moved.numberOfPointProperties() == 0);
+    }
+
+    // files are converted to other types by load() but not mapped
+    {
+        andres::graphics::Graphics<double, unsigned int> converted;
+        andres::graphics::binary::load("graphics.agb", converted, andres::graphics::ParallelOptions(3));
+        test(equal(converted, graphics));
+        test(throwsRuntimeError([]() { andres::graphics::binary::MappedGraphics<double, unsigned int> mapped("graphics.agb"); }));
+
+        andres::graphics::binary::save("graphics-converted.agb", converted);
+        test(readFile("graphics-converted.agb").size() < readFile("graphics.agb").size());
+        Graphics loaded;
+        andres::graphics::binary::load("graphics-converted.agb", loaded);
+        test(equal(graphics, loaded));
+        test(throwsRuntimeError([]() { MappedGraphics mapped("graphics-converted.agb"); }));
+    }
+
+    // writing in batches produces the same file as save()
+    {
+        andres::graphics::binary::Writer<> writer("graphics-batches.agb");
+        writer.pointProperties(graphics.pointProperties());
+        for(std::size_t offset = 0; offset < graphics.numberOfPoints(); offset += 300) {
+            const Graphics::PointsVector batch(graphics.points().begin() + offset,
+                graphics.points().begin() + std::min<std::size_t>(offset + 300, graphics.numberOfPoints()));
+            writer.points(batch, offset);
+        }
+        // line properties omitted
+        writer.lines(graphics.lines());
+        writer.triangleProperties(graphics.triangleProperties());
+        writer.triangles(graphics.triangles());
+        test(throwsRuntimeError([&]() { writer.lines(graphics.lines()); }));
+        test(throwsRuntimeError([&]() { writer.triangles(graphics.triangles(), 0); }));
+        writer.close();
+        test(throwsRuntimeError([&]() { writer.triangles(graphics.triangles(), graphics.numberOfTriangles()); }));
+
+        MappedGraphics mapped("graphics-batches.agb");
+        test(mapped.numberOfLineProperties() == 0);
+        test(mapped.points().size() == graphics.numberOfPoints());
+        test(std::equal(mapped.points().begin(), mapped.points().end(), graphics.points().begin()));
+        test(std::equal(mapped.triangles().begin(), mapped.triangles().end(), graphics.triangles().begin()));
+    }
+
+    // empty graphics
+    {
+        const Graphics empty;
+        andres::graphics::binary::save("graphics-empty.agb", empty);
+        MappedGraphics mapped("graphics-empty.agb");
+        test(equal(empty, mapped));
+        Graphics loaded = graphics;
+        andres::graphics::binary::load("graphics-empty.agb", loaded);
+        test(equal(empty, loaded));
+    }
+
+    // invalid files
+    {
+        const std::string data = readFile("graphics.agb");
+        std::vector<std::string> invalid;
+        invalid.push_back(data.substr(0, data.size() - 1)); // truncated
+        invalid.push_back(data.substr(0, 100)); // truncated header
+        invalid.push_back("PNG" + data.substr(3)); // magic number
+        invalid.push_back(data.substr(0, 8) + "\x02" + data.substr(9)); // version
+        invalid.push_back(data.substr(0, 17) + "\x03" + data.substr(18)); // index size
+        invalid.push_back(data.substr(0, 24) + "\x01" + data.substr(25)); // section offset
+        for(std::size_t j = 0; j < invalid.size(); ++j) {
+            writeFile("graphics-invalid.agb", invalid[j]);
+            test(throwsRuntimeError([]() { MappedGraphics mapped("graphics-invalid.agb"); }));
+            test(throwsRuntimeError([]() { Graphics g; andres::graphics::binary::load("graphics-invalid.agb", g); }));
+        }
+        test(!andres::graphics::binary::isBinaryFile("graphics-missing.agb"));
+        test(throwsRuntimeError([]() { MappedGraphics mapped("graphics-missing.agb"); }));
+        writeFile("graphics-invalid.agb", "");
+        test(throwsRuntimeError([]() { MappedGraphics mapped("graphics-invalid.agb"); }));
+    }
+
+    // SVG export from the mapped file
+    {
+        typedef andres::graphics::OrthogonalProjection<> Projection;
+        MappedGraphics mapped("graphics.agb");
+        std::ostringstream expected;
+        andres::graphics::saveSVG(graphics, Projection(), expected);
+        std::ostringstream svg;
+        andres::graphics::saveSVG(mapped, Projection(), svg);
+        test(svg.str() == expected.str());
+    }
+
+    std::remove("graphics.agb");
+    std::remove("graphics-converted.agb");
+    std::remove("graphics-batches.agb");
+    std::remove("graphics-empty.agb");
+    std::remove("graphics-invalid.agb");
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdexcept>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef Graphics::size_type size_type;
+
+template<class FUNCTION>
+bool throwsOutOfRange(FUNCTION f, const std::string& message = "") {
+    try {
+        f();
+    }
+    catch(const std::out_of_range& e) {
+        return message.empty() || std::string(e.what()) == message;
+    }
+    return false;
+}
+
+bool equal(const Graphics& g0, const Graphics& g1) {
+    return g0.points() == g1.points()
+        && g0.lines() == g1.lines()
+        && g0.triangles() == g1.triangles()
+        && g0.pointProperties() == g1.pointProperties()
+        && g0.lineProperties() == g1.lineProperties()
+        && g0.triangleProperties() == g1.triangleProperties();
+}
+
+int main() {
+    // bulk definitions are equivalent to definitions one by one
+    Graphics expected;
+    expected.definePointProperty(true, 255, 0, 0);
+    expected.defineLineProperty(true, 0, 255, 0);
+    expected.defineTriangleProperty(true, 0, 0, 255);
+    for(size_type j = 0; j < 10; ++j) {
+        expected.definePoint(j, 2.0f * j, 3.0f * j, 1);
+    }
+    for(size_type j = 0; j + 1 < 10; ++j) {
+        expected.defineLine(j, j + 1, 1);
+    }
+    for(size_type j = 0; j + 2 < 10; ++j) {
+        expected.defineTriangle(j, j + 1, j + 2);
+    }
+
+    std::vector<float> coordinates;
+    std::vector<std::uint32_t> lineIndices;
+    std::vector<std::uint16_t> triangleIndices;
+    for(std::size_t j = 0; j < 10; ++j) {
+        coordinates.push_back(j);
+        coordinates.push_back(2.0f * j);
+        coordinates.push_back(3.0f * j);
+        if(j + 1 < 10) {
+            lineIndices.push_back(j);
+            lineIndices.push_back(j + 1);
+        }
+        if(j + 2 < 10) {
+            triangleIndices.push_back(j);
+            triangleIndices.push_back(j + 1);
+            triangleIndices.push_back(j + 2);
+        }
+    }
+
+    // arrays, in two batches each
+    {
+        Graphics graphics;
+        graphics.definePointProperty(true, 255, 0, 0);
+        graphics.defineLineProperty(true, 0, 255, 0);
+        graphics.defineTriangleProperty(true, 0, 0, 255);
+        graphics.reserve(10, 9, 8);
+        test(graphics.points().capacity() >= 10);
+        test(graphics.lines().capacity() >= 9);
+        test(graphics.triangles().capacity() >= 8);
+        test(graphics.definePoints(&coordinates[0], 4, 1) == 0);
+        test(graphics.definePoints(&coordinates[12], 6, 1) == 4);
+        test(graphics.defineLines(&lineIndices[0], 5, 1) == 0);
+        test(graphics.defineLines(&lineIndices[10], 4, 1) == 5);
+        test(graphics.defineTriangles(&triangleIndices[0], 8) == 0);
+        test(graphics.defineTriangles(&triangleIndices[0], 0) == 8);
+        test(equal(graphics, expected));
+    }
+
+    // vectors, copied and moved
+    {
+        Graphics graphics;
+        graphics.definePointProperty(true, 255, 0, 0);
+        graphics.defineLineProperty(true, 0, 255, 0);
+        graphics.defineTriangleProperty(true, 0, 0, 255);
+
+        Graphics::PointsVector points = expected.points();
+        const Graphics::PointType* data = points.data();
+        test(graphics.definePoints(std::move(points)) == 0);
+        test(graphics.points().data() == data); // not copied
+        test(points.empty());
+
+        Graphics::LinesVector lines(expected.lines().begin(), expected.lines().begin() + 3);
+        test(graphics.defineLines(lines) == 0);
+        test(lines.size() == 3);
+        lines.assign(expected.lines().begin() + 3, expected.lines().end());
+        test(graphics.defineLines(std::move(lines)) == 3); // appended
+        test(lines.empty());
+
+        test(graphics.defineTriangles(expected.triangles()) == 0);
+        test(equal(graphics, expected));
+    }
+
+    // invalid indices are detected before anything is defined
+    {
+        Graphics graphics = expected;
+        test(throwsOutOfRange([&]() { graphics.definePoints(&coordinates[0], 10, 2); }));
+
+        std::vector<std::uint32_t> indices(lineIndices);
+        indices[7] = 10;
+        test(throwsOutOfRange([&]() { graphics.defineLines(&indices[0], 9); }, "point index 1 of line 3 out of range"));
+        test(throwsOutOfRange([&]() { graphics.defineLines(&lineIndices[0], 9, 2); }));
+
+        std::vector<std::uint64_t> largeIndices(triangleIndices.begin(), triangleIndices.end());
+        largeIndices[12] = std::uint64_t(1) << 40;
+        test(throwsOutOfRange([&]() { graphics.defineTriangles(&largeIndices[0], 8); }, "point index 0 of triangle 4 out of range"));
+        test(throwsOutOfRange([&]() { graphics.defineTriangles(&triangleIndices[0], 8, 2); }));
+
+        Graphics::PointsVector points = expected.points();
+        points[5].propertyIndex() = 2;
+        test(throwsOutOfRange([&]() { graphics.definePoints(points); }, "point property index of point 5 out of range"));
+        test(throwsOutOfRange([&]() { graphics.definePoints(std::move(points)); }));
+        test(points.size() == 10); // not taken
+
+        Graphics::LinesVector lines = expected.lines();
+        lines[8].pointIndex(0) = 10;
+        test(throwsOutOfRange([&]() { graphics.defineLines(lines); }, "point or property index of line 8 out of range"));
+        lines[8] = expected.line(8);
+        lines[2].propertyIndex() = 2;
+        test(throwsOutOfRange([&]() { graphics.defineLines(std::move(lines)); }, "point or property index of line 2 out of range"));
+
+        Graphics::TrianglesVector triangles = expected.triangles();
+        triangles[0].pointIndex(2) = 100;
+        test(throwsOutOfRange([&]() { graphics.defineTriangles(triangles); }, "point or property index of triangle 0 out of range"));
+
+        test(equal(graphics, expected));
+    }
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "andres/graphics/cleanup.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::CleanupOptions CleanupOptions;
+typedef andres::graphics::CleanupResult<> CleanupResult;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+// the same primitive with the points of its corners
+bool samePosition(const Graphics& g0, const size_type j0, const Graphics& g1, const size_type j1) {
+    for(std::size_t k = 0; k < 3; ++k) {
+        if(g0.point(j0)[k] != g1.point(j1)[k]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// grid of n x n cells with two triangles per cell, as emitted by a
+// producer that defines the corners of each triangle separately
+Graphics triangleSoup(const std::size_t n) {
+    Graphics graphics;
+    for(std::size_t x = 0; x < n; ++x) {
+        for(std::size_t y = 0; y < n; ++y) {
+            const size_type p = graphics.definePoint(x, y, 0);
+            graphics.definePoint(x + 1, y, 0);
+            graphics.definePoint(x, y + 1, 0);
+            graphics.defineTriangle(p, p + 1, p + 2);
+            const size_type q = graphics.definePoint(x + 1, y, 0);
+            graphics.definePoint(x + 1, y + 1, 0);
+            graphics.definePoint(x, y + 1, 0);
+            graphics.defineTriangle(q, q + 1, q + 2);
+        }
+    }
+    return graphics;
+}
+
+int main() {
+    // exact welding, degenerate and duplicate primitives, unused points
+    // and properties
+    {
+        Graphics graphics;
+        graphics.definePointProperty(true, 255, 0, 0); // 1, unused
+        graphics.definePointProperty(false, 0, 0, 0); // 2, invisible
+        graphics.defineLineProperty(true, 0, 255, 0); // 1
+        graphics.defineTriangleProperty(true, 0, 0, 255); // 1, unused
+        graphics.definePoint(0, 0, 0); // 0
+        graphics.definePoint(1, 0, 0); // 1
+        graphics.definePoint(0, 0, 0); // 2, welded to 0
+        graphics.definePoint(-0.0f, 0, 0); // 3, welded to 0
+        graphics.definePoint(0, 0, 0, 2); // 4, different property, unused and invisible
+        graphics.definePoint(5, 5, 5); // 5, isolated but visible
+        graphics.definePoint(0, 1, 0); // 6
+        graphics.defineLine(0, 1, 1); // 0
+        graphics.defineLine(1, 2, 1); // 1, duplicate of 0 after welding
+        graphics.defineLine(2, 3); // 2, degenerate after welding
+        graphics.defineLine(1, 0); // 3, different property
+        graphics.defineTriangle(0, 1, 6); // 0
+        graphics.defineTriangle(6, 3, 1); // 1, duplicate of 0 after welding
+        graphics.defineTriangle(0, 2, 6); // 2, degenerate after welding
+
+        const Graphics original = graphics;
+        const CleanupResult result = andres::graphics::cleanup(graphics);
+        test(graphics.numberOfPoints() == 4);
+        test(graphics.numberOfLines() == 2);
+        test(graphics.numberOfTriangles() == 1);
+        test(graphics.numberOfPointProperties() == 1);
+        test(graphics.numberOfLineProperties() == 2);
+        test(graphics.numberOfTriangleProperties() == 1);
+
+        const size_type removed = CleanupResult::removed();
+        test(result.pointMap_ == std::vector<size_type>({0, 1, 0, 0, removed, 2, 3}));
+        test(result.lineMap_ == std::vector<size_type>({0, removed, removed, 1}));
+        test(result.triangleMap_ == std::vector<size_type>({0, removed, removed}));
+        test(result.pointPropertyMap_ == std::vector<size_type>({0, removed, removed}));
+        test(result.linePropertyMap_ == std::vector<size_type>({0, 1}));
+        test(result.trianglePropertyMap_ == std::vector<size_type>({0, removed}));
+        test(graphics.line(0) == Graphics::LineType(0, 1, 1));
+        test(graphics.line(1) == Graphics::LineType(1, 0, 0));
+        test(graphics.triangle(0) == Graphics::TriangleType(0, 1, 3));
+        for(size_type j = 0; j < original.numberOfPoints(); ++j) {
+            if(result.pointMap_[j] != removed) {
+                test(samePosition(original, j, graphics, result.pointMap_[j]));
+            }
+        }
+
+        test(result.points_.before_ == 7 && result.points_.after_ == 4);
+        test(result.points_.welded_ == 2 && result.points_.unused_ == 1);
+        test(result.lines_.degenerate_ == 1 && result.lines_.duplicate_ == 1);
+        test(result.triangles_.degenerate_ == 1 && result.triangles_.duplicate_ == 1);
+        test(result.pointProperties_.unused_ == 2);
+        test(result.triangleProperties_.unused_ == 1);
+        test(result.bytesBefore_ > result.bytesAfter_);
+        test(result.bytesSaved() == 3 * sizeof(Graphics::PointType) + 2 * sizeof(Graphics::LineType)
+            + 2 * sizeof(Graphics::TriangleType) + 2 * sizeof(Graphics::PointPropertyType)
+            + sizeof(Graphics::TrianglePropertyType));
+
+        // a second pass changes nothing
+        const Graphics cleaned = graphics;
+        const CleanupResult second = andres::graphics::cleanup(graphics);
+        test(second.bytesSaved() == 0);
+        test(graphics.points() == cleaned.points() && graphics.lines() == cleaned.lines()
+            && graphics.triangles() == cleaned.triangles());
+    }
+
+    // options
+    {
+        Graphics graphics;
+        graphics.definePoint(0, 0, 0);
+        graphics.definePoint(0, 0, 0);
+        graphics.definePoint(1, 1, 1); // isolated
+        graphics.defineLine(0, 1);
+        graphics.defineLine(0, 1);
+
+        Graphics g = graphics;
+        CleanupResult result = andres::graphics::cleanup(g, CleanupOptions(false));
+        test(g.numberOfPoints() == 3 && g.numberOfLines() == 1); // duplicate, not degenerate
+
+        g = graphics;
+        result = andres::graphics::cleanup(g, CleanupOptions(true, 0, false, false));
+        test(g.numberOfPoints() == 2 && g.numberOfLines() == 2);
+        test(g.line(0).pointIndex(0) == 0 && g.line(0).pointIndex(1) == 0);
+
+        g = graphics;
+        result = andres::graphics::cleanup(g, CleanupOptions(true, 0, true, true, true));
+        test(g.numberOfPoints() == 0 && g.numberOfLines() == 0);
+        test(result.points_.welded_ == 1 && result.points_.unused_ == 2);
+    }
+
+    // welding within a distance is transitive and respects properties
+    {
+        Graphics graphics;
+        graphics.definePointProperty(true, 1, 2, 3);
+        graphics.definePoint(0, 0, 0); // 0
+        graphics.definePoint(0.09f, 0, 0); // 1
+        graphics.definePoint(0.18f, 0, 0); // 2, welded to 0 via 1
+        graphics.definePoint(0.5f, 0, 0); // 3
+        graphics.definePoint(0.55f, 0, 0, 1); // 4, different property
+        graphics.definePoint(0, 0.05f, 0.05f); // 5
+        graphics.definePoint(0, 0.1f, 0.1f); // 6, 0.1 * sqrt(2) from 0
+        graphics.definePoint(std::numeric_limits<float>::infinity(), 0, 0); // 7
+        graphics.definePoint(std::numeric_limits<float>::infinity(), 0, 0); // 8
+        graphics.definePoint(std::nanf(""), 0, 0); // 9, never welded
+        graphics.definePoint(std::nanf(""), 0, 0); // 10
+
+        for(std::size_t threads = 1; threads <= 3; ++threads) {
+            Graphics g = graphics;
+            const CleanupResult result = andres::graphics::cleanup(g, CleanupOptions(true, 0.1), ParallelOptions(threads));
+            test(result.pointMap_ == std::vector<size_type>({0, 0, 0, 1, 2, 0, 0, 3, 3, 4, 5}));
+            test(result.points_.welded_ == 5);
+        }
+
+        Graphics g = graphics;
+        andres::graphics::cleanup(g, CleanupOptions(true, 0.075));
+        test(g.numberOfPoints() == 8); // 5 and 6 welded to 0, but not 1 and 2
+    }
+
+    // a triangle soup becomes an indexed mesh, in parallel
+    {
+        const std::size_t n = 150; // 135000 points, enough for two blocks
+        const Graphics soup = triangleSoup(n);
+        Graphics expected = soup;
+        andres::graphics::cleanup(expected, CleanupOptions(), ParallelOptions(1));
+        test(expected.numberOfPoints() == (n + 1) * (n + 1));
+        test(expected.numberOfTriangles() == 2 * n * n);
+
+        Graphics graphics = soup;
+        const CleanupResult result = andres::graphics::cleanup(graphics, CleanupOptions(), ParallelOptions(4));
+        test(graphics.points() == expected.points());
+        test(graphics.triangles() == expected.triangles());
+        test(result.points_.welded_ == soup.numberOfPoints() - graphics.numberOfPoints());
+        for(size_type j = 0; j < soup.numberOfPoints(); ++j) {
+            test(samePosition(soup, j, graphics, result.pointMap_[j]));
+        }
+    }
+
+    // reordered points are numbered by their first use
+    {
+        const Graphics soup = triangleSoup(10);
+        Graphics graphics = soup;
+        const CleanupResult result = andres::graphics::cleanup(graphics, CleanupOptions(true, 0, true, true, false, true, true));
+        size_type next = 0;
+        for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+            for(size_type k = 0; k < 3; ++k) {
+                test(graphics.triangle(j).pointIndex(k) <= next);
+                if(graphics.triangle(j).pointIndex(k) == next) {
+                    ++next;
+                }
+            }
+        }
+        test(next == graphics.numberOfPoints());
+        for(size_type j = 0; j < soup.numberOfPoints(); ++j) {
+            test(samePosition(soup, j, graphics, result.pointMap_[j]));
+        }
+        for(size_type j = 0; j < soup.numberOfTriangles(); ++j) {
+            for(size_type k = 0; k < 3; ++k) {
+                test(graphics.triangle(result.triangleMap_[j]).pointIndex(k)
+                    == result.pointMap_[soup.triangle(j).pointIndex(k)]);
+            }
+        }
+    }
+
+    // empty graphics
+    {
+        Graphics graphics;
+        const CleanupResult result = andres::graphics::cleanup(graphics, CleanupOptions(true, 1));
+        test(result.bytesSaved() == 0);
+        test(graphics.numberOfPointProperties() == 1);
+    }
+
+    return 0;
+}
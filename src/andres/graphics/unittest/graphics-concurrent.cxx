@@ -0,0 +1,248 @@
+#include <stdexcept>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "andres/graphics/concurrent.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ConcurrentGraphics<> ConcurrentGraphics;
+typedef andres::graphics::IndexRanges<> IndexRanges;
+typedef ConcurrentGraphics::ChangesType Changes;
+typedef Graphics::size_type size_type;
+
+bool equal(const Graphics& g0, const Graphics& g1) {
+    return g0.points() == g1.points()
+        && g0.lines() == g1.lines()
+        && g0.triangles() == g1.triangles()
+        && g0.pointProperties() == g1.pointProperties()
+        && g0.lineProperties() == g1.lineProperties()
+        && g0.triangleProperties() == g1.triangleProperties();
+}
+
+bool equal(const IndexRanges& ranges, const std::vector<size_type>& bounds) {
+    if(2 * ranges.size() != bounds.size()) {
+        return false;
+    }
+    for(std::size_t j = 0; j < ranges.size(); ++j) {
+        if(ranges[j].begin_ != bounds[2 * j] || ranges[j].end_ != bounds[2 * j + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // index ranges are sorted, disjoint and coalesced
+    {
+        IndexRanges ranges;
+        test(ranges.empty());
+        ranges.insert(5);
+        ranges.insert(6);
+        ranges.insert(10, 12);
+        ranges.insert(2, 3);
+        test(equal(ranges, {2, 3, 5, 7, 10, 12}));
+        ranges.insert(3); // adjacent on both sides
+        test(equal(ranges, {2, 4, 5, 7, 10, 12}));
+        ranges.insert(4, 11);
+        test(equal(ranges, {2, 12}));
+        ranges.insert(7, 7); // empty
+        test(equal(ranges, {2, 12}));
+        test(ranges.contains(2) && ranges.contains(11) && !ranges.contains(1) && !ranges.contains(12));
+        test(ranges.numberOfIndices() == 10);
+    }
+
+    // the number of ranges is bounded by merging the closest ranges
+    {
+        IndexRanges ranges(3);
+        ranges.insert(0);
+        ranges.insert(10);
+        ranges.insert(20);
+        ranges.insert(22);
+        test(equal(ranges, {0, 1, 10, 11, 20, 23}));
+        ranges.insert(50);
+        test(equal(ranges, {0, 11, 20, 23, 50, 51}) || equal(ranges, {0, 1, 10, 23, 50, 51}));
+        test(ranges.contains(22) && ranges.contains(50));
+    }
+
+    // published versions and their changes
+    {
+        ConcurrentGraphics graphics;
+        ConcurrentGraphics::Snapshot s0 = graphics.snapshot();
+        test(s0->version() == 0);
+        test(s0->graphics().numberOfPoints() == 0);
+
+        test(graphics.definePointProperty(true, 255, 0, 0) == 1);
+        for(std::size_t j = 0; j < 10; ++j) {
+            graphics.definePoint(j, 0, 0, j % 2);
+        }
+        graphics.defineLine(0, 1);
+        graphics.defineTriangle(0, 1, 2);
+        test(graphics.snapshot()->graphics().numberOfPoints() == 0); // not published
+        test(graphics.publish() == 1);
+
+        ConcurrentGraphics::Snapshot s1 = graphics.snapshot();
+        test(s1->version() == 1);
+        test(s1->graphics().numberOfPoints() == 10);
+        test(s0->graphics().numberOfPoints() == 0); // unchanged
+        Changes changes;
+        test(s1->changes(0, changes));
+        test(equal(changes.points_, {0, 10}));
+        test(equal(changes.pointProperties_, {1, 2}));
+        test(equal(changes.lines_, {0, 1}));
+        test(equal(changes.triangles_, {0, 1}));
+        test(changes.lineProperties_.empty());
+        test(s1->changes(1, changes) && changes.empty());
+        test(!s1->changes(2, changes));
+
+        graphics.setPoint(3, 1, 1, 1);
+        graphics.setPointProperty(0, false, 0, 0, 0);
+        const std::uint32_t indices[4] = {4, 5, 6, 7};
+        test(graphics.defineLines(indices, 2) == 1);
+        test(graphics.publish() == 2);
+        graphics.setLine(0, 8, 9);
+        graphics.definePoint(0, 1, 2);
+        test(graphics.publish() == 3);
+
+        ConcurrentGraphics::Snapshot s3 = graphics.snapshot();
+        test(s3->changes(1, changes));
+        test(equal(changes.points_, {3, 4, 10, 11}));
+        test(equal(changes.pointProperties_, {0, 1}));
+        test(equal(changes.lines_, {0, 3}));
+        test(changes.triangles_.empty());
+        test(s3->graphics().point(3)[0] == 1);
+        test(s1->graphics().point(3)[0] == 3); // unchanged
+
+        // invalid modifications throw and change nothing
+        bool thrown = false;
+        try {
+            graphics.setLine(0, 0, 11);
+        }
+        catch(const std::out_of_range&) {
+            thrown = true;
+        }
+        test(thrown);
+        test(graphics.pendingChanges().empty());
+    }
+
+    // the back buffer is updated from the changed ranges when no reader
+    // holds the released version, and copied otherwise
+    {
+        ConcurrentGraphics graphics(0);
+        for(std::size_t j = 0; j < 100; ++j) {
+            graphics.definePoint(j, j, j);
+        }
+        graphics.publish();
+        const std::size_t copies = graphics.numberOfCopies();
+        for(std::size_t k = 0; k < 5; ++k) {
+            graphics.setPoint(k, -1, -1, -1);
+            graphics.defineLine(k, k + 1);
+            graphics.publish();
+            test(equal(graphics.graphics(), graphics.snapshot()->graphics()));
+        }
+        test(graphics.numberOfCopies() == copies); // no reader held a version
+
+        ConcurrentGraphics::Snapshot held = graphics.snapshot();
+        graphics.setPoint(50, -1, -1, -1);
+        graphics.publish();
+        test(graphics.numberOfCopies() == copies + 1);
+        test(equal(graphics.graphics(), graphics.snapshot()->graphics()));
+        test(held->graphics().point(50)[0] == 50);
+    }
+
+    // released versions are reused after several versions
+    {
+        ConcurrentGraphics graphics(2);
+        graphics.definePointProperty(true, 1, 2, 3);
+        graphics.definePoint(0, 0, 0);
+        graphics.publish();
+        ConcurrentGraphics::Snapshot held = graphics.snapshot();
+        for(std::size_t k = 1; k < 4; ++k) {
+            graphics.definePoint(k, k, k, 1);
+            graphics.setPointProperty(1, true, k, k, k);
+            graphics.publish();
+            if(k == 2) {
+                held.reset();
+            }
+        }
+        test(equal(graphics.graphics(), graphics.snapshot()->graphics()));
+        test(graphics.graphics().pointProperty(1).color(0) == 3);
+    }
+
+    // versions older than the history are reported
+    {
+        ConcurrentGraphics graphics;
+        for(std::size_t k = 0; k < ConcurrentGraphics::historySize + 1; ++k) {
+            graphics.definePoint(k, k, k);
+            graphics.publish();
+        }
+        Changes changes;
+        ConcurrentGraphics::Snapshot snapshot = graphics.snapshot();
+        test(!snapshot->changes(0, changes));
+        test(snapshot->changes(1, changes));
+        test(equal(changes.points_, {1, ConcurrentGraphics::historySize + 1}));
+    }
+
+    // readers see consistent versions while the writer modifies
+    {
+        ConcurrentGraphics graphics(1);
+        const std::size_t numberOfVersions = 200;
+        std::atomic<bool> done(false);
+        std::atomic<bool> consistent(true);
+        std::vector<std::thread> readers;
+        for(std::size_t r = 0; r < 2; ++r) {
+            readers.push_back(std::thread([&]() {
+                Graphics mirror;
+                std::size_t version = 0;
+                Changes changes;
+                while(!done) {
+                    ConcurrentGraphics::Snapshot snapshot = graphics.snapshot();
+                    const Graphics& g = snapshot->graphics();
+                    // in version v, there are v points whose coordinates all equal v
+                    for(size_type j = 0; j < g.numberOfPoints(); ++j) {
+                        if(g.numberOfPoints() != snapshot->version() || g.point(j)[0] != snapshot->version()) {
+                            consistent = false;
+                        }
+                    }
+                    if(!snapshot->changes(version, changes)) {
+                        changes.clear();
+                        changes.points_.insert(0, g.numberOfPoints());
+                    }
+                    for(std::size_t k = 0; k < changes.points_.size(); ++k) {
+                        for(size_type j = changes.points_[k].begin_; j < changes.points_[k].end_; ++j) {
+                            if(j < mirror.numberOfPoints()) {
+                                mirror.setPoint(j, g.point(j)[0], g.point(j)[1], g.point(j)[2]);
+                            }
+                            else {
+                                mirror.definePoint(g.point(j)[0], g.point(j)[1], g.point(j)[2]);
+                            }
+                        }
+                    }
+                    version = snapshot->version();
+                    if(mirror.points() != g.points()) {
+                        consistent = false;
+                    }
+                }
+            }));
+        }
+        for(std::size_t v = 1; v <= numberOfVersions; ++v) {
+            for(size_type j = 0; j + 1 < v; ++j) {
+                graphics.setPoint(j, v, v, v);
+            }
+            graphics.definePoint(v, v, v);
+            graphics.publish();
+        }
+        done = true;
+        for(std::size_t r = 0; r < readers.size(); ++r) {
+            readers[r].join();
+        }
+        test(consistent);
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <stdexcept>
+#include <sstream>
+#include <string>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/culling.hxx"
+#include "andres/graphics/svg.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ScreenSpaceCulling<> ScreenSpaceCulling;
+typedef Graphics::size_type size_type;
+
+// projection onto the canvas [0, 100] x [0, 100]
+struct Projection {
+    typedef float value_type;
+    typedef std::size_t size_type;
+
+    void operator()(const float x, const float y, const float, float& r, float& s) const
+        { r = 100 * x; s = 100 * y; }
+};
+
+std::size_t count(const std::string& text, const std::string& pattern) {
+    std::size_t n = 0;
+    for(std::size_t j = text.find(pattern); j != std::string::npos; j = text.find(pattern, j + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+int main() {
+    Graphics graphics;
+    const size_type propertyRed = graphics.definePointProperty(true, 255, 0, 0);
+    const size_type propertyHidden = graphics.definePointProperty(false, 0, 0, 0);
+    graphics.definePoint(0.5f, 0.5f, 0); // 0
+    graphics.definePoint(0.501f, 0.502f, 1); // 1, same pixel as 0
+    graphics.definePoint(0.502f, 0.501f, 0, propertyRed); // 2, same pixel as 0, other property
+    graphics.definePoint(0.2f, 0.2f, 0); // 3
+    graphics.definePoint(1.5f, 0.5f, 0); // 4, off canvas
+    graphics.definePoint(-0.5f, 0.5f, 0); // 5, off canvas
+    graphics.definePoint(0.7f, 0.7f, 0, propertyHidden); // 6, invisible
+
+    graphics.defineLine(0, 3);
+    graphics.defineLine(3, 1); // same pixels as line 0, longer than a pixel
+    graphics.defineLine(0, 1); // shorter than a pixel
+    graphics.defineLine(1, 0); // shorter than a pixel, same pixel as line 2
+    graphics.defineLine(4, 5); // crosses the canvas
+    graphics.defineLine(4, 4); // off canvas
+
+    graphics.defineTriangle(0, 3, 4);
+    graphics.defineTriangle(1, 4, 3); // same pixels as triangle 0, larger than a pixel
+    graphics.defineTriangle(0, 1, 2); // smaller than a pixel
+    graphics.defineTriangle(4, 4, 4); // off canvas
+    graphics.defineTriangle(2, 1, 0); // smaller than a pixel, same pixel as triangle 2
+
+    // culling and merging
+    {
+        ScreenSpaceCulling culling(0, 0, 100, 100, 1);
+        culling(graphics, Projection());
+        test(culling.pointIndices() == std::vector<size_type>({0, 2, 3}));
+        test(culling.points().kept_ == 3);
+        test(culling.points().offCanvas_ == 2);
+        test(culling.points().merged_ == 1);
+        test(culling.points().invisible_ == 1);
+        test(culling.points().kept_ + culling.points().dropped() == graphics.numberOfPoints());
+        test(culling.lineIndices() == std::vector<size_type>({0, 1, 2, 4}));
+        test(culling.lines().offCanvas_ == 1);
+        test(culling.lines().merged_ == 1);
+        test(culling.lines().dropped() == 2);
+        test(culling.triangleIndices() == std::vector<size_type>({0, 1, 2}));
+        test(culling.triangles().offCanvas_ == 1);
+        test(culling.triangles().merged_ == 1);
+        test(culling.triangles().kept_ + culling.triangles().dropped() == graphics.numberOfTriangles());
+        std::ostringstream out;
+        out << culling.points();
+        test(out.str() == "3 kept, 1 invisible, 2 off canvas, 1 merged");
+
+        float x = 0;
+        float y = 0;
+        culling.project(3, x, y);
+        test(x == 20.0f && y == 20.0f);
+    }
+
+    // tolerance 0: culling only
+    {
+        ScreenSpaceCulling culling(0, 0, 100, 100, 0);
+        culling(graphics, Projection(), andres::graphics::ParallelOptions(2));
+        test(culling.pointIndices() == std::vector<size_type>({0, 1, 2, 3}));
+        test(culling.lines().kept_ == 5);
+        test(culling.triangles().kept_ == 4);
+    }
+
+    // large tolerance: all visible points with equal property merged
+    {
+        ScreenSpaceCulling culling(0, 0, 100, 100, 1000);
+        culling(graphics, Projection());
+        test(culling.pointIndices() == std::vector<size_type>({0, 2}));
+    }
+
+    // infinite canvas: nothing off canvas
+    {
+        ScreenSpaceCulling culling;
+        culling(graphics, Projection());
+        test(culling.points().offCanvas_ == 0);
+        test(culling.pointIndices().size() == 5);
+    }
+
+    // SVG of the kept primitives
+    {
+        ScreenSpaceCulling culling(0, 0, 100, 100, 1);
+        culling(graphics, Projection());
+        std::stringstream stream;
+        const std::size_t bytes = andres::graphics::saveSVG(graphics, culling, stream);
+        const std::string svg = stream.str();
+        test(bytes == svg.size());
+        test(svg.find("width=\"100\" height=\"100\" viewBox=\"0 0 100 100\"") != std::string::npos);
+        test(count(svg, "<circle ") == 3);
+        test(count(svg, "<line ") == 4);
+        test(count(svg, "<polygon ") == 3);
+        test(svg.find("<circle class=\"p0\" cx=\"20\" cy=\"20\" r=\"1pt\"/>") != std::string::npos);
+    }
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <stdexcept>
+#include <cmath>
 
 #include "andres/graphics/graphics-hdf5.hxx"
 
@@ -6,10 +7,108 @@ inline void test(const bool condition) {
     if(!condition) throw std::logic_error("test failed.");
 }
 
+template<class GRAPHICS>
+void testEqual(const GRAPHICS& graphics, const GRAPHICS& graphicsLoaded) {
+    typedef typename GRAPHICS::size_type size_type;
+
+    test(graphics.numberOfPointProperties() == graphicsLoaded.numberOfPointProperties());
+    test(graphics.numberOfPoints() == graphicsLoaded.numberOfPoints());
+    test(graphics.numberOfLineProperties() == graphicsLoaded.numberOfLineProperties());
+    test(graphics.numberOfLines() == graphicsLoaded.numberOfLines());
+    test(graphics.numberOfTriangleProperties() == graphicsLoaded.numberOfTriangleProperties());
+    test(graphics.numberOfTriangles() == graphicsLoaded.numberOfTriangles());
+    for(size_type j = 0; j < graphics.numberOfPointProperties(); ++j) {
+        test(graphics.pointProperty(j) == graphicsLoaded.pointProperty(j));
+    }
+    for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+        test(graphics.point(j) == graphicsLoaded.point(j));
+    }
+    for(size_type j = 0; j < graphics.numberOfLineProperties(); ++j) {
+        test(graphics.lineProperty(j) == graphicsLoaded.lineProperty(j));
+    }
+    for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
+        test(graphics.line(j) == graphicsLoaded.line(j));
+    }
+    for(size_type j = 0; j < graphics.numberOfTriangleProperties(); ++j) {
+        test(graphics.triangleProperty(j) == graphicsLoaded.triangleProperty(j));
+    }
+    for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+        test(graphics.triangle(j) == graphicsLoaded.triangle(j));
+    }
+}
+
+// compare graphics of possibly different types, with a tolerance for coordinates
+template<class GRAPHICS0, class GRAPHICS1>
+void testEquivalent(const GRAPHICS0& g0, const GRAPHICS1& g1, const float tolerance = 0) {
+    test(g0.numberOfPoints() == g1.numberOfPoints());
+    test(g0.numberOfLines() == g1.numberOfLines());
+    test(g0.numberOfTriangles() == g1.numberOfTriangles());
+    test(g0.numberOfPointProperties() == g1.numberOfPointProperties());
+    test(g0.numberOfLineProperties() == g1.numberOfLineProperties());
+    test(g0.numberOfTriangleProperties() == g1.numberOfTriangleProperties());
+    for(std::size_t j = 0; j < g0.numberOfPoints(); ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            test(std::abs(g0.point(j)[k] - g1.point(j)[k]) <= tolerance);
+        }
+        test(g0.point(j).propertyIndex() == g1.point(j).propertyIndex());
+    }
+    for(std::size_t j = 0; j < g0.numberOfLines(); ++j) {
+        for(std::size_t k = 0; k < 2; ++k) {
+            test(g0.line(j).pointIndex(k) == g1.line(j).pointIndex(k));
+        }
+        test(g0.line(j).propertyIndex() == g1.line(j).propertyIndex());
+    }
+    for(std::size_t j = 0; j < g0.numberOfTriangles(); ++j) {
+        for(std::size_t k = 0; k < 3; ++k) {
+            test(g0.triangle(j).pointIndex(k) == g1.triangle(j).pointIndex(k));
+        }
+        test(g0.triangle(j).propertyIndex() == g1.triangle(j).propertyIndex());
+    }
+    for(std::size_t j = 0; j < g0.numberOfPointProperties(); ++j) {
+        test(g0.pointProperty(j).alpha() == g1.pointProperty(j).alpha());
+        for(std::size_t k = 0; k < 3; ++k) {
+            test(g0.pointProperty(j).color(k) == g1.pointProperty(j).color(k));
+        }
+    }
+}
+
+// visitor that assembles the streamed batches and records the batch sizes
+template<class GRAPHICS>
+struct CollectingVisitor {
+    typedef typename GRAPHICS::value_type value_type;
+    typedef typename GRAPHICS::size_type size_type;
+
+    void pointProperties(const typename GRAPHICS::PointPropertiesVector& properties)
+        { pointProperties_ = properties; }
+    void points(const typename GRAPHICS::PointsVector& batch, const std::size_t offset)
+        { append(points_, batch, offset); }
+    void lineProperties(const typename GRAPHICS::LinePropertiesVector& properties)
+        { lineProperties_ = properties; }
+    void lines(const typename GRAPHICS::LinesVector& batch, const std::size_t offset)
+        { append(lines_, batch, offset); }
+    void triangleProperties(const typename GRAPHICS::TrianglePropertiesVector& properties)
+        { triangleProperties_ = properties; }
+    void triangles(const typename GRAPHICS::TrianglesVector& batch, const std::size_t offset)
+        { append(triangles_, batch, offset); }
+
+    template<class V>
+    void append(V& target, const V& batch, const std::size_t offset)
+        {
+            test(offset == target.size());
+            test(batch.size() <= 3);
+            target.insert(target.end(), batch.begin(), batch.end());
+        }
+
+    typename GRAPHICS::PointPropertiesVector pointProperties_;
+    typename GRAPHICS::PointsVector points_;
+    typename GRAPHICS::LinePropertiesVector lineProperties_;
+    typename GRAPHICS::LinesVector lines_;
+    typename GRAPHICS::TrianglePropertiesVector triangleProperties_;
+    typename GRAPHICS::TrianglesVector triangles_;
+};
+
 int main() {
     typedef andres::graphics::Graphics<> Graphics;
-    typedef typename Graphics::PointType Point;
-    typedef typename Graphics::LineType Line;
     typedef typename Graphics::size_type size_type;
 
     // draw and save graphics
@@ -63,20 +162,169 @@ int main() {
     }
 
     // test equality of graphics
-    test(graphics.numberOfPointProperties() == graphicsLoaded.numberOfPointProperties());
-    test(graphics.numberOfPoints() == graphicsLoaded.numberOfPoints());
-    test(graphics.numberOfLineProperties() == graphicsLoaded.numberOfLineProperties());
-    test(graphics.numberOfLines() == graphicsLoaded.numberOfLines());
-    for(size_type j = 0; j < graphics.numberOfPointProperties(); ++j) {
-        test(graphics.pointProperty(j) == graphicsLoaded.pointProperty(j));
+    testEqual(graphics, graphicsLoaded);
+
+    // save with chunked layout and compression, several chunks per dataset
+    {
+        const andres::graphics::hdf5::SaveOptions saveOptions = andres::graphics::hdf5::SaveOptions::compressed(3);
+        hid_t file = andres::graphics::hdf5::createFile("graphics-compressed.h5");
+        andres::graphics::hdf5::save(file, graphics, saveOptions);
+        andres::graphics::hdf5::closeFile(file);
     }
-    for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
-        test(graphics.point(j) == graphicsLoaded.point(j));
+    for(std::size_t numberOfThreads = 1; numberOfThreads < 4; ++numberOfThreads) {
+        Graphics graphicsLoaded;
+        hid_t file = andres::graphics::hdf5::openFile("graphics-compressed.h5");
+        andres::graphics::hdf5::load(file, graphicsLoaded, andres::graphics::ParallelOptions(numberOfThreads));
+        andres::graphics::hdf5::closeFile(file);
+        testEqual(graphics, graphicsLoaded);
     }
-    for(size_type j = 0; j < graphics.numberOfLineProperties(); ++j) {
-        test(graphics.lineProperty(j) == graphicsLoaded.lineProperty(j));
+
+    // stream in batches of at most 3 elements
+    for(int compressed = 0; compressed < 2; ++compressed) {
+        CollectingVisitor<Graphics> visitor;
+        hid_t file = andres::graphics::hdf5::openFile(compressed ? "graphics-compressed.h5" : "graphics.h5");
+        andres::graphics::hdf5::visit(file, visitor, 3);
+        andres::graphics::hdf5::closeFile(file);
+
+        Graphics graphicsStreamed;
+        graphicsStreamed.assign(std::move(visitor.pointProperties_), std::move(visitor.points_),
+            std::move(visitor.lineProperties_), std::move(visitor.lines_),
+            std::move(visitor.triangleProperties_), std::move(visitor.triangles_));
+        testEqual(graphics, graphicsStreamed);
     }
-    for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
-        test(graphics.line(j) == graphicsLoaded.line(j));
+
+    // assign validates all indices before taking the vectors, such that
+    // corrupt files are rejected
+    {
+        CollectingVisitor<Graphics> visitor;
+        hid_t file = andres::graphics::hdf5::openFile("graphics.h5");
+        andres::graphics::hdf5::visit(file, visitor, 3);
+        andres::graphics::hdf5::closeFile(file);
+
+        Graphics graphicsAssigned = graphics;
+        for(int corrupt = 0; corrupt < 3; ++corrupt) {
+            if(corrupt == 0) {
+                visitor.points_[5].propertyIndex() = 2;
+            }
+            else if(corrupt == 1) {
+                visitor.lines_[11].pointIndex(1) = 8;
+            }
+            else {
+                visitor.triangles_[1].propertyIndex() = 2;
+            }
+            bool thrown = false;
+            try {
+                graphicsAssigned.assign(visitor.pointProperties_, visitor.points_,
+                    visitor.lineProperties_, visitor.lines_,
+                    visitor.triangleProperties_, visitor.triangles_);
+            }
+            catch(const std::out_of_range&) {
+                thrown = true;
+            }
+            test(thrown);
+            testEqual(graphics, graphicsAssigned);
+
+            thrown = false;
+            try {
+                graphicsAssigned.assign(std::move(visitor.pointProperties_), std::move(visitor.points_),
+                    std::move(visitor.lineProperties_), std::move(visitor.lines_),
+                    std::move(visitor.triangleProperties_), std::move(visitor.triangles_));
+            }
+            catch(const std::out_of_range&) {
+                thrown = true;
+            }
+            test(thrown);
+            test(visitor.points_.size() == 8 && visitor.lines_.size() == 12 && visitor.triangles_.size() == 2); // not taken
+            testEqual(graphics, graphicsAssigned);
+
+            visitor.points_[5] = graphics.point(5);
+            visitor.lines_[11] = graphics.line(11);
+            visitor.triangles_[1] = graphics.triangle(1);
+        }
+        graphicsAssigned.assign(std::move(visitor.pointProperties_), std::move(visitor.points_),
+            std::move(visitor.lineProperties_), std::move(visitor.lines_),
+            std::move(visitor.triangleProperties_), std::move(visitor.triangles_));
+        testEqual(graphics, graphicsAssigned);
+    }
+
+    // chunked layout without compression
+    {
+        hid_t file = andres::graphics::hdf5::createFile("graphics-chunked.h5");
+        andres::graphics::hdf5::save(file, graphics, andres::graphics::hdf5::SaveOptions(5));
+        andres::graphics::hdf5::closeFile(file);
+
+        Graphics graphicsLoaded;
+        file = andres::graphics::hdf5::openFile("graphics-chunked.h5");
+        andres::graphics::hdf5::load(file, graphicsLoaded);
+        andres::graphics::hdf5::closeFile(file);
+        testEqual(graphics, graphicsLoaded);
+    }
+
+    // load the existing format into a graphics with 32-bit indices
+    typedef andres::graphics::Graphics<float, unsigned int> CompactGraphics;
+    {
+        CompactGraphics graphicsLoaded;
+        hid_t file = andres::graphics::hdf5::openFile("graphics.h5");
+        andres::graphics::hdf5::load(file, graphicsLoaded);
+        andres::graphics::hdf5::closeFile(file);
+        testEquivalent(graphics, graphicsLoaded);
+    }
+
+    // compact index types, with and without compression
+    for(int compressed = 0; compressed < 2; ++compressed) {
+        andres::graphics::hdf5::SaveOptions saveOptions = compressed
+            ? andres::graphics::hdf5::SaveOptions::compressed(3)
+            : andres::graphics::hdf5::SaveOptions();
+        saveOptions.compactTypes_ = true;
+        hid_t file = andres::graphics::hdf5::createFile("graphics-compact.h5");
+        andres::graphics::hdf5::save(file, graphics, saveOptions);
+        andres::graphics::hdf5::closeFile(file);
+
+        Graphics graphicsLoaded;
+        CompactGraphics compactGraphicsLoaded;
+        file = andres::graphics::hdf5::openFile("graphics-compact.h5");
+        andres::graphics::hdf5::load(file, graphicsLoaded);
+        andres::graphics::hdf5::load(file, compactGraphicsLoaded);
+        andres::graphics::hdf5::closeFile(file);
+        testEqual(graphics, graphicsLoaded);
+        testEquivalent(graphics, compactGraphicsLoaded);
+    }
+
+    // quantized coordinates
+    {
+        Graphics g = graphics;
+        g.definePoint(0.5f, -0.25f, 0.3f);
+        hid_t file = andres::graphics::hdf5::createFile("graphics-quantized.h5");
+        andres::graphics::hdf5::save(file, g, andres::graphics::hdf5::SaveOptions(0, 0, true, true, true));
+        andres::graphics::hdf5::closeFile(file);
+
+        Graphics graphicsLoaded;
+        file = andres::graphics::hdf5::openFile("graphics-quantized.h5");
+        andres::graphics::hdf5::load(file, graphicsLoaded);
+        andres::graphics::hdf5::closeFile(file);
+        testEquivalent(g, graphicsLoaded, 1.25f / 65535);
+
+        CollectingVisitor<Graphics> visitor;
+        file = andres::graphics::hdf5::openFile("graphics-quantized.h5");
+        andres::graphics::hdf5::visit(file, visitor, 3);
+        andres::graphics::hdf5::closeFile(file);
+        test(visitor.points_ == graphicsLoaded.points());
+    }
+
+    // structure of arrays, in the format of Graphics
+    {
+        typedef andres::graphics::GraphicsSoA<> GraphicsSoA;
+        hid_t file = andres::graphics::hdf5::createFile("graphics-soa.h5");
+        andres::graphics::hdf5::save(file, GraphicsSoA(graphics));
+        andres::graphics::hdf5::closeFile(file);
+
+        Graphics graphicsLoaded;
+        GraphicsSoA graphicsSoALoaded;
+        file = andres::graphics::hdf5::openFile("graphics-soa.h5");
+        andres::graphics::hdf5::load(file, graphicsLoaded);
+        andres::graphics::hdf5::load(file, graphicsSoALoaded);
+        andres::graphics::hdf5::closeFile(file);
+        testEqual(graphics, graphicsLoaded);
+        testEquivalent(graphics, graphicsSoALoaded);
     }
 }
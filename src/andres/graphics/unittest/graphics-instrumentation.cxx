@@ -0,0 +1,126 @@
+#ifndef ANDRES_GRAPHICS_WITH_INSTRUMENTATION
+#   define ANDRES_GRAPHICS_WITH_INSTRUMENTATION
+#endif
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/svg.hxx"
+#include "andres/graphics/instrumentation.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::OrthogonalProjection<> Projection;
+typedef andres::graphics::instrumentation::Counter Counter;
+typedef andres::graphics::instrumentation::Statistics Statistics;
+
+namespace instrumentation = andres::graphics::instrumentation;
+
+Statistics find(const std::string& name) {
+    const std::vector<Statistics> statistics = instrumentation::statistics();
+    for(std::size_t j = 0; j < statistics.size(); ++j) {
+        if(statistics[j].name_ == name) {
+            return statistics[j];
+        }
+    }
+    return Statistics(name);
+}
+
+int main() {
+    // counters are created once per name
+    {
+        Counter& counter = instrumentation::counter("test");
+        test(&instrumentation::counter("test") == &counter);
+        test(&instrumentation::counter("other") != &counter);
+        test(counter.name() == "test");
+        test(counter.calls() == 0 && counter.nanoseconds() == 0 && counter.items() == 0);
+    }
+
+    // scoped timers add calls, time and items
+    {
+        for(std::size_t j = 0; j < 3; ++j) {
+            ANDRES_GRAPHICS_TIMER(timer, "test");
+            timer.addItems(j);
+            timer.addItems(1);
+        }
+        const Statistics s = find("test");
+        test(s.calls_ == 3);
+        test(s.items_ == 6);
+    }
+
+    // hooks in center, normalize, transform and saveSVG
+    {
+        Graphics graphics;
+        graphics.definePoint(1, 2, 3);
+        graphics.definePoint(3, 4, 5);
+        graphics.defineLine(0, 1);
+        graphics.center();
+        graphics.normalize(andres::graphics::ParallelOptions(2));
+        graphics.normalize(0, 1);
+        const float matrix[3][4] = {{1, 0, 0, 1}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+        graphics.transform(matrix);
+        graphics.transform(matrix, andres::graphics::ParallelOptions(2));
+        test(find("Graphics::center").calls_ == 1);
+        test(find("Graphics::center").items_ == 2);
+        test(find("Graphics::normalize").calls_ == 2);
+        test(find("Graphics::normalize").items_ == 4);
+        test(find("Graphics::transform").calls_ == 2);
+        test(find("Graphics::transform").items_ == 4);
+
+        std::ostringstream out;
+        andres::graphics::saveSVG(graphics, Projection(), out);
+        test(find("saveSVG").calls_ == 1);
+        test(find("saveSVG").items_ == 3);
+
+        std::ostringstream report;
+        instrumentation::print(report);
+        test(report.str().find("Graphics::normalize") != std::string::npos);
+        test(report.str().find("other") == std::string::npos); // never called
+
+        // disabled hooks do not count
+        instrumentation::enable(false);
+        test(!instrumentation::isEnabled());
+        graphics.center();
+        test(find("Graphics::center").calls_ == 1);
+        instrumentation::enable();
+        graphics.center();
+        test(find("Graphics::center").calls_ == 2);
+    }
+
+    // concurrent updates
+    {
+        Counter& counter = instrumentation::counter("concurrent");
+        std::vector<std::thread> threads;
+        for(std::size_t t = 0; t < 4; ++t) {
+            threads.push_back(std::thread([&counter]() {
+                for(std::size_t j = 0; j < 1000; ++j) {
+                    counter.add(1, 2);
+                }
+            }));
+        }
+        for(std::size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        test(counter.calls() == 4000 && counter.nanoseconds() == 4000 && counter.items() == 8000);
+    }
+
+    // reset
+    {
+        instrumentation::reset();
+        const std::vector<Statistics> statistics = instrumentation::statistics();
+        test(!statistics.empty());
+        for(std::size_t j = 0; j < statistics.size(); ++j) {
+            test(statistics[j].calls_ == 0 && statistics[j].items_ == 0);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include <random>
+
+#include "andres/graphics/graphics.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+void testEqual(const Graphics& a, const Graphics& b) {
+    test(a.numberOfPoints() == b.numberOfPoints());
+    for(size_type j = 0; j < a.numberOfPoints(); ++j) {
+        test(a.point(j) == b.point(j));
+    }
+}
+
+int main() {
+    // enough points to be split among several threads
+    Graphics graphics;
+    {
+        std::mt19937 randomEngine(42);
+        std::uniform_real_distribution<float> distribution(-3.0f, 7.0f);
+        for(size_type j = 0; j < 300001; ++j) {
+            graphics.definePoint(distribution(randomEngine), distribution(randomEngine), 2 * distribution(randomEngine));
+        }
+    }
+    test(andres::graphics::numberOfBlocks(graphics.numberOfPoints(), ParallelOptions(4)) == 4);
+
+    // parallel transforms are bit-identical to serial transforms
+    const float matrix[3][4] = {
+        {0.0f, -1.0f, 0.0f, 1.0f},
+        {1.0f, 0.0f, 0.0f, 2.0f},
+        {0.0f, 0.0f, 0.5f, 3.0f}
+    };
+    for(size_type numberOfThreads = 2; numberOfThreads <= 5; ++numberOfThreads) {
+        const ParallelOptions parallelOptions(numberOfThreads);
+        Graphics serial = graphics;
+        Graphics parallel = graphics;
+        serial.center(1);
+        parallel.center(1, parallelOptions);
+        testEqual(serial, parallel);
+        serial.normalize(2);
+        parallel.normalize(2, parallelOptions);
+        testEqual(serial, parallel);
+        serial.normalize(0, 2);
+        parallel.normalize(0, 2, parallelOptions);
+        testEqual(serial, parallel);
+        serial.transform(matrix);
+        parallel.transform(matrix, parallelOptions);
+        testEqual(serial, parallel);
+        serial.center();
+        parallel.center(parallelOptions);
+        testEqual(serial, parallel);
+        serial.normalize();
+        parallel.normalize(parallelOptions);
+        testEqual(serial, parallel);
+    }
+
+    // affine transformation
+    {
+        Graphics g;
+        g.definePoint(1, 2, 3);
+        g.transform(matrix);
+        test(g.point(0) == Graphics::PointType(-1, 3, 4.5f));
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <stdexcept>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/rasterizer.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::OrthogonalProjection<> Projection;
+typedef andres::graphics::Framebuffer Framebuffer;
+typedef andres::graphics::RasterizerOptions RasterizerOptions;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef Graphics::size_type size_type;
+
+// window coordinates are x and y, depth is z
+const Projection identity(1, 0, 0, 0, 1, 0, 0, 0, 1);
+
+bool hasColor(const Framebuffer& framebuffer, const std::size_t x, const std::size_t y,
+    const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char alpha = 255
+) {
+    const unsigned char* p = framebuffer.pixel(x, y);
+    return p[0] == r && p[1] == g && p[2] == b && p[3] == alpha;
+}
+
+std::size_t countColor(const Framebuffer& framebuffer, const unsigned char r, const unsigned char g, const unsigned char b) {
+    std::size_t n = 0;
+    for(std::size_t y = 0; y < framebuffer.height(); ++y) {
+        for(std::size_t x = 0; x < framebuffer.width(); ++x) {
+            n += hasColor(framebuffer, x, y, r, g, b);
+        }
+    }
+    return n;
+}
+
+std::uint32_t bigEndian(const std::string& data, const std::size_t j) {
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(data[j])) << 24)
+        | (static_cast<std::uint32_t>(static_cast<unsigned char>(data[j + 1])) << 16)
+        | (static_cast<std::uint32_t>(static_cast<unsigned char>(data[j + 2])) << 8)
+        | static_cast<std::uint32_t>(static_cast<unsigned char>(data[j + 3]));
+}
+
+int main() {
+    // two half transparent triangles that tile a square blend each pixel once
+    {
+        Graphics graphics;
+        const size_type hidden = graphics.definePointProperty(false, 0, 0, 0);
+        const size_type property = graphics.defineTriangleProperty(true, 255, 0, 0, 128);
+        graphics.definePoint(1.0f, 1.0f, 0.0f, hidden);
+        graphics.definePoint(7.0f, 1.0f, 0.0f, hidden);
+        graphics.definePoint(7.0f, 7.0f, 0.0f, hidden);
+        graphics.definePoint(1.0f, 7.0f, 0.0f, hidden);
+        graphics.defineTriangle(0, 1, 2, property);
+        graphics.defineTriangle(0, 2, 3, property);
+        Framebuffer framebuffer(8, 8);
+        andres::graphics::rasterize(graphics, identity, framebuffer);
+        test(countColor(framebuffer, 255, 127, 127) == 36);
+        test(countColor(framebuffer, 255, 255, 255) == 64 - 36);
+        test(hasColor(framebuffer, 1, 1, 255, 127, 127));
+        test(hasColor(framebuffer, 6, 6, 255, 127, 127));
+        test(hasColor(framebuffer, 0, 0, 255, 255, 255));
+        test(framebuffer.depth(3, 3) == 0.0f);
+    }
+
+    // depth test: the nearer triangle wins, regardless of the order
+    for(std::size_t order = 0; order < 2; ++order) {
+        Graphics graphics;
+        const size_type hidden = graphics.definePointProperty(false, 0, 0, 0);
+        const size_type red = graphics.defineTriangleProperty(true, 255, 0, 0);
+        const size_type blue = graphics.defineTriangleProperty(true, 0, 0, 255);
+        const float depths[] = {order == 0 ? 0.5f : -0.5f, order == 0 ? -0.5f : 0.5f};
+        for(std::size_t j = 0; j < 2; ++j) {
+            const size_type first = graphics.definePoint(0.0f, 0.0f, depths[j], hidden);
+            graphics.definePoint(16.0f, 0.0f, depths[j], hidden);
+            graphics.definePoint(0.0f, 16.0f, depths[j], hidden);
+            graphics.defineTriangle(first, first + 1, first + 2, j == 0 ? red : blue);
+        }
+        Framebuffer framebuffer(8, 8);
+        andres::graphics::rasterize(graphics, identity, framebuffer);
+        if(order == 0) {
+            test(countColor(framebuffer, 0, 0, 255) == 64);
+        }
+        else {
+            test(countColor(framebuffer, 255, 0, 0) == 64);
+        }
+
+        // depth range
+        framebuffer.clear(255, 255, 255);
+        andres::graphics::rasterize(graphics, identity, framebuffer, RasterizerOptions(5.0f, 1.0f, 64, 0.0f, 1.0f));
+        test(countColor(framebuffer, order == 0 ? 255 : 0, 0, order == 0 ? 0 : 255) == 64);
+    }
+
+    // points, lines, invisible primitives
+    {
+        Graphics graphics;
+        const size_type green = graphics.definePointProperty(true, 0, 255, 0);
+        const size_type hidden = graphics.definePointProperty(false, 0, 0, 0);
+        const size_type blue = graphics.defineLineProperty(true, 0, 0, 255);
+        graphics.definePoint(4.5f, 4.5f, 0.0f, green);
+        graphics.definePoint(12.0f, 12.0f, 0.0f, hidden);
+        graphics.definePoint(1.0f, 12.5f, 0.0f, hidden);
+        graphics.definePoint(6.0f, 12.5f, 0.0f, hidden);
+        graphics.defineLine(2, 3, blue);
+        graphics.definePoint(14.5f, 1.0f, 0.0f, hidden);
+        graphics.definePoint(14.5f, 9.0f, 0.0f, hidden);
+        graphics.defineLine(4, 5, blue);
+        Framebuffer framebuffer(16, 16);
+        andres::graphics::rasterize(graphics, identity, framebuffer, RasterizerOptions(3.0f, 1.0f, 5));
+        test(countColor(framebuffer, 0, 255, 0) == 9);
+        for(std::size_t y = 3; y < 6; ++y) {
+            for(std::size_t x = 3; x < 6; ++x) {
+                test(hasColor(framebuffer, x, y, 0, 255, 0));
+            }
+        }
+        test(countColor(framebuffer, 0, 0, 255) == 5 + 8);
+        for(std::size_t x = 1; x < 6; ++x) {
+            test(hasColor(framebuffer, x, 12, 0, 0, 255));
+        }
+        for(std::size_t y = 1; y < 9; ++y) {
+            test(hasColor(framebuffer, 14, y, 0, 0, 255));
+        }
+
+        // wide lines
+        framebuffer.clear(255, 255, 255);
+        andres::graphics::rasterize(graphics, identity, framebuffer, RasterizerOptions(1.0f, 3.0f));
+        test(countColor(framebuffer, 0, 0, 255) == 3 * (5 + 8));
+        test(hasColor(framebuffer, 3, 11, 0, 0, 255));
+        test(hasColor(framebuffer, 3, 13, 0, 0, 255));
+    }
+
+    // the result does not depend on the number of threads and the tile size
+    {
+        std::mt19937 randomEngine(42);
+        std::uniform_real_distribution<float> coordinate(-20.0f, 220.0f);
+        std::uniform_int_distribution<int> color(0, 255);
+        Graphics graphics;
+        for(std::size_t j = 0; j < 10; ++j) {
+            graphics.definePointProperty(true, color(randomEngine), color(randomEngine), color(randomEngine), color(randomEngine));
+            graphics.defineLineProperty(j != 3, color(randomEngine), color(randomEngine), color(randomEngine), color(randomEngine));
+            graphics.defineTriangleProperty(true, color(randomEngine), color(randomEngine), color(randomEngine), color(randomEngine));
+        }
+        for(std::size_t j = 0; j < 3000; ++j) {
+            graphics.definePoint(coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine), j % 11);
+        }
+        for(std::size_t j = 0; j + 2 < 3000; j += 3) {
+            graphics.defineLine(j, j + 1, j % 11);
+            graphics.defineTriangle(j, j + 1, j + 2, j % 11);
+        }
+        Framebuffer reference(200, 150);
+        andres::graphics::rasterize(graphics, identity, reference, RasterizerOptions(), ParallelOptions(1));
+        const std::size_t tileSizes[] = {1, 7, 64, 1000};
+        for(std::size_t j = 0; j < 4; ++j) {
+            Framebuffer framebuffer(200, 150);
+            RasterizerOptions options;
+            options.tileSize_ = tileSizes[j];
+            andres::graphics::rasterize(graphics, identity, framebuffer, options, ParallelOptions(3));
+            test(framebuffer.rgba() == reference.rgba());
+        }
+
+        // PPM
+        std::ostringstream ppm;
+        const std::size_t bytes = andres::graphics::savePPM(reference, ppm);
+        test(ppm.str().size() == bytes);
+        test(ppm.str().compare(0, 15, "P6\n200 150\n255\n") == 0);
+        test(bytes == 15 + 3 * 200 * 150);
+        test(static_cast<unsigned char>(ppm.str()[15 + 3 * (200 * 10 + 20) + 1]) == reference.pixel(20, 10)[1]);
+
+        // PNG
+        std::ostringstream png;
+        test(andres::graphics::savePNG(reference, png) == png.str().size());
+        const std::string data = png.str();
+        test(data.compare(0, 8, "\x89PNG\r\n\x1a\n") == 0);
+        std::vector<std::string> types;
+        for(std::size_t j = 8; j < data.size(); ) {
+            const std::uint32_t size = bigEndian(data, j);
+            test(j + 12 + size <= data.size());
+            const unsigned char* chunk = reinterpret_cast<const unsigned char*>(data.data()) + j + 4;
+            test(andres::graphics::detail::crc32(0, chunk, 4 + size) == bigEndian(data, j + 8 + size));
+            types.push_back(data.substr(j + 4, 4));
+            j += 12 + size;
+        }
+        test(types.front() == "IHDR");
+        test(types.back() == "IEND");
+        test(bigEndian(data, 16) == 200);
+        test(bigEndian(data, 20) == 150);
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <stdexcept>
+#include <random>
+#include <sstream>
+
+#include "andres/graphics/graphics-soa.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/svg.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::GraphicsSoA<> GraphicsSoA;
+typedef Graphics::size_type size_type;
+
+void testEqual(const Graphics& graphics, const GraphicsSoA& graphicsSoA) {
+    test(graphics.numberOfPoints() == graphicsSoA.numberOfPoints());
+    for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+        test(graphics.point(j) == graphicsSoA.point(j));
+    }
+}
+
+int main() {
+    // random points (the number is not a multiple of the vector width)
+    Graphics graphics;
+    {
+        const size_type pointProperty = graphics.definePointProperty(true, 255, 0, 0);
+        std::mt19937 randomEngine(42);
+        std::uniform_real_distribution<float> distribution(-3.0f, 7.0f);
+        for(size_type j = 0; j < 1001; ++j) {
+            graphics.definePoint(distribution(randomEngine), distribution(randomEngine),
+                2 * distribution(randomEngine), j % 2 == 0 ? 0 : pointProperty);
+        }
+        graphics.defineLine(0, 1);
+        graphics.defineTriangle(0, 1, 2);
+    }
+
+    // conversion
+    GraphicsSoA graphicsSoA(graphics);
+    testEqual(graphics, graphicsSoA);
+    test(graphicsSoA.numberOfLines() == 1);
+    test(graphicsSoA.numberOfTriangles() == 1);
+    test(graphicsSoA.numberOfPointProperties() == 2);
+    {
+        Graphics copy;
+        graphicsSoA.copyTo(copy);
+        testEqual(copy, graphicsSoA);
+    }
+
+    // read-only interface and SVG export
+    {
+        test(graphicsSoA.points() == graphics.points());
+        test(graphicsSoA.lines() == graphics.lines());
+        test(graphicsSoA.triangles() == graphics.triangles());
+        test(graphicsSoA.pointProperties() == graphics.pointProperties());
+        test(graphicsSoA.coordinates(2)[5] == graphics.point(5)[2]);
+        test(graphicsSoA.pointPropertyIndices()[5] == graphics.point(5).propertyIndex());
+
+        std::ostringstream out;
+        std::ostringstream outSoA;
+        andres::graphics::saveSVG(graphics, andres::graphics::OrthogonalProjection<>(), out);
+        andres::graphics::saveSVG(graphicsSoA, andres::graphics::OrthogonalProjection<>(), outSoA);
+        test(outSoA.str() == out.str());
+    }
+
+    // transforms are bit-identical to those of Graphics
+    {
+        Graphics g = graphics;
+        GraphicsSoA h(g);
+        g.center(1);
+        h.center(1);
+        testEqual(g, h);
+        g.normalize(2);
+        h.normalize(2);
+        testEqual(g, h);
+        g.normalize(0, 2);
+        h.normalize(0, 2);
+        testEqual(g, h);
+        g.center();
+        h.center();
+        testEqual(g, h);
+        g.normalize();
+        h.normalize();
+        testEqual(g, h);
+    }
+
+    // definition of points
+    {
+        GraphicsSoA h;
+        test(h.definePoint(1, 2, 3) == 0);
+        test(h.point(0) == Graphics::PointType(1, 2, 3));
+        bool thrown = false;
+        try {
+            h.definePoint(1, 2, 3, 1);
+        }
+        catch(std::out_of_range&) {
+            thrown = true;
+        }
+        test(thrown);
+    }
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include <stdexcept>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/spatial-index.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::SpatialIndex<> SpatialIndex;
+typedef andres::graphics::ParallelOptions ParallelOptions;
+typedef SpatialIndex::PickType Pick;
+typedef Graphics::size_type size_type;
+
+void defineRandomPrimitives(Graphics& graphics, std::mt19937& randomEngine, const size_type numberOfPoints) {
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> offset(-0.05f, 0.05f);
+    const size_type first = graphics.numberOfPoints();
+    for(size_type j = 0; j < numberOfPoints; ++j) {
+        graphics.definePoint(coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine));
+    }
+    // small lines and triangles attached to the new points
+    for(size_type j = first; j < graphics.numberOfPoints(); j += 3) {
+        const size_type a = graphics.definePoint(graphics.point(j)[0] + offset(randomEngine), graphics.point(j)[1] + offset(randomEngine), graphics.point(j)[2] + offset(randomEngine));
+        const size_type b = graphics.definePoint(graphics.point(j)[0] + offset(randomEngine), graphics.point(j)[1] + offset(randomEngine), graphics.point(j)[2] + offset(randomEngine));
+        graphics.defineLine(j, a);
+        graphics.defineTriangle(j, a, b);
+    }
+}
+
+template<class INTERSECTS>
+std::vector<size_type> bruteForce(const size_type size, INTERSECTS intersects) {
+    std::vector<size_type> result;
+    for(size_type j = 0; j < size; ++j) {
+        if(intersects(j)) {
+            result.push_back(j);
+        }
+    }
+    return result;
+}
+
+void testQueries(const Graphics& graphics, const SpatialIndex& index, std::mt19937& randomEngine) {
+    std::uniform_real_distribution<float> coordinate(-1.2f, 1.2f);
+    std::uniform_real_distribution<float> extent(0.0f, 0.6f);
+    std::vector<size_type> result;
+
+    for(std::size_t q = 0; q < 20; ++q) {
+        float minimum[3];
+        float maximum[3];
+        for(std::size_t k = 0; k < 3; ++k) {
+            minimum[k] = coordinate(randomEngine);
+            maximum[k] = minimum[k] + extent(randomEngine);
+        }
+        const float box[] = {minimum[0], minimum[1], minimum[2], maximum[0], maximum[1], maximum[2]};
+
+        index.pointsInBox(minimum, maximum, result);
+        std::sort(result.begin(), result.end());
+        test(result == bruteForce(graphics.numberOfPoints(), [&](const size_type j) {
+            return graphics.point(j)[0] >= minimum[0] && graphics.point(j)[0] <= maximum[0]
+                && graphics.point(j)[1] >= minimum[1] && graphics.point(j)[1] <= maximum[1]
+                && graphics.point(j)[2] >= minimum[2] && graphics.point(j)[2] <= maximum[2];
+        }));
+
+        index.linesInBox(minimum, maximum, result);
+        std::sort(result.begin(), result.end());
+        test(result == bruteForce(graphics.numberOfLines(), [&](const size_type j) {
+            float p[3];
+            float q[3];
+            for(std::size_t k = 0; k < 3; ++k) {
+                p[k] = graphics.point(graphics.line(j).pointIndex(0))[k];
+                q[k] = graphics.point(graphics.line(j).pointIndex(1))[k];
+            }
+            return andres::graphics::detail::segmentIntersectsBox(p, q, box);
+        }));
+
+        index.trianglesInBox(minimum, maximum, result);
+        std::sort(result.begin(), result.end());
+        test(result == bruteForce(graphics.numberOfTriangles(), [&](const size_type j) {
+            float v[3][3];
+            for(std::size_t m = 0; m < 3; ++m) {
+                for(std::size_t k = 0; k < 3; ++k) {
+                    v[m][k] = graphics.point(graphics.triangle(j).pointIndex(m))[k];
+                }
+            }
+            return andres::graphics::detail::triangleIntersectsBox(v[0], v[1], v[2], box);
+        }));
+
+        // nearest points
+        const float position[] = {coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine)};
+        std::vector<std::pair<float, size_type> > distances(graphics.numberOfPoints());
+        for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+            float d = 0;
+            for(std::size_t k = 0; k < 3; ++k) {
+                d += (graphics.point(j)[k] - position[k]) * (graphics.point(j)[k] - position[k]);
+            }
+            distances[j] = std::make_pair(d, j);
+        }
+        std::sort(distances.begin(), distances.end());
+        const std::size_t k = 1 + q % 10;
+        index.nearestPoints(position, k, result);
+        test(result.size() == k);
+        for(std::size_t j = 0; j < k; ++j) { // compare distances as points may coincide
+            float d = 0;
+            for(std::size_t c = 0; c < 3; ++c) {
+                d += (graphics.point(result[j])[c] - position[c]) * (graphics.point(result[j])[c] - position[c]);
+            }
+            test(d == distances[j].first);
+        }
+    }
+}
+
+void testPick(const Graphics& graphics, const SpatialIndex& index, std::mt19937& randomEngine) {
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    for(std::size_t q = 0; q < 20; ++q) {
+        const float origin[] = {coordinate(randomEngine), coordinate(randomEngine), -2.0f};
+        const float direction[] = {0.1f * coordinate(randomEngine), 0.1f * coordinate(randomEngine), 2.0f};
+        const float tolerance = 0.02f;
+        const Pick pick = index.pick(origin, direction, tolerance);
+
+        // brute force
+        const float length = std::sqrt(andres::graphics::detail::dot(direction, direction));
+        const float unit[] = {direction[0] / length, direction[1] / length, direction[2] / length};
+        float distance = std::numeric_limits<float>::infinity();
+        for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+            float v[3][3];
+            for(std::size_t m = 0; m < 3; ++m) {
+                for(std::size_t k = 0; k < 3; ++k) {
+                    v[m][k] = graphics.point(graphics.triangle(j).pointIndex(m))[k];
+                }
+            }
+            distance = std::min(distance, andres::graphics::detail::rayTriangleDistance(origin, unit, v[0], v[1], v[2]));
+        }
+        for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
+            float p[3];
+            float r[3];
+            for(std::size_t k = 0; k < 3; ++k) {
+                p[k] = graphics.point(graphics.line(j).pointIndex(0))[k];
+                r[k] = graphics.point(graphics.line(j).pointIndex(1))[k];
+            }
+            distance = std::min(distance, andres::graphics::detail::raySegmentDistance(origin, unit, p, r, tolerance));
+        }
+        for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+            if(!graphics.pointProperty(graphics.point(j).propertyIndex()).visibility()) {
+                continue;
+            }
+            float p[3];
+            for(std::size_t k = 0; k < 3; ++k) {
+                p[k] = graphics.point(j)[k];
+            }
+            distance = std::min(distance, andres::graphics::detail::raySegmentDistance(origin, unit, p, p, tolerance));
+        }
+        if(distance == std::numeric_limits<float>::infinity()) {
+            test(pick.kind_ == andres::graphics::NoPrimitive);
+        }
+        else {
+            test(pick.kind_ != andres::graphics::NoPrimitive);
+            test(pick.distance_ == distance / length);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 randomEngine(42);
+
+    // empty graphics
+    {
+        Graphics graphics;
+        SpatialIndex index(graphics);
+        const float minimum[] = {-1.0f, -1.0f, -1.0f};
+        const float maximum[] = {1.0f, 1.0f, 1.0f};
+        std::vector<size_type> result;
+        index.pointsInBox(minimum, maximum, result);
+        test(result.empty());
+        index.nearestPoints(minimum, 3, result);
+        test(result.empty());
+        const float direction[] = {0.0f, 0.0f, 1.0f};
+        test(index.pick(minimum, direction, 1.0f).kind_ == andres::graphics::NoPrimitive);
+    }
+
+    // tree sizes for all numbers of primitives around the leaf size
+    for(size_type n = 1; n < 100; ++n) {
+        Graphics graphics;
+        for(size_type j = 0; j < n; ++j) {
+            graphics.definePoint(static_cast<float>(j), 0.0f, 0.0f);
+        }
+        SpatialIndex index(graphics);
+        const float position[] = {static_cast<float>(n) / 2, 0.0f, 0.0f};
+        std::vector<size_type> result;
+        index.nearestPoints(position, n + 1, result);
+        test(result.size() == n);
+    }
+
+    // pick of a triangle, a line and a point in front of each other
+    {
+        Graphics graphics;
+        const size_type hidden = graphics.definePointProperty(false, 0, 0, 0);
+        graphics.definePoint(-1.0f, -1.0f, 3.0f);
+        graphics.definePoint(1.0f, -1.0f, 3.0f);
+        graphics.definePoint(0.0f, 1.0f, 3.0f);
+        graphics.defineTriangle(0, 1, 2);
+        graphics.definePoint(-1.0f, 0.0f, 2.0f);
+        graphics.definePoint(1.0f, 0.0f, 2.0f);
+        graphics.defineLine(3, 4);
+        graphics.definePoint(0.0f, 0.0f, 1.0f, hidden);
+        SpatialIndex index(graphics);
+
+        const float origin[] = {0.0f, 0.0f, 0.0f};
+        const float direction[] = {0.0f, 0.0f, 2.0f};
+        Pick pick = index.pick(origin, direction, 0.1f);
+        test(pick.kind_ == andres::graphics::LinePrimitive);
+        test(pick.index_ == 0);
+        test(std::abs(pick.distance_ - 1.0f) < 1e-6f);
+
+        graphics.definePoint(0.0f, 0.05f, 1.5f);
+        index.update();
+        pick = index.pick(origin, direction, 0.1f);
+        test(pick.kind_ == andres::graphics::PointPrimitive);
+        test(pick.index_ == 6);
+
+        const float offsetOrigin[] = {0.0f, 0.5f, 0.0f};
+        pick = index.pick(offsetOrigin, direction, 0.1f);
+        test(pick.kind_ == andres::graphics::TrianglePrimitive);
+        test(pick.index_ == 0);
+        test(std::abs(pick.distance_ - 1.5f) < 1e-6f);
+    }
+
+    // random scenes, built serially and in parallel
+    for(std::size_t numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3) {
+        Graphics graphics;
+        const size_type hidden = graphics.definePointProperty(false, 0, 0, 0);
+        defineRandomPrimitives(graphics, randomEngine, 10000);
+        for(size_type j = 0; j < graphics.numberOfPoints(); j += 7) {
+            graphics.definePoint(graphics.point(j)[0], graphics.point(j)[1], graphics.point(j)[2], hidden);
+        }
+        SpatialIndex index(graphics, ParallelOptions(numberOfThreads));
+        testQueries(graphics, index, randomEngine);
+        testPick(graphics, index, randomEngine);
+
+        // recent primitives in the second hierarchy, not yet indexed and merged
+        for(std::size_t j = 0; j < 3; ++j) {
+            defineRandomPrimitives(graphics, randomEngine, 1000);
+            testQueries(graphics, index, randomEngine);
+            index.update(ParallelOptions(numberOfThreads));
+            testQueries(graphics, index, randomEngine);
+            testPick(graphics, index, randomEngine);
+        }
+
+        // moved points
+        const float matrix[3][4] = {
+            {0.0f, -1.0f, 0.0f, 0.1f},
+            {1.0f, 0.0f, 0.0f, 0.2f},
+            {0.0f, 0.0f, 0.5f, 0.3f}
+        };
+        graphics.transform(matrix);
+        index.refit();
+        testQueries(graphics, index, randomEngine);
+        testPick(graphics, index, randomEngine);
+    }
+
+    return 0;
+}
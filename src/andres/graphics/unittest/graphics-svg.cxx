@@ -0,0 +1,108 @@
+#include <stdexcept>
+#include <sstream>
+#include <string>
+
+#include "andres/graphics/graphics.hxx"
+#include "andres/graphics/projection.hxx"
+#include "andres/graphics/svg.hxx"
+
+inline void test(const bool condition) {
+    if(!condition) throw std::logic_error("test failed.");
+}
+
+typedef andres::graphics::Graphics<> Graphics;
+typedef andres::graphics::OrthogonalProjection<> Projection;
+typedef Graphics::size_type size_type;
+
+std::string format(const double value, const unsigned int decimals) {
+    char buffer[32];
+    return std::string(buffer, andres::graphics::detail::formatFixed(value, decimals, buffer));
+}
+
+std::size_t count(const std::string& text, const std::string& pattern) {
+    std::size_t n = 0;
+    for(std::size_t j = text.find(pattern); j != std::string::npos; j = text.find(pattern, j + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+int main() {
+    // number formatting
+    test(format(0, 3) == "0");
+    test(format(1, 3) == "1");
+    test(format(-2.5, 3) == "-2.5");
+    test(format(0.1234, 3) == "0.123");
+    test(format(0.0015, 2) == "0");
+    test(format(-0.0004, 3) == "0");
+    test(format(9.9996, 3) == "10");
+    test(format(12345.06, 1) == "12345.1");
+    test(format(0.05, 3) == "0.05");
+    test(format(3.25, 0) == "3");
+    test(format(1e12, 3) == "1e+12");
+
+    // export
+    Graphics graphics;
+    const size_type propertyRed = graphics.definePointProperty(true, 255, 0, 0);
+    const size_type propertyHidden = graphics.definePointProperty(false, 0, 0, 0);
+    graphics.definePoint(0, 0, 0, propertyRed);
+    graphics.definePoint(1, 0, 0, propertyRed);
+    graphics.definePoint(0, 1, 0, propertyHidden);
+    graphics.defineLine(0, 1);
+    graphics.defineLine(1, 2, graphics.defineLineProperty(true, 0, 0, 255, 128));
+    graphics.defineTriangle(0, 1, 2);
+
+    std::stringstream stream;
+    const std::size_t bytes = andres::graphics::saveSVG(graphics, Projection(), stream, andres::graphics::SVGOptions(3, 16));
+    const std::string svg = stream.str();
+    test(bytes == svg.size());
+    test(svg.find("</svg>\n") == svg.size() - 7);
+    test(count(svg, "<circle ") == 2);
+    test(count(svg, "<line ") == 2);
+    test(count(svg, "<polygon ") == 1);
+    test(svg.find(".p1{stroke:rgb(255,0,0);fill:rgb(255,0,0);}") != std::string::npos);
+    test(svg.find(".p2{") == std::string::npos);
+    test(svg.find(".l1{stroke:rgb(0,0,255);stroke-opacity:0.502;}") != std::string::npos);
+    test(svg.find("<circle class=\"p1\" cx=\"1\" cy=\"0\" r=\"1pt\"/>") != std::string::npos);
+    test(svg.find("<line class=\"l1\" x1=\"1\" y1=\"0\" x2=\"0\" y2=\"1\"/>") != std::string::npos);
+    test(svg.find("<polygon class=\"t0\" points=\"0,0 1,0 0,1\"/>") != std::string::npos);
+    test(svg.find("<polygon") < svg.find("<circle"));
+
+    // more than 9 decimals are rejected, also if set after construction
+    {
+        bool thrown = false;
+        try {
+            andres::graphics::SVGOptions options(10);
+        }
+        catch(std::runtime_error&) {
+            thrown = true;
+        }
+        test(thrown);
+
+        andres::graphics::SVGOptions options(9);
+        options.decimals_ = 12;
+        std::stringstream stream;
+        thrown = false;
+        try {
+            andres::graphics::saveSVG(graphics, Projection(), stream, options);
+        }
+        catch(std::runtime_error&) {
+            thrown = true;
+        }
+        test(thrown);
+        test(stream.str().empty());
+    }
+
+#ifdef ANDRES_GRAPHICS_WITH_ZLIB
+    // gzip-compressed export
+    test(andres::graphics::saveSVGZ(graphics, Projection(), "graphics.svgz") == svg.size());
+    gzFile file = gzopen("graphics.svgz", "rb");
+    test(file != NULL);
+    std::string decompressed(svg.size() + 1, '\0');
+    const int size = gzread(file, &decompressed[0], static_cast<unsigned int>(decompressed.size()));
+    gzclose(file);
+    test(decompressed.substr(0, size) == svg);
+#endif
+
+    return 0;
+}
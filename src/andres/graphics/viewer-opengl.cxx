@@ -1,8 +1,17 @@
 #include <cstddef>
 #include <fstream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cstring>
 
 #include <andres/graphics/graphics-hdf5.hxx>
+#include <andres/graphics/graphics-binary.hxx>
+#include <andres/graphics/culling.hxx>
 #include <andres/graphics/svg.hxx>
+#include <andres/graphics/spatial-index.hxx>
+#include <andres/graphics/instrumentation.hxx>
 
 #include <GL/glew.h>
 #include <GL/freeglut.h>
@@ -15,8 +24,11 @@ typedef Graphics::LineType Line;
 typedef Graphics::LinePropertyType LineProperty;
 typedef Graphics::TriangleType Triangle;
 typedef Graphics::TrianglePropertyType TriangleProperty;
+typedef andres::graphics::ScreenSpaceCulling<float, size_type> ScreenSpaceCulling;
+typedef andres::graphics::SpatialIndex<float, size_type> SpatialIndex;
 
 Graphics graphics;
+SpatialIndex spatialIndex(graphics); // built in main() after loading
 
 float pointSize = 5.0f;
 float lineWidth = 1.0f;
@@ -26,6 +38,98 @@ bool showLines = true;
 bool showTriangles = true;
 bool showAxes = true;
 bool showHorizon = true;
+bool retainedMode = true;
+bool cullingEnabled = false;
+float cullingTolerance = 1.0f; // in pixels
+const float pickTolerance = 3.0f; // in pixels
+
+// retained-mode rendering: the graphics is uploaded once into a vertex buffer
+// (one vertex per point, shared by index) and an index buffer in which the
+// visible points, lines and triangles are grouped by property. each group is
+// drawn with a single call of glDrawElements.
+struct DrawRange {
+    GLuint offset; // first index in the index buffer
+    GLuint size; // number of indices
+    GLubyte color[4];
+};
+
+struct Retained {
+    Retained()
+        : vertexBuffer(0), indexBuffer(0), upToDate(false)
+        {}
+
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    std::vector<DrawRange> pointRanges;
+    std::vector<DrawRange> lineRanges;
+    std::vector<DrawRange> triangleRanges;
+    bool upToDate;
+};
+
+Retained retained;
+
+// screen-space culling: primitives outside the window are dropped and
+// primitives that cover the same pixels are merged. the culling is
+// recomputed whenever the view changes.
+struct Culling {
+    Culling()
+        : culling(), upToDate(false)
+        { std::fill(view, view + 18, 0.0f); }
+
+    ScreenSpaceCulling culling;
+    GLfloat view[18]; // modelview matrix and window size of the culling
+    bool upToDate;
+};
+
+Culling culling;
+
+// frame-time statistics
+struct FrameTimes {
+    FrameTimes()
+        { reset(); }
+    void reset()
+        { frames = 0; sum = 0; minimum = std::numeric_limits<double>::infinity(); maximum = 0; }
+    void add(const double milliseconds)
+        {
+            ++frames;
+            sum += milliseconds;
+            minimum = std::min(minimum, milliseconds);
+            maximum = std::max(maximum, milliseconds);
+        }
+    void print(std::ostream& out) const
+        {
+            out << (cullingEnabled ? "culled" : retainedMode ? "retained" : "immediate") << " mode: "
+                << frames << " frames, mean " << sum / frames
+                << " ms, min " << minimum
+                << " ms, max " << maximum << " ms"
+                << std::endl;
+            if(cullingEnabled) {
+                out << "  points: " << culling.culling.points() << std::endl
+                    << "  lines: " << culling.culling.lines() << std::endl
+                    << "  triangles: " << culling.culling.triangles() << std::endl;
+            }
+        }
+
+    std::size_t frames;
+    double sum;
+    double minimum;
+    double maximum;
+};
+
+FrameTimes frameTimes;
+const std::size_t frameTimesReportInterval = 100;
+std::size_t benchmarkFrames = 0; // number of frames still to render in benchmark mode
+
+// per-stage costs accumulated by the hooks in load, center, normalize,
+// saveSVG, cull and display, if compiled with
+// ANDRES_GRAPHICS_WITH_INSTRUMENTATION
+void printInstrumentation() {
+#ifdef ANDRES_GRAPHICS_WITH_INSTRUMENTATION
+    andres::graphics::instrumentation::print(std::cout);
+#else
+    std::cout << "instrumentation not compiled in (ANDRES_GRAPHICS_WITH_INSTRUMENTATION)." << std::endl;
+#endif
+}
 
 void init() {
     glEnable(GL_BLEND);
@@ -38,41 +142,169 @@ void init() {
     glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
 }
 
-void display() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+// append the indices of the visible primitives to the index buffer, grouped by
+// property, and append one draw range per non-empty visible property.
+template<class PROPERTIES, class INDICES_OF>
+void appendGroupedByProperty(
+    const PROPERTIES& properties,
+    const std::vector<size_type>& propertyIndices, // one per primitive
+    const std::size_t verticesPerPrimitive,
+    INDICES_OF indicesOf,
+    std::vector<GLuint>& indices,
+    std::vector<DrawRange>& ranges
+) {
+    // count primitives per property (counting sort)
+    std::vector<std::size_t> offsets(properties.size() + 1, 0);
+    for(size_type j = 0; j < propertyIndices.size(); ++j) {
+        if(properties[propertyIndices[j]].visibility()) {
+            ++offsets[propertyIndices[j] + 1];
+        }
+    }
+    for(std::size_t p = 0; p < properties.size(); ++p) {
+        offsets[p + 1] += offsets[p];
+    }
 
-    glLineWidth(1.0f);
+    const std::size_t begin = indices.size();
+    indices.resize(begin + offsets.back() * verticesPerPrimitive);
+    for(std::size_t p = 0; p < properties.size(); ++p) {
+        if(offsets[p + 1] != offsets[p]) {
+            DrawRange range;
+            range.offset = static_cast<GLuint>(begin + offsets[p] * verticesPerPrimitive);
+            range.size = static_cast<GLuint>((offsets[p + 1] - offsets[p]) * verticesPerPrimitive);
+            range.color[0] = properties[p].color(0);
+            range.color[1] = properties[p].color(1);
+            range.color[2] = properties[p].color(2);
+            range.color[3] = properties[p].alpha();
+            ranges.push_back(range);
+        }
+    }
+    for(size_type j = 0; j < propertyIndices.size(); ++j) {
+        if(properties[propertyIndices[j]].visibility()) {
+            GLuint* target = indices.data() + begin + offsets[propertyIndices[j]]++ * verticesPerPrimitive;
+            indicesOf(j, target);
+        }
+    }
+}
 
-    if(showHorizon) {
-        glColor3ub(colorHorizon[0], colorHorizon[1], colorHorizon[2]);
-        glBegin(GL_LINES);
-            for(float r = -1.0f; r < 1.1f; r += 0.1f) {
-                glVertex3f(r, -1.0f, 0.0f);
-                glVertex3f(r, 1.0f, 0.0f);
+// upload the graphics into the vertex and index buffer. returns false if the
+// graphics cannot be addressed by 32-bit indices, or if the index buffer has
+// more entries than offsets and counts of glDrawElements can address.
+bool upload() {
+    const std::size_t numberOfIndices = graphics.numberOfPoints()
+        + 2 * graphics.numberOfLines() + 3 * graphics.numberOfTriangles();
+    if(graphics.numberOfPoints() > std::numeric_limits<GLuint>::max()
+    || numberOfIndices > static_cast<std::size_t>(std::numeric_limits<GLsizei>::max())) {
+        return false;
+    }
 
-                glVertex3f(-1.0f, r, 0.0f);
-                glVertex3f(1.0f, r, 0.0f);
-            }
-        glEnd();
+    // vertices
+    {
+        std::vector<GLfloat> vertices(3 * graphics.numberOfPoints());
+        for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+            const Point& point = graphics.point(j);
+            vertices[3 * j] = point[0];
+            vertices[3 * j + 1] = point[1];
+            vertices[3 * j + 2] = point[2];
+        }
+        if(retained.vertexBuffer == 0) {
+            glGenBuffers(1, &retained.vertexBuffer);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, retained.vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-    if(showAxes) {
-        const float lengthAxis = 1.0f;
-        glBegin(GL_LINES);
-            glColor3ub(255, 0, 0);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(lengthAxis, 0.0f, 0.0f);
+    // indices
+    {
+        std::vector<GLuint> indices;
+        std::vector<size_type> propertyIndices;
+        retained.pointRanges.clear();
+        retained.lineRanges.clear();
+        retained.triangleRanges.clear();
+
+        propertyIndices.resize(graphics.numberOfPoints());
+        for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
+            propertyIndices[j] = graphics.point(j).propertyIndex();
+        }
+        appendGroupedByProperty(graphics.pointProperties(), propertyIndices, 1,
+            [](const size_type j, GLuint* target) {
+                target[0] = static_cast<GLuint>(j);
+            },
+            indices, retained.pointRanges
+        );
+
+        propertyIndices.resize(graphics.numberOfLines());
+        for(size_type j = 0; j < graphics.numberOfLines(); ++j) {
+            propertyIndices[j] = graphics.line(j).propertyIndex();
+        }
+        appendGroupedByProperty(graphics.lineProperties(), propertyIndices, 2,
+            [](const size_type j, GLuint* target) {
+                const Line& line = graphics.line(j);
+                target[0] = static_cast<GLuint>(line.pointIndex(0));
+                target[1] = static_cast<GLuint>(line.pointIndex(1));
+            },
+            indices, retained.lineRanges
+        );
+
+        propertyIndices.resize(graphics.numberOfTriangles());
+        for(size_type j = 0; j < graphics.numberOfTriangles(); ++j) {
+            propertyIndices[j] = graphics.triangle(j).propertyIndex();
+        }
+        appendGroupedByProperty(graphics.triangleProperties(), propertyIndices, 3,
+            [](const size_type j, GLuint* target) {
+                const Triangle& triangle = graphics.triangle(j);
+                target[0] = static_cast<GLuint>(triangle.pointIndex(0));
+                target[1] = static_cast<GLuint>(triangle.pointIndex(1));
+                target[2] = static_cast<GLuint>(triangle.pointIndex(2));
+            },
+            indices, retained.triangleRanges
+        );
+
+        if(retained.indexBuffer == 0) {
+            glGenBuffers(1, &retained.indexBuffer);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, retained.indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
 
-            glColor3ub(0, 255, 0);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(0.0f, lengthAxis, 0.0f);
+    retained.upToDate = true;
+    return true;
+}
 
-            glColor3ub(0, 0, 255);
-            glVertex3f(0.0f, 0.0f, 0.0f);
-            glVertex3f(0.0f, 0.0f, lengthAxis);
-        glEnd();
+void drawRanges(const GLenum mode, const std::vector<DrawRange>& ranges) {
+    for(std::size_t j = 0; j < ranges.size(); ++j) {
+        const DrawRange& range = ranges[j];
+        glColor4ub(range.color[0], range.color[1], range.color[2], range.color[3]);
+        glDrawElements(mode, range.size, GL_UNSIGNED_INT,
+            reinterpret_cast<const GLvoid*>(range.offset * sizeof(GLuint)));
+    }
+}
+
+void displayRetained() {
+    glBindBuffer(GL_ARRAY_BUFFER, retained.vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, retained.indexBuffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, 0);
+
+    if(showPoints) {
+        glPointSize(pointSize);
+        drawRanges(GL_POINTS, retained.pointRanges);
+    }
+    if(showLines) {
+        glLineWidth(lineWidth);
+        drawRanges(GL_LINES, retained.lineRanges);
     }
+    if(showTriangles) {
+        drawRanges(GL_TRIANGLES, retained.triangleRanges);
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
+void displayImmediate() {
     if(showPoints) {
         glPointSize(pointSize);
         glBegin(GL_POINTS);
@@ -119,54 +351,278 @@ void display() {
             }
         glEnd();
     }
-
-    glutSwapBuffers();
 }
 
-struct Projection
-{
+// orthogonal projection onto window coordinates (in pixels, origin at the
+// top left corner) by the current modelview matrix.
+struct WindowProjection {
     typedef float value_type;
-    typedef size_t size_type;
+    typedef std::size_t size_type;
+
+    WindowProjection(const GLfloat* m, const float width, const float height)
+        : m_(m), width_(width), height_(height)
+        {}
+    void operator()(const value_type a, const value_type b, const value_type c, value_type& x, value_type& y) const
+        {
+            x = (m_[0] * a + m_[4] * b + m_[8] * c + m_[12] + 1.0f) * width_ / 2;
+            y = (1.0f - (m_[1] * a + m_[5] * b + m_[9] * c + m_[13])) * height_ / 2;
+        }
 
-    Projection(GLfloat const* m, float off_x, float off_y, float scale = 1.0)
-        : m_(m), off_x_(off_x), off_y_(off_y), scale_(scale)
-    { }
+private:
+    const GLfloat* m_;
+    float width_;
+    float height_;
+};
 
-    void operator()(value_type a, value_type b, value_type c, value_type& x, value_type& y) const
-    {
-        x = (m_[0]*a + m_[4]*b + m_[8]*c)*scale_ + off_x_;
-        y = -(m_[1]*a + m_[5]*b + m_[9]*c)*scale_ + off_y_;
+// (re)compute the culling if the view has changed since the last culling
+void cull() {
+    GLfloat view[18];
+    glGetFloatv(GL_MODELVIEW_MATRIX, view);
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    view[16] = static_cast<GLfloat>(viewport[2]);
+    view[17] = static_cast<GLfloat>(viewport[3]);
+    if(culling.upToDate && std::equal(view, view + 18, culling.view)) {
+        return;
     }
+    ANDRES_GRAPHICS_TIMER(timer, "viewer::cull");
+    timer.addItems(graphics.numberOfPoints() + graphics.numberOfLines() + graphics.numberOfTriangles());
+    culling.culling = ScreenSpaceCulling(0.0f, 0.0f, view[16], view[17], cullingTolerance);
+    culling.culling(graphics, WindowProjection(view, view[16], view[17]));
+    std::copy(view, view + 18, culling.view);
+    culling.upToDate = true;
+}
 
-private:
-    GLfloat const* m_;
-    float off_x_;
-    float off_y_;
-    float scale_;
-};
+void displayCulled() {
+    const ScreenSpaceCulling& c = culling.culling;
+    if(showPoints) {
+        glPointSize(pointSize);
+        glBegin(GL_POINTS);
+            for(size_type j = 0; j < c.pointIndices().size(); ++j) {
+                const Point& point = graphics.point(c.pointIndices()[j]);
+                const PointProperty& pointProperty = graphics.pointProperty(point.propertyIndex());
+                glColor4ub(pointProperty.color(0), pointProperty.color(1), pointProperty.color(2), pointProperty.alpha());
+                glVertex3f(point[0], point[1], point[2]);
+            }
+        glEnd();
+    }
+
+    if(showLines) {
+        glLineWidth(lineWidth);
+        glBegin(GL_LINES);
+            for(size_type j = 0; j < c.lineIndices().size(); ++j) {
+                const Line& line = graphics.line(c.lineIndices()[j]);
+                const LineProperty& lineProperty = graphics.lineProperty(line.propertyIndex());
+                glColor4ub(lineProperty.color(0), lineProperty.color(1), lineProperty.color(2), lineProperty.alpha());
+                for(size_type k = 0; k < 2; ++k) {
+                    const Point& point = graphics.point(line.pointIndex(k));
+                    glVertex3f(point[0], point[1], point[2]);
+                }
+            }
+        glEnd();
+    }
+
+    if(showTriangles) {
+        glBegin(GL_TRIANGLES);
+            for(size_type j = 0; j < c.triangleIndices().size(); ++j) {
+                const Triangle& triangle = graphics.triangle(c.triangleIndices()[j]);
+                const TriangleProperty& triangleProperty = graphics.triangleProperty(triangle.propertyIndex());
+                glColor4ub(triangleProperty.color(0), triangleProperty.color(1), triangleProperty.color(2), triangleProperty.alpha());
+                for(size_type k = 0; k < 3; ++k) {
+                    const Point& point = graphics.point(triangle.pointIndex(k));
+                    glVertex3f(point[0], point[1], point[2]);
+                }
+            }
+        glEnd();
+    }
+}
+
+void display() {
+    if(retainedMode && !cullingEnabled && !retained.upToDate) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if(upload()) {
+            const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+            std::cout << "upload to buffer objects: " << duration.count() << " ms" << std::endl;
+        }
+        else {
+            std::cerr << "graphics too large for 32-bit index buffers. switching to immediate mode." << std::endl;
+            retainedMode = false;
+        }
+    }
+
+    ANDRES_GRAPHICS_TIMER(timer, "viewer::display");
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glLineWidth(1.0f);
+
+    if(showHorizon) {
+        glColor3ub(colorHorizon[0], colorHorizon[1], colorHorizon[2]);
+        glBegin(GL_LINES);
+            for(float r = -1.0f; r < 1.1f; r += 0.1f) {
+                glVertex3f(r, -1.0f, 0.0f);
+                glVertex3f(r, 1.0f, 0.0f);
+
+                glVertex3f(-1.0f, r, 0.0f);
+                glVertex3f(1.0f, r, 0.0f);
+            }
+        glEnd();
+    }
+
+    if(showAxes) {
+        const float lengthAxis = 1.0f;
+        glBegin(GL_LINES);
+            glColor3ub(255, 0, 0);
+            glVertex3f(0.0f, 0.0f, 0.0f);
+            glVertex3f(lengthAxis, 0.0f, 0.0f);
+
+            glColor3ub(0, 255, 0);
+            glVertex3f(0.0f, 0.0f, 0.0f);
+            glVertex3f(0.0f, lengthAxis, 0.0f);
+
+            glColor3ub(0, 0, 255);
+            glVertex3f(0.0f, 0.0f, 0.0f);
+            glVertex3f(0.0f, 0.0f, lengthAxis);
+        glEnd();
+    }
+
+    if(cullingEnabled) {
+        cull();
+        displayCulled();
+        timer.addItems(culling.culling.pointIndices().size() + culling.culling.lineIndices().size()
+            + culling.culling.triangleIndices().size());
+    }
+    else {
+        if(retainedMode) {
+            displayRetained();
+        }
+        else {
+            displayImmediate();
+        }
+        timer.addItems(graphics.numberOfPoints() + graphics.numberOfLines() + graphics.numberOfTriangles());
+    }
+
+    glFinish();
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    frameTimes.add(duration.count());
+    if(benchmarkFrames != 0) {
+        // rotate by one degree per frame
+        glRotatef(1.0f, 0.0f, 1.0f, 0.0f);
+        if(--benchmarkFrames == 0) {
+            frameTimes.print(std::cout);
+            printInstrumentation();
+            exit(0);
+        }
+        glutPostRedisplay();
+    }
+    else if(frameTimes.frames == frameTimesReportInterval) {
+        frameTimes.print(std::cout);
+        frameTimes.reset();
+    }
+
+    glutSwapBuffers();
+}
 
 void exportViewAsSVG() {
     GLfloat m[16];
     glGetFloatv(GL_MODELVIEW_MATRIX, m);
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const float width = static_cast<float>(viewport[2]);
+    const float height = static_cast<float>(viewport[3]);
 
-    Projection projection(m, 0, 0);   
+    ScreenSpaceCulling c(0.0f, 0.0f, width, height, cullingTolerance);
+    c(graphics, WindowProjection(m, width, height));
 
-    float t[2] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
-    for(size_type j = 0; j < graphics.numberOfPoints(); ++j) {
-        const auto& point = graphics.point(j);
-        auto x = .0f;
-        auto y = .0f;
-        projection(point[0], point[1], point[2], x, y);
+    std::ofstream f("view.svg");
+    const std::size_t bytes = saveSVG(graphics, c, f);
+    f.close();
+    std::cout << "view.svg: " << bytes << " bytes" << std::endl
+        << "  points: " << c.points() << std::endl
+        << "  lines: " << c.lines() << std::endl
+        << "  triangles: " << c.triangles() << std::endl;
+}
 
-        t[0] = std::min(t[0], x);
-        t[1] = std::min(t[1], y);
+// print the primitive under the mouse cursor, picked by a ray through the
+// spatial index along the view direction.
+void pick(const int x, const int y) {
+    GLfloat m[16];
+    glGetFloatv(GL_MODELVIEW_MATRIX, m);
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // normalized device coordinates of the cursor. the projection matrix is
+    // the identity, so these are the coordinates after the modelview.
+    const float n[] = {
+        2.0f * (x - viewport[0]) / viewport[2] - 1.0f - m[12],
+        1.0f - 2.0f * (y - viewport[1]) / viewport[3] - m[13],
+        -1.0f - m[14] // near plane
+    };
+
+    // inverse of the linear part of the modelview matrix
+    const float determinant = m[0] * (m[5] * m[10] - m[9] * m[6])
+        - m[4] * (m[1] * m[10] - m[9] * m[2])
+        + m[8] * (m[1] * m[6] - m[5] * m[2]);
+    if(determinant == 0.0f) {
+        return;
     }
-    auto scale = 400.0;
-    projection = Projection(m, -t[0]*scale, -t[1]*scale, scale);
+    const float inverse[3][3] = {
+        {(m[5] * m[10] - m[9] * m[6]) / determinant, (m[8] * m[6] - m[4] * m[10]) / determinant, (m[4] * m[9] - m[8] * m[5]) / determinant},
+        {(m[9] * m[2] - m[1] * m[10]) / determinant, (m[0] * m[10] - m[8] * m[2]) / determinant, (m[8] * m[1] - m[0] * m[9]) / determinant},
+        {(m[1] * m[6] - m[5] * m[2]) / determinant, (m[4] * m[2] - m[0] * m[6]) / determinant, (m[0] * m[5] - m[4] * m[1]) / determinant}
+    };
+    float origin[3];
+    float direction[3];
+    for(std::size_t k = 0; k < 3; ++k) {
+        origin[k] = inverse[k][0] * n[0] + inverse[k][1] * n[1] + inverse[k][2] * n[2];
+        direction[k] = inverse[k][2]; // depth increases along the z axis
+    }
+    const float scale = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+    const float tolerance = pickTolerance * 2.0f / viewport[2] / scale;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const SpatialIndex::PickType p = spatialIndex.pick(origin, direction, tolerance);
+    const std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+
+    switch(p.kind_) {
+    case andres::graphics::PointPrimitive:
+        {
+            const size_type j = graphics.point(p.index_).propertyIndex();
+            const PointProperty& property = graphics.pointProperty(j);
+            std::cout << "point " << p.index_ << ", property " << j << " (color "
+                << static_cast<int>(property.color(0)) << " " << static_cast<int>(property.color(1)) << " " << static_cast<int>(property.color(2))
+                << ", alpha " << static_cast<int>(property.alpha()) << ")";
+        }
+        break;
+    case andres::graphics::LinePrimitive:
+        {
+            const size_type j = graphics.line(p.index_).propertyIndex();
+            const LineProperty& property = graphics.lineProperty(j);
+            std::cout << "line " << p.index_ << ", property " << j << " (color "
+                << static_cast<int>(property.color(0)) << " " << static_cast<int>(property.color(1)) << " " << static_cast<int>(property.color(2))
+                << ", alpha " << static_cast<int>(property.alpha()) << ")";
+        }
+        break;
+    case andres::graphics::TrianglePrimitive:
+        {
+            const size_type j = graphics.triangle(p.index_).propertyIndex();
+            const TriangleProperty& property = graphics.triangleProperty(j);
+            std::cout << "triangle " << p.index_ << ", property " << j << " (color "
+                << static_cast<int>(property.color(0)) << " " << static_cast<int>(property.color(1)) << " " << static_cast<int>(property.color(2))
+                << ", alpha " << static_cast<int>(property.alpha()) << ")";
+        }
+        break;
+    default:
+        std::cout << "nothing";
+        break;
+    }
+    std::cout << " picked in " << duration.count() << " us" << std::endl;
+}
 
-    std::ofstream f("view.svg");
-    saveSVG(graphics, projection, f);
-    f.close();
+void mouse(int button, int state, int x, int y) {
+    if(button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
+        pick(x, y);
+    }
 }
 
 void keyboard(unsigned char key, int x, int y) {
@@ -252,6 +708,26 @@ void keyboard(unsigned char key, int x, int y) {
         exportViewAsSVG();
         break;
 
+    case 'v': // switch between retained and immediate mode
+        retainedMode = !retainedMode;
+        frameTimes.reset();
+        glutPostRedisplay();
+        break;
+    case 'c': // enable/disable screen-space culling
+        cullingEnabled = !cullingEnabled;
+        culling.upToDate = false;
+        frameTimes.reset();
+        glutPostRedisplay();
+        break;
+    case 'b': // render a full rotation and print frame-time statistics
+        frameTimes.reset();
+        benchmarkFrames = 360;
+        glutPostRedisplay();
+        break;
+    case 'i': // print the costs of instrumented stages
+        printInstrumentation();
+        break;
+
     case 27: // (escape key) quit
         exit(0);
         break;
@@ -263,21 +739,52 @@ void keyboard(unsigned char key, int x, int y) {
 
 int main(int argc, char** argv) {
     // parse command line input
-    if(argc != 2) {
-        std::cerr << "parameters: <graphics.h5>" << std::endl;
+    std::string fileName;
+    for(int j = 1; j < argc; ++j) {
+        const std::string argument = argv[j];
+        if(argument == "--immediate") {
+            retainedMode = false;
+        }
+        else if(argument == "--cull") {
+            cullingEnabled = true;
+        }
+        else if(argument == "--tolerance" && j + 1 < argc) {
+            cullingTolerance = std::stof(argv[++j]);
+        }
+        else if(argument == "--benchmark" && j + 1 < argc) {
+            benchmarkFrames = std::stoul(argv[++j]);
+        }
+        else if(fileName.empty()) {
+            fileName = argument;
+        }
+        else {
+            fileName.clear();
+            break;
+        }
+    }
+    if(fileName.empty()) {
+        std::cerr << "parameters: <graphics.h5|graphics.agb> [--immediate] [--cull] [--tolerance <pixels>] [--benchmark <number of frames>]" << std::endl;
         return 1;
     }
-    const std::string fileName = argv[1];
 
     // load graphics from file
-    {
+    if(andres::graphics::binary::isBinaryFile(fileName)) {
+        andres::graphics::binary::load(fileName, graphics);
+    }
+    else {
         hid_t file = andres::graphics::hdf5::openFile(fileName);
         andres::graphics::hdf5::load(file, graphics);
         andres::graphics::hdf5::closeFile(file);
     }
 
-    graphics.center();
-    graphics.normalize();
+    graphics.center(andres::graphics::ParallelOptions());
+    graphics.normalize(andres::graphics::ParallelOptions());
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        spatialIndex.build();
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        std::cout << "spatial index: " << duration.count() << " ms" << std::endl;
+    }
 
     std::cout << "Keys and functions:" << std::endl
         << "   2    rotate left around x axis" << std::endl
@@ -294,7 +801,12 @@ int main(int argc, char** argv) {
         << "   s    decrease line width" << std::endl
         << "   r    enable/disable drawing of axes" << std::endl
         << "   t    enable/disable drawing of horizon" << std::endl
-        << "   p    export current view as SVG file 'view.svg'"
+        << "   p    export current view as SVG file 'view.svg'" << std::endl
+        << "   v    switch between retained and immediate mode" << std::endl
+        << "   c    enable/disable screen-space culling of primitives" << std::endl
+        << "   b    render a full rotation and print frame times" << std::endl
+        << "   i    print time spent in load, transform, export and display" << std::endl
+        << "mouse   left click prints the primitive under the cursor"
         << std::endl;
 
     glutInit(&argc, argv);
@@ -302,8 +814,18 @@ int main(int argc, char** argv) {
     glutInitWindowSize(1024, 768);
     glutInitWindowPosition(100, 100);
     glutCreateWindow("andres::graphics");
+    const GLenum glewStatus = glewInit();
+    if(glewStatus != GLEW_OK) {
+        std::cerr << "could not initialize GLEW: " << glewGetErrorString(glewStatus) << std::endl;
+        return 1;
+    }
+    if(retainedMode && !GLEW_VERSION_1_5) {
+        std::cerr << "buffer objects (OpenGL 1.5) not supported. using immediate mode." << std::endl;
+        retainedMode = false;
+    }
     init();
     glutKeyboardFunc(keyboard);
+    glutMouseFunc(mouse);
     glutDisplayFunc(display);
     glutMainLoop();
 